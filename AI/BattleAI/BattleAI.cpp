@@ -12,6 +12,7 @@
 #include "StackWithBonuses.h"
 #include "EnemyInfo.h"
 #include "../../lib/spells/CSpellHandler.h"
+#include "../../lib/CPerformanceCounters.h"
 
 #define LOGL(text) print(text)
 #define LOGFL(text, formattingEl) print(boost::str(boost::format(text) % formattingEl))
@@ -45,6 +46,7 @@ void CBattleAI::init(std::shared_ptr<CBattleCallback> CB)
 BattleAction CBattleAI::activeStack( const CStack * stack )
 {
 	LOG_TRACE_PARAMS(logAi, "stack: %s", stack->nodeName())	;
+	CPerformanceTimer timer("battleAI");
 	setCbc(cb); //TODO: make solid sure that AIs always use their callbacks (need to take care of event handlers too)
 	try
 	{
@@ -171,15 +171,147 @@ void foreach_neighbour(CCallback * cbp, const int3 &pos, std::function<void(CCal
 	}
 }
 
-bool CDistanceSorter::operator ()(const CGObjectInstance *lhs, const CGObjectInstance *rhs)
+bool DistanceField::Distance::isCloserThan(const Distance & other) const
+{
+	if(turns != other.turns)
+		return turns < other.turns;
+
+	return moveRemains > other.moveRemains;
+}
+
+void DistanceField::clear()
+{
+	heroes.clear();
+	nearestHeroes.clear();
+	mergedVersions.clear();
+}
+
+void DistanceField::invalidate(const CArmedInstance * army)
+{
+	auto it = heroes.find(dynamic_cast<const CGHeroInstance *>(army));
+	if(it != heroes.end())
+		it->second.tiles.resize(boost::extents[0][0][0]); //refreshed with new version on next use
+}
+
+const DistanceField::Distance & DistanceField::getDistance(const CGHeroInstance * hero, crint3 tile)
+{
+	return getHeroDistances(hero).tiles[tile.x][tile.y][tile.z];
+}
+
+const CGHeroInstance * DistanceField::getNearestHero(crint3 tile)
 {
-	const CGPathNode *ln = ai->myCb->getPathsInfo(hero)->getPathInfo(lhs->visitablePos()),
-	                 *rn = ai->myCb->getPathsInfo(hero)->getPathInfo(rhs->visitablePos());
+	auto ourHeroes = cb->getHeroesInfo();
+	if(ourHeroes.empty())
+		return nullptr;
+
+	if(ourHeroes != nearestHeroes)
+	{
+		int3 mapSize = cb->getMapSize();
+		nearest.resize(boost::extents[mapSize.x][mapSize.y][mapSize.z]);
+		std::fill(nearest.data(), nearest.data() + nearest.num_elements(), NearestHero());
+		mergedVersions.clear();
+		nearestHeroes = ourHeroes;
+	}
 
-	if(ln->turns != rn->turns)
-		return ln->turns < rn->turns;
+	//refresh all heroes first, merging compares distances of each hero with all others
+	for(auto hero : nearestHeroes)
+		getHeroDistances(hero);
 
-	return (ln->moveRemains > rn->moveRemains);
+	for(auto hero : nearestHeroes)
+	{
+		const HeroDistances & distances = heroes[hero];
+		auto merged = mergedVersions.find(hero);
+		if(merged == mergedVersions.end() || merged->second != distances.version)
+		{
+			mergeHero(hero, distances);
+			mergedVersions[hero] = distances.version;
+		}
+	}
+
+	return nearest[tile.x][tile.y][tile.z].hero;
+}
+
+DistanceField::HeroDistances & DistanceField::getHeroDistances(const CGHeroInstance * hero)
+{
+	HeroDistances & ret = heroes[hero];
+	if(ret.tiles.num_elements() && ret.position == hero->visitablePos() && ret.movement == hero->movement && ret.boat == hero->boat)
+		return ret;
+
+	int3 mapSize = cb->getMapSize();
+	ret.tiles.resize(boost::extents[mapSize.x][mapSize.y][mapSize.z]);
+	ret.position = hero->visitablePos();
+	ret.movement = hero->movement;
+	ret.boat = hero->boat;
+	ret.version++;
+
+	auto copyDistances = [&](const CPathsInfo & paths)
+	{
+		foreach_tile_pos([&](const int3 & pos)
+		{
+			const CGPathNode * node = paths.getNode(pos);
+			Distance & distance = ret.tiles[pos.x][pos.y][pos.z];
+			distance.turns = node->turns;
+			distance.moveRemains = node->moveRemains;
+		});
+	};
+
+	static const int SHARED_PATHS_ATTEMPTS = 3;
+	for(int attempt = 0; attempt < SHARED_PATHS_ATTEMPTS; attempt++)
+	{
+		const CPathsInfo * paths = cb->getPathsInfo(hero);
+		boost::unique_lock<boost::mutex> pathLock(paths->pathMx);
+		if(paths->hero == hero)
+		{
+			copyDistances(*paths);
+			return ret;
+		}
+		//other AI in this client asked for paths of its hero in the meantime
+		pathLock.unlock();
+		boost::this_thread::yield();
+	}
+
+	//paths shared by client keep being taken by other AIs, calculate own copy
+	CPathsInfo paths(mapSize);
+	cb->calculatePaths(hero, paths);
+	copyDistances(paths);
+	return ret;
+}
+
+void DistanceField::mergeHero(const CGHeroInstance * hero, const HeroDistances & distances)
+{
+	for(size_t i = 0; i < nearest.num_elements(); i++)
+	{
+		NearestHero & best = nearest.data()[i];
+		const Distance & distance = distances.tiles.data()[i];
+		if(best.hero == hero)
+		{
+			//hero could get further, choose again from all heroes - those not merged yet will update tile on their turn
+			best = NearestHero();
+			for(auto other : nearestHeroes)
+			{
+				auto it = heroes.find(other);
+				if(it == heroes.end() || !it->second.tiles.num_elements())
+					continue;
+
+				const Distance & otherDistance = it->second.tiles.data()[i];
+				if(otherDistance.reachable() && (!best.hero || otherDistance.isCloserThan(best.distance)))
+				{
+					best.hero = other;
+					best.distance = otherDistance;
+				}
+			}
+		}
+		else if(distance.reachable() && (!best.hero || distance.isCloserThan(best.distance)))
+		{
+			best.hero = hero;
+			best.distance = distance;
+		}
+	}
+}
+
+bool CDistanceSorter::operator ()(const CGObjectInstance *lhs, const CGObjectInstance *rhs)
+{
+	return ai->distanceField.getDistance(hero, lhs->visitablePos()).isCloserThan(ai->distanceField.getDistance(hero, rhs->visitablePos()));
 }
 
 bool compareMovement(HeroPtr lhs, HeroPtr rhs)
@@ -209,11 +341,47 @@ ui64 evaluateDanger(crint3 tile)
 
 ui64 evaluateDanger(crint3 tile, const CGHeroInstance *visitor)
 {
+	return ai->dangerMap.evaluateDanger(tile, visitor);
+}
+
+void DangerMap::clear()
+{
+	int3 mapSize = cb->getMapSize();
+	tiles.resize(boost::extents[mapSize.x][mapSize.y][mapSize.z]);
+	for(auto it = tiles.data(); it != tiles.data() + tiles.num_elements(); it++)
+		*it = TileThreats();
+}
+
+void DangerMap::invalidate(crint3 pos)
+{
+	if(!tiles.num_elements())
+		return;
+
+	auto invalidateTile = [this](const int3 & tile)
+	{
+		tiles[tile.x][tile.y][tile.z].valid = false;
+	};
+	if(cb->isInTheMap(pos))
+		invalidateTile(pos);
+	foreach_neighbour(pos, invalidateTile);
+}
+
+DangerMap::TileThreats & DangerMap::getThreats(crint3 tile)
+{
+	if(!tiles.num_elements())
+		clear();
+
+	TileThreats & ret = tiles[tile.x][tile.y][tile.z];
+	if(ret.valid)
+		return ret;
+
+	ret = TileThreats();
+	ret.valid = true;
+
 	const TerrainTile *t = cb->getTile(tile, false);
 	if(!t) //we can know about guard but can't check its tile (the edge of fow)
-		return 190000000; //MUCH
-
-	ui64 objectDanger = 0, guardDanger = 0;
+		return ret;
+	ret.visible = true;
 
 	auto visitableObjects = cb->getVisitableObjs(tile);
 	// in some scenarios hero happens to be "under" the object (eg town). Then we consider ONLY the hero.
@@ -225,41 +393,55 @@ ui64 evaluateDanger(crint3 tile, const CGHeroInstance *visitor)
 
 	if(const CGObjectInstance * dangerousObject = vstd::backOrNull(visitableObjects))
 	{
-		objectDanger = evaluateDanger(dangerousObject); //unguarded objects can also be dangerous or unhandled
+		ui64 objectDanger = ::evaluateDanger(dangerousObject); //unguarded objects can also be dangerous or unhandled
 		if (objectDanger)
 		{
 			//TODO: don't downcast objects AI shouldn't know about!
-			auto armedObj = dynamic_cast<const CArmedInstance*>(dangerousObject);
-			if (armedObj)
-			{
-				float tacticalAdvantage = fh->getTacticalAdvantage(visitor, armedObj);
-				objectDanger *= tacticalAdvantage; //this line tends to go infinite for allied towns (?)
-			}
+			ret.threats.push_back({objectDanger, dynamic_cast<const CArmedInstance*>(dangerousObject)});
 		}
 		if (dangerousObject->ID == Obj::SUBTERRANEAN_GATE)
-		{ //check guard on the other side of the gate
-			auto it = ai->knownSubterraneanGates.find(dangerousObject);
-			if (it != ai->knownSubterraneanGates.end())
-			{
-				auto guards = cb->getGuardingCreatures(it->second->visitablePos());
-				for (auto cre : guards)
-				{
-					vstd::amax (guardDanger, evaluateDanger(cre) *
-						fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(cre)));
-				}
-			}
-		}
+			ret.gate = dangerousObject;
 	}
 
-	auto guards = cb->getGuardingCreatures(tile);
-	for (auto cre : guards)
+	for (auto cre : cb->getGuardingCreatures(tile))
 	{
-		vstd::amax (guardDanger, evaluateDanger(cre) * fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(cre))); //we are interested in strongest monster around
+		ui64 guardDanger = ::evaluateDanger(cre);
+		if(guardDanger)
+			ret.threats.push_back({guardDanger, dynamic_cast<const CArmedInstance*>(cre)});
 	}
+	return ret;
+}
 
+ui64 DangerMap::evaluateDanger(crint3 tile, const CGHeroInstance * visitor)
+{
+	const TileThreats & tileThreats = getThreats(tile);
+	if(!tileThreats.visible)
+		return 190000000; //MUCH
+
+	ui64 danger = 0;
+	for(const Threat & threat : tileThreats.threats)
+	{
+		if(threat.army)
+			vstd::amax(danger, threat.danger * fh->getTacticalAdvantage(visitor, threat.army)); //this line tends to go infinite for allied towns (?)
+		else
+			vstd::amax(danger, threat.danger);
+	}
+
+	if(tileThreats.gate)
+	{ //check guard on the other side of the gate, known gates may change at any time so it's not cached
+		auto it = ai->knownSubterraneanGates.find(tileThreats.gate);
+		if (it != ai->knownSubterraneanGates.end())
+		{
+			for (auto cre : cb->getGuardingCreatures(it->second->visitablePos()))
+			{
+				vstd::amax (danger, ::evaluateDanger(cre) *
+					fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(cre)));
+			}
+		}
+	}
 
 	//TODO mozna odwiedzic blockvis nie ruszajac straznika
-	return std::max(objectDanger, guardDanger);
+	return danger;
 }
 
 ui64 evaluateDanger(const CGObjectInstance *obj)
@@ -361,20 +543,14 @@ int3 whereToExplore(HeroPtr h)
 	//look for nearby objs -> visit them if they're close enouh
 	const int DIST_LIMIT = 3;
 	std::vector<const CGObjectInstance *> nearbyVisitableObjs;
-	for (int x = hpos.x - DIST_LIMIT; x <= hpos.x + DIST_LIMIT; ++x) //get only local objects instead of all possible objects on the map
+	for (auto obj : cb->getVisitableObjsAround(hpos, DIST_LIMIT)) //get only local objects instead of all possible objects on the map
 	{
-		for (int y = hpos.y - DIST_LIMIT; y <= hpos.y + DIST_LIMIT; ++y)
-		{
-			for (auto obj : cb->getVisitableObjs (int3(x,y,hpos.z), false))
-			{
-				int3 op = obj->visitablePos();
-				CGPath p;
-				ai->myCb->getPathsInfo(h.get())->getPath(p, op);
-				if (p.nodes.size() && p.endPos() == op && p.nodes.size() <= DIST_LIMIT)
-					if (ai->isGoodForVisit(obj, h, *sm))
-						nearbyVisitableObjs.push_back(obj);
-			}
-		}
+		int3 op = obj->visitablePos();
+		CGPath p;
+		ai->myCb->getPathsInfo(h.get())->getPath(p, op);
+		if (p.nodes.size() && p.endPos() == op && p.nodes.size() <= DIST_LIMIT)
+			if (ai->isGoodForVisit(obj, h, *sm))
+				nearbyVisitableObjs.push_back(obj);
 	}
 	vstd::removeDuplicates (nearbyVisitableObjs); //one object may occupy multiple tiles
 	boost::sort(nearbyVisitableObjs, CDistanceSorter(h.get()));
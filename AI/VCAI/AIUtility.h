@@ -163,6 +163,88 @@ bool compareArtifacts(const CArtifactInstance *a1, const CArtifactInstance *a2);
 ui64 howManyReinforcementsCanGet(HeroPtr h, const CGTownInstance *t);
 int3 whereToExplore(HeroPtr h);
 
+/// Per-tile cache of threats that hero faces when visiting tile (armed object on tile, guarding monsters).
+/// Filled lazily during AI turn, cleared at turn start and invalidated around objects that changed.
+class DangerMap
+{
+	struct Threat
+	{
+		ui64 danger;
+		const CArmedInstance * army; //nullptr if danger doesn't depend on visitor army
+	};
+
+	struct TileThreats
+	{
+		bool valid;
+		bool visible;
+		const CGObjectInstance * gate; //subterranean gate on tile, guards on the other side are checked too
+		std::vector<Threat> threats;
+
+		TileThreats(): valid(false), visible(false), gate(nullptr) {}
+	};
+
+	boost::multi_array<TileThreats, 3> tiles;
+
+	TileThreats & getThreats(crint3 tile);
+
+public:
+	void clear();
+	void invalidate(crint3 pos); //invalidates tile and its neighbours which may be guarded by object standing on pos
+	ui64 evaluateDanger(crint3 tile, const CGHeroInstance * visitor);
+};
+
+/// Movement distances from our heroes to every tile, copied from pathfinder results once per hero.
+/// Client keeps paths of only one hero at a time, so comparing heroes through getPathsInfo recalculates paths on every switch.
+/// Distances of hero are refreshed after clear() or invalidate() or when hero changes position, movement points or boat.
+class DistanceField
+{
+public:
+	struct Distance
+	{
+		ui32 moveRemains;
+		ui8 turns;
+
+		Distance(): moveRemains(0), turns(255) {}
+		bool reachable() const { return turns < 255; }
+		bool isCloserThan(const Distance & other) const; //fewer turns, then more move points left
+	};
+
+	void clear();
+	/// Refreshes distances of hero whose skills, bonuses, artifacts or army changed, ignores other objects
+	void invalidate(const CArmedInstance * army);
+	const Distance & getDistance(const CGHeroInstance * hero, crint3 tile);
+	/// Our hero which reaches tile soonest, nullptr if tile is not reachable
+	const CGHeroInstance * getNearestHero(crint3 tile);
+
+private:
+	struct HeroDistances
+	{
+		int3 position;
+		ui32 movement;
+		const CGBoat * boat;
+		ui32 version; //incremented on each refresh
+		boost::multi_array<Distance, 3> tiles;
+
+		HeroDistances(): movement(0), boat(nullptr), version(0) {}
+	};
+
+	struct NearestHero
+	{
+		const CGHeroInstance * hero;
+		Distance distance;
+
+		NearestHero(): hero(nullptr) {}
+	};
+
+	std::map<const CGHeroInstance *, HeroDistances> heroes;
+	std::vector<const CGHeroInstance *> nearestHeroes; //heroes merged into nearest, empty if it has to be rebuilt
+	std::map<const CGHeroInstance *, ui32> mergedVersions;
+	boost::multi_array<NearestHero, 3> nearest;
+
+	HeroDistances & getHeroDistances(const CGHeroInstance * hero);
+	void mergeHero(const CGHeroInstance * hero, const HeroDistances & distances);
+};
+
 class CDistanceSorter
 {
 	const CGHeroInstance * hero;
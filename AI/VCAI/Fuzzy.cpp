@@ -52,12 +52,6 @@ void engineBase::addRule(const std::string &txt)
 	rules.addRule(fl::Rule::parse(txt, &engine));
 }
 
-struct armyStructure
-{
-	float walkers, shooters, flyers;
-	ui32 maxSpeed;
-};
-
 armyStructure evaluateArmyStructure (const CArmedInstance * army)
 {
 	ui64 totalStrenght = army->getArmyStrength();
@@ -99,6 +93,7 @@ FuzzyHelper::FuzzyHelper()
 	ta.configure();
 	initVisitTile();
 	vt.configure();
+	initVisitTileTables();
 }
 
 
@@ -223,36 +218,48 @@ ui64 FuzzyHelper::estimateBankDanger (const CBank * bank)
 }
 
 float FuzzyHelper::getTacticalAdvantage (const CArmedInstance *we, const CArmedInstance *enemy)
+{
+	TacticalAdvantageInputs in;
+	in.our = evaluateArmyStructure(we);
+	in.enemy = evaluateArmyStructure(enemy);
+	in.bankPresent = dynamic_cast<const CBank*> (enemy) != nullptr;
+
+	const CGTownInstance * fort = dynamic_cast<const CGTownInstance*> (enemy);
+	in.castleWalls = fort ? fort->fortLevel() : 0;
+
+	//memoized by engine inputs themselves, so changes of armies, towns or heroes can't make it outdated
+	auto key = in.toTuple();
+	auto it = tacticalAdvantageCache.find(key);
+	if(it != tacticalAdvantageCache.end())
+		return it->second;
+
+	float output = calculateTacticalAdvantage(in);
+	tacticalAdvantageCache[key] = output;
+	return output;
+}
+
+void FuzzyHelper::resetCaches()
+{
+	tacticalAdvantageCache.clear();
+}
+
+float FuzzyHelper::calculateTacticalAdvantage (const TacticalAdvantageInputs & in)
 {
 	float output = 1;
 	try
 	{
-		armyStructure ourStructure = evaluateArmyStructure(we);
-		armyStructure enemyStructure = evaluateArmyStructure(enemy);
-
-		ta.ourWalkers->setValue(ourStructure.walkers);
-		ta.ourShooters->setValue(ourStructure.shooters);
-		ta.ourFlyers->setValue(ourStructure.flyers);
-		ta.ourSpeed->setValue(ourStructure.maxSpeed);
-
-		ta.enemyWalkers->setValue(enemyStructure.walkers);
-		ta.enemyShooters->setValue(enemyStructure.shooters);
-		ta.enemyFlyers->setValue(enemyStructure.flyers);
-		ta.enemySpeed->setValue(enemyStructure.maxSpeed);
-
-		bool bank = dynamic_cast<const CBank*> (enemy);
-		if (bank)
-			ta.bankPresent->setValue(1);
-		else
-			ta.bankPresent->setValue(0);
+		ta.ourWalkers->setValue(in.our.walkers);
+		ta.ourShooters->setValue(in.our.shooters);
+		ta.ourFlyers->setValue(in.our.flyers);
+		ta.ourSpeed->setValue(in.our.maxSpeed);
 
-		const CGTownInstance * fort = dynamic_cast<const CGTownInstance*> (enemy);
-		if (fort)
-		{
-			ta.castleWalls->setValue(fort->fortLevel());
-		}
-		else
-			ta.castleWalls->setValue(0);
+		ta.enemyWalkers->setValue(in.enemy.walkers);
+		ta.enemyShooters->setValue(in.enemy.shooters);
+		ta.enemyFlyers->setValue(in.enemy.flyers);
+		ta.enemySpeed->setValue(in.enemy.maxSpeed);
+
+		ta.bankPresent->setValue(in.bankPresent ? 1 : 0);
+		ta.castleWalls->setValue(in.castleWalls);
 
 		//engine.process(TACTICAL_ADVANTAGE);//TODO: Process only Tactical_Advantage
 		ta.engine.process();
@@ -310,11 +317,25 @@ Goals::TSubgoal FuzzyHelper::chooseSolution (Goals::TGoalVec vec)
 	};
 	boost::sort (vec, sortByHeroes);
 
+	//VisitTile goals are scored together, with a single lookup pass
+	Goals::TGoalVec visits;
+	std::vector<VisitTileInputs> visitInputs;
 	for (auto g : vec)
 	{
-		setPriority(g);
+		if (g->goalType == Goals::VISIT_TILE && g->hero)
+		{
+			visits.push_back(g);
+			visitInputs.push_back(getVisitTileInputs(*g));
+		}
+		else
+			setPriority(g);
 	}
 
+	std::vector<float> visitPriorities;
+	evaluateVisitTiles(visitInputs, visitPriorities);
+	for (size_t i = 0; i < visits.size(); i++)
+		visits[i]->setpriority(visitPriorities[i]);
+
 	auto compareGoals = [](const Goals::TSubgoal & lhs, const Goals::TSubgoal & rhs) -> bool
 	{
 		return lhs->priority < rhs->priority;
@@ -421,11 +442,45 @@ void FuzzyHelper::initVisitTile()
 	}
 }
 
-float FuzzyHelper::evaluate (Goals::VisitTile & g)
+void FuzzyHelper::initVisitTileTables()
 {
-	//we assume that hero is already set and we want to choose most suitable one for the mission
-	if (!g.hero)
-		return 0;
+	//grid points are placed on breakpoints of membership functions
+	std::vector<std::vector<float>> ticks =
+	{
+		{0, 0.75, 1.5, 2.25, 3, 3.75, 4.5}, //strengthRatio
+		{0, 0.2, 0.35, 0.5, 0.65, 0.8, 1}, //heroStrength
+		{0, 0.1, 0.3, 0.5, 0.8, 1.5, 2.25, 3}, //turnDistance
+		{0, 1, 2, 2.5, 3, 4, 5} //missionImportance
+	};
+
+	try
+	{
+		for (int reward = REWARD_UNKNOWN; reward <= REWARD_HIGH; reward++)
+		{
+			visitTileTables[reward] = make_unique<FuzzyTable>(ticks, [&](const std::vector<float> & point) -> float
+			{
+				vt.strengthRatio->setValue(point[0]);
+				vt.heroStrength->setValue(point[1]);
+				vt.turnDistance->setValue(point[2]);
+				vt.missionImportance->setValue(point[3]);
+				vt.estimatedReward->setEnabled(reward != REWARD_UNKNOWN);
+				vt.estimatedReward->setValue(reward == REWARD_HIGH ? 5 : 0);
+
+				vt.engine.process();
+				float value = vt.value->getValue();
+				return value == value ? value : 0; //no rule fired
+			});
+		}
+	}
+	catch (fl::Exception & fe)
+	{
+		logAi->error("visitTile tables: %s", fe.getWhat());
+	}
+}
+
+FuzzyHelper::VisitTileInputs FuzzyHelper::getVisitTileInputs (const Goals::AbstractGoal & g)
+{
+	VisitTileInputs ret;
 
 	//assert(cb->isInTheMap(g.tile));
 	float turns = 0;
@@ -439,44 +494,75 @@ float FuzzyHelper::evaluate (Goals::VisitTile & g)
 		else
 			turns = 1 + (fl::scalar)(distance - g.hero->movement) / g.hero->maxMovePoints(true); //bool on land?
 	}
+	ret.turnDistance = turns;
 
-	float missionImportance = 0;
+	ret.missionImportance = 0;
 	if (vstd::contains(ai->lockedHeroes, g.hero))
-		missionImportance = ai->lockedHeroes[g.hero]->priority;
+		ret.missionImportance = ai->lockedHeroes[g.hero]->priority;
 
-	float strengthRatio = 10.0f; //we are much stronger than enemy
+	ret.strengthRatio = 10.0f; //we are much stronger than enemy
 	ui64 danger = evaluateDanger (g.tile, g.hero.h);
 	if (danger)
-		strengthRatio = (fl::scalar)g.hero.h->getTotalStrength() / danger;
+		ret.strengthRatio = (fl::scalar)g.hero.h->getTotalStrength() / danger;
 
-	float tilePriority = 0;
-	if(g.objid == -1)
-		vt.estimatedReward->setEnabled(false);
-	else if(g.objid == Obj::TOWN) //TODO: move to getObj eventually and add appropiate logic there
-	{
-		vt.estimatedReward->setEnabled(true);
-		tilePriority = 5;
-	}
-		
-	try
-	{
-		vt.strengthRatio->setValue(strengthRatio);
-		vt.heroStrength->setValue((fl::scalar)g.hero->getTotalStrength() / ai->primaryHero()->getTotalStrength());
-		vt.turnDistance->setValue(turns);
-		vt.missionImportance->setValue(missionImportance);
-		vt.estimatedReward->setValue(tilePriority);
-
-		vt.engine.process();
-		//engine.process(VISIT_TILE); //TODO: Process only Visit_Tile
-		g.priority = vt.value->getValue();
-	}
-	catch (fl::Exception & fe)
+	ret.heroStrength = (fl::scalar)g.hero->getTotalStrength() / ai->primaryHero()->getTotalStrength();
+
+	if (g.objid == -1)
+		ret.reward = REWARD_UNKNOWN;
+	else if (g.objid == Obj::TOWN) //TODO: move to getObj eventually and add appropiate logic there
+		ret.reward = REWARD_HIGH;
+	else
+		ret.reward = REWARD_LOW;
+
+	return ret;
+}
+
+void FuzzyHelper::evaluateVisitTiles (const std::vector<VisitTileInputs> & inputs, std::vector<float> & priorities) const
+{
+	priorities.assign(inputs.size(), 0);
+
+	//one batch per table, points are packed in order expected by FuzzyTable
+	for (int reward = REWARD_UNKNOWN; reward <= REWARD_HIGH; reward++)
 	{
-		logAi->error("evaluate VisitTile: %s",fe.getWhat());
+		const auto & table = visitTileTables[reward];
+		if (!table)
+			continue;
+
+		std::vector<size_t> indexes;
+		std::vector<float> points;
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			const VisitTileInputs & in = inputs[i];
+			if (in.reward != reward)
+				continue;
+
+			indexes.push_back(i);
+			points.insert(points.end(), {in.strengthRatio, in.heroStrength, in.turnDistance, in.missionImportance});
+		}
+		if (indexes.empty())
+			continue;
+
+		std::vector<float> outputs(indexes.size());
+		table->evaluate(points.data(), indexes.size(), outputs.data());
+		for (size_t i = 0; i < indexes.size(); i++)
+			priorities[indexes[i]] = outputs[i];
 	}
+}
+
+float FuzzyHelper::evaluate (Goals::VisitTile & g)
+{
+	//we assume that hero is already set and we want to choose most suitable one for the mission
+	if (!g.hero)
+		return 0;
+
+	std::vector<float> priorities;
+	evaluateVisitTiles({getVisitTileInputs(g)}, priorities);
+	g.priority = priorities.front();
+
 	assert (g.priority >= 0);
 	return g.priority;
 }
+
 float FuzzyHelper::evaluate (Goals::VisitHero & g)
 {
 	auto obj = cb->getObj(ObjectInstanceID(g.objid)); //we assume for now that these goals are similar
@@ -10,12 +10,19 @@
 #pragma once
 #include "fl/Headers.h"
 #include "Goals.h"
+#include "FuzzyTable.h"
 
 class VCAI;
 class CArmedInstance;
 class CBank;
 struct SectorMap;
 
+struct armyStructure
+{
+	float walkers, shooters, flyers;
+	ui32 maxSpeed;
+};
+
 class engineBase
 {
 public:
@@ -55,19 +62,51 @@ class FuzzyHelper
 		~EvalVisitTile();
 	} vt;
 
-	
+	std::array<std::unique_ptr<FuzzyTable>, 3> visitTileTables; //approximation of vt for each EVisitReward
+
+	/// Everything ta engine reads
+	struct TacticalAdvantageInputs
+	{
+		armyStructure our, enemy;
+		bool bankPresent;
+		int castleWalls;
+
+		std::tuple<float, float, float, ui32, float, float, float, ui32, bool, int> toTuple() const
+		{
+			return std::make_tuple(our.walkers, our.shooters, our.flyers, our.maxSpeed,
+				enemy.walkers, enemy.shooters, enemy.flyers, enemy.maxSpeed, bankPresent, castleWalls);
+		}
+	};
+	/// Memoized tactical advantage by its inputs
+	std::map<std::tuple<float, float, float, ui32, float, float, float, ui32, bool, int>, float> tacticalAdvantageCache;
+
+	float calculateTacticalAdvantage (const TacticalAdvantageInputs & in);
 
 public:
+	enum EVisitReward {REWARD_UNKNOWN, REWARD_LOW, REWARD_HIGH};
+
+	struct VisitTileInputs
+	{
+		float strengthRatio;
+		float heroStrength;
+		float turnDistance;
+		float missionImportance;
+		EVisitReward reward;
+	};
+
 	enum RuleBlocks {BANK_DANGER, TACTICAL_ADVANTAGE, VISIT_TILE};
 	//blocks should be initialized in this order, which may be confusing :/
 
 	FuzzyHelper();
 	void initTacticalAdvantage();
 	void initVisitTile();
+	void initVisitTileTables();
 
 	float evaluate (Goals::Explore & g);
 	float evaluate (Goals::RecruitHero & g);
 	float evaluate (Goals::VisitTile & g);
+	VisitTileInputs getVisitTileInputs (const Goals::AbstractGoal & g); //g must have hero and tile set
+	void evaluateVisitTiles (const std::vector<VisitTileInputs> & inputs, std::vector<float> & priorities) const; //thread-safe, no game state access
 	float evaluate (Goals::VisitHero & g);
 	float evaluate (Goals::BuildThis & g);
 	float evaluate (Goals::DigAtTile & g);
@@ -81,6 +120,7 @@ public:
 
 	ui64 estimateBankDanger (const CBank * bank);
 	float getTacticalAdvantage (const CArmedInstance *we, const CArmedInstance *enemy); //returns factor how many times enemy is stronger than us
+	void resetCaches(); //keeps memoized results from piling up, called at the beginning of each turn
 
 	Goals::TSubgoal chooseSolution (Goals::TGoalVec vec);
 	//std::shared_ptr<AbstractGoal> chooseSolution (std::vector<std::shared_ptr<AbstractGoal>> & vec);
@@ -0,0 +1,80 @@
+/*
+ * FuzzyTable.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+*/
+#include "StdInc.h"
+#include "FuzzyTable.h"
+
+FuzzyTable::FuzzyTable(std::vector<std::vector<float>> Ticks, const std::function<float(const std::vector<float> &)> & sample):
+	ticks(std::move(Ticks))
+{
+	assert(ticks.size() <= MAX_INPUTS);
+
+	size_t size = 1;
+	strides.resize(ticks.size());
+	for (size_t axis = ticks.size(); axis-- > 0;)
+	{
+		assert(ticks[axis].size() >= 2);
+		strides[axis] = size;
+		size *= ticks[axis].size();
+	}
+
+	values.resize(size);
+	std::vector<float> point(ticks.size());
+	for (size_t index = 0; index < size; index++)
+	{
+		for (size_t axis = 0; axis < ticks.size(); axis++)
+			point[axis] = ticks[axis][(index / strides[axis]) % ticks[axis].size()];
+		values[index] = sample(point);
+	}
+}
+
+float FuzzyTable::evaluate(const float * input) const
+{
+	const size_t inputs = ticks.size();
+	size_t base = 0;
+	float weights[MAX_INPUTS];
+
+	for (size_t axis = 0; axis < inputs; axis++)
+	{
+		const auto & axisTicks = ticks[axis];
+		float value = input[axis];
+		vstd::abetween(value, axisTicks.front(), axisTicks.back());
+
+		size_t cell = std::upper_bound(axisTicks.begin(), axisTicks.end() - 1, value) - axisTicks.begin() - 1;
+		weights[axis] = (value - axisTicks[cell]) / (axisTicks[cell + 1] - axisTicks[cell]);
+		base += cell * strides[axis];
+	}
+
+	//blend values in all corners of the cell
+	float ret = 0;
+	for (size_t corner = 0; corner < (size_t(1) << inputs); corner++)
+	{
+		float weight = 1;
+		size_t offset = base;
+		for (size_t axis = 0; axis < inputs; axis++)
+		{
+			if (corner & (size_t(1) << axis))
+			{
+				weight *= weights[axis];
+				offset += strides[axis];
+			}
+			else
+				weight *= 1 - weights[axis];
+		}
+		if (weight > 0)
+			ret += weight * values[offset];
+	}
+	return ret;
+}
+
+void FuzzyTable::evaluate(const float * inputs, size_t count, float * outputs) const
+{
+	for (size_t i = 0; i < count; i++)
+		outputs[i] = evaluate(inputs + i * ticks.size());
+}
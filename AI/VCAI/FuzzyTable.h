@@ -0,0 +1,32 @@
+/*
+ * FuzzyTable.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+*/
+#pragma once
+
+/// Lookup table approximation of fuzzy rule base with continuous inputs.
+/// Rule base is sampled once on a grid, evaluation uses multilinear interpolation between grid points.
+/// Table is immutable after construction so it can be shared between threads.
+class FuzzyTable
+{
+public:
+	static const size_t MAX_INPUTS = 8;
+
+	/// @param Ticks grid points on every input axis, ascending, at least two per axis. Inputs outside are clamped.
+	/// @param sample evaluates rule base in given point
+	FuzzyTable(std::vector<std::vector<float>> Ticks, const std::function<float(const std::vector<float> &)> & sample);
+
+	float evaluate(const float * input) const;
+	/// evaluates count points, inputs are stored point after point
+	void evaluate(const float * inputs, size_t count, float * outputs) const;
+
+private:
+	std::vector<std::vector<float>> ticks;
+	std::vector<size_t> strides;
+	std::vector<float> values;
+};
@@ -27,6 +27,32 @@ TSubgoal Goals::sptr(const AbstractGoal & tmp)
 	return ptr;
 }
 
+DecompositionResult::DecompositionResult(TSubgoal Subgoal):
+	status(SUBGOAL),
+	subgoal(Subgoal)
+{
+}
+
+DecompositionResult DecompositionResult::fulfilled(TSubgoal Goal)
+{
+	DecompositionResult ret(Goal);
+	ret.status = FULFILLED;
+	return ret;
+}
+
+DecompositionResult DecompositionResult::impossible(const std::string & Reason)
+{
+	DecompositionResult ret(sptr(Goals::Invalid()));
+	ret.status = IMPOSSIBLE;
+	ret.reason = Reason;
+	return ret;
+}
+
+TGoalKey Goals::AbstractGoal::getKey() const
+{
+	return std::make_tuple(goalType, isElementar, isAbstract, value, resID, objid, aid, tile, hero.h, town, bid);
+}
+
 std::string Goals::AbstractGoal::name() const //TODO: virtualize
 {
 	std::string desc;
@@ -185,7 +211,7 @@ namespace Goals
 //	return sptr (Goals::Explore());
 //}
 
-TSubgoal Win::whatToDoToAchieve()
+DecompositionResult Win::whatToDoToAchieve()
 {
 	auto toBool = [=](const EventCondition &)
 	{
@@ -339,7 +365,7 @@ TSubgoal Win::whatToDoToAchieve()
 	return sptr (Goals::Invalid());
 }
 
-TSubgoal FindObj::whatToDoToAchieve()
+DecompositionResult FindObj::whatToDoToAchieve()
 {
 	const CGObjectInstance * o = nullptr;
 	if (resID > -1) //specified
@@ -375,13 +401,13 @@ std::string GetObj::completeMessage() const
 	return "hero " + hero.get()->name + " captured Object ID = " + boost::lexical_cast<std::string>(objid);
 }
 
-TSubgoal GetObj::whatToDoToAchieve()
+DecompositionResult GetObj::whatToDoToAchieve()
 {
 	const CGObjectInstance * obj = cb->getObj(ObjectInstanceID(objid));
 	if(!obj)
 		return sptr (Goals::Explore());
 	if (obj->tempOwner == ai->playerID) //we can't capture our own object -> move to Win codition
-		throw cannotFulfillGoalException("Cannot capture my own object " + obj->getObjectName());
+		return DecompositionResult::impossible("Cannot capture my own object " + obj->getObjectName());
 
 	int3 pos = obj->visitablePos();
 	if (hero)
@@ -391,10 +417,14 @@ TSubgoal GetObj::whatToDoToAchieve()
 	}
 	else
 	{
-		for (auto h : cb->getHeroesInfo())
+		auto nearest = ai->distanceField.getNearestHero(pos);
+		if (nearest && ai->isAccessibleForHero(pos, nearest))
+			return sptr(Goals::VisitTile(pos).sethero(nearest)); //we must visit object with same hero, if any
+
+		for (auto h : cb->getHeroesInfo()) //nearest hero may be too weak to get there safely
 		{
-			if (ai->isAccessibleForHero(pos, h))
-				return sptr(Goals::VisitTile(pos).sethero(h)); //we must visit object with same hero, if any
+			if (h != nearest && ai->isAccessibleForHero(pos, h))
+				return sptr(Goals::VisitTile(pos).sethero(h));
 		}
 	}
 	return sptr (Goals::ClearWayTo(pos).sethero(hero));
@@ -417,7 +447,7 @@ std::string VisitHero::completeMessage() const
 	return "hero " + hero.get()->name + " visited hero " + boost::lexical_cast<std::string>(objid);
 }
 
-TSubgoal VisitHero::whatToDoToAchieve()
+DecompositionResult VisitHero::whatToDoToAchieve()
 {
 	const CGObjectInstance * obj = cb->getObj(ObjectInstanceID(objid));
 	if(!obj)
@@ -453,7 +483,7 @@ bool VisitHero::fulfillsMe (TSubgoal goal)
 	return obj->visitablePos() == goal->tile;
 }
 
-TSubgoal GetArtOfType::whatToDoToAchieve()
+DecompositionResult GetArtOfType::whatToDoToAchieve()
 {
 	TSubgoal alternativeWay = CGoal::lookForArtSmart(aid); //TODO: use
 	if(alternativeWay->invalid())
@@ -461,7 +491,7 @@ TSubgoal GetArtOfType::whatToDoToAchieve()
 	return sptr (Goals::Invalid());
 }
 
-TSubgoal ClearWayTo::whatToDoToAchieve()
+DecompositionResult ClearWayTo::whatToDoToAchieve()
 {
 	assert(cb->isInTheMap(tile)); //set tile
 	if(!cb->isVisible(tile))
@@ -470,7 +500,11 @@ TSubgoal ClearWayTo::whatToDoToAchieve()
 		return sptr (Goals::Explore());
 	}
 
-	return (fh->chooseSolution(getAllPossibleSubgoals()));
+	auto subgoals = getAllPossibleSubgoals();
+	if (subgoals.empty())
+		return DecompositionResult::fulfilled(sptr(Goals::ClearWayTo(tile))); //make sure asigned hero gets unlocked
+
+	return (fh->chooseSolution(subgoals));
 }
 
 TGoalVec ClearWayTo::getAllPossibleSubgoals()
@@ -510,10 +544,7 @@ TGoalVec ClearWayTo::getAllPossibleSubgoals()
 		if (topObj)
 		{
 			if (vstd::contains(ai->reservedObjs, topObj) && !vstd::contains(ai->reservedHeroesMap[h], topObj))
-			{
-				throw goalFulfilledException (sptr(Goals::ClearWayTo(tile, h)));
-				continue; //do not capure object reserved by other hero
-			}
+				return TGoalVec(); //do not capure object reserved by other hero, give up
 
 			if (topObj->ID == Obj::HERO && cb->getPlayerRelations(h->tempOwner, topObj->tempOwner) != PlayerRelations::ENEMIES)
 				if (topObj != hero.get(true)) //the hero we want to free
@@ -548,10 +579,7 @@ TGoalVec ClearWayTo::getAllPossibleSubgoals()
 		ret.push_back (sptr (Goals::RecruitHero()));
 
 	if (ret.empty())
-	{
 		logAi->warn("There is no known way to clear the way to tile %s", tile.toString());
-		throw goalFulfilledException (sptr(Goals::ClearWayTo(tile))); //make sure asigned hero gets unlocked
-	}
 
 	return ret;
 }
@@ -561,9 +589,13 @@ std::string Explore::completeMessage() const
 	return "Hero " + hero.get()->name + " completed exploration";
 }
 
-TSubgoal Explore::whatToDoToAchieve()
+DecompositionResult Explore::whatToDoToAchieve()
 {
-	auto ret = fh->chooseSolution(getAllPossibleSubgoals());
+	auto subgoals = getAllPossibleSubgoals();
+	if (subgoals.empty())
+		return DecompositionResult::fulfilled(sptr(Goals::Explore().sethero(hero)));
+
+	auto ret = fh->chooseSolution(subgoals);
 	if (hero) //use best step for this hero
 		return ret;
 	else
@@ -676,13 +708,7 @@ TGoalVec Explore::getAllPossibleSubgoals()
 	if ((!hero || ret.empty()) && ai->canRecruitAnyHero())
 		ret.push_back (sptr(Goals::RecruitHero()));
 
-	if (ret.empty())
-	{
-		throw goalFulfilledException (sptr(Goals::Explore().sethero(hero)));
-	}
-	//throw cannotFulfillGoalException("Cannot explore - no possible ways found!");
-
-	return ret;
+	return ret; //empty if there are no possible ways to explore
 }
 
 bool Explore::fulfillsMe (TSubgoal goal)
@@ -698,7 +724,7 @@ bool Explore::fulfillsMe (TSubgoal goal)
 }
 
 
-TSubgoal RecruitHero::whatToDoToAchieve()
+DecompositionResult RecruitHero::whatToDoToAchieve()
 {
 	const CGTownInstance *t = ai->findTownWithTavern();
 	if(!t)
@@ -715,9 +741,13 @@ std::string VisitTile::completeMessage() const
 	return "Hero " + hero.get()->name + " visited tile " + tile.toString();
 }
 
-TSubgoal VisitTile::whatToDoToAchieve()
+DecompositionResult VisitTile::whatToDoToAchieve()
 {
-	auto ret = fh->chooseSolution(getAllPossibleSubgoals());
+	auto subgoals = getAllPossibleSubgoals();
+	if (subgoals.empty())
+		return DecompositionResult::impossible("Tile is already occupied by another hero "); //FIXME: we should give up this tile earlier
+
+	auto ret = fh->chooseSolution(subgoals);
 
 	if(ret->hero)
 	{
@@ -767,8 +797,6 @@ TGoalVec VisitTile::getAllPossibleSubgoals()
 		{
 			if (hero.get(true) && hero->id == obj->id) //if it's assigned hero, visit tile. If it's different hero, we can't visit tile now
 				ret.push_back(sptr(Goals::VisitTile(tile).sethero(dynamic_cast<const CGHeroInstance *>(obj)).setisElementar(true)));
-			else
-				throw cannotFulfillGoalException("Tile is already occupied by another hero "); //FIXME: we should give up this tile earlier
 		}
 		else
 			ret.push_back (sptr(Goals::ClearWayTo(tile)));
@@ -778,7 +806,7 @@ TGoalVec VisitTile::getAllPossibleSubgoals()
 	return ret;
 }
 
-TSubgoal DigAtTile::whatToDoToAchieve()
+DecompositionResult DigAtTile::whatToDoToAchieve()
 {
 	const CGObjectInstance *firstObj = vstd::frontOrNull(cb->getVisitableObjs(tile));
 	if(firstObj && firstObj->ID == Obj::HERO && firstObj->tempOwner == ai->playerID) //we have hero at dest
@@ -791,7 +819,7 @@ TSubgoal DigAtTile::whatToDoToAchieve()
 	return sptr (Goals::VisitTile(tile));
 }
 
-TSubgoal BuildThis::whatToDoToAchieve()
+DecompositionResult BuildThis::whatToDoToAchieve()
 {
 	//TODO check res
 	//look for town
@@ -799,7 +827,7 @@ TSubgoal BuildThis::whatToDoToAchieve()
 	return iAmElementar();
 }
 
-TSubgoal CollectRes::whatToDoToAchieve()
+DecompositionResult CollectRes::whatToDoToAchieve()
 {
 	std::vector<const IMarket*> markets;
 
@@ -866,7 +894,7 @@ TSubgoal CollectRes::whatToDoToAchieve()
 	return sptr (setisElementar(true)); //all the conditions for trade are met
 }
 
-TSubgoal GatherTroops::whatToDoToAchieve()
+DecompositionResult GatherTroops::whatToDoToAchieve()
 {
 	std::vector<const CGDwelling *> dwellings;
 	for(const CGTownInstance *t : cb->getTownsInfo())
@@ -918,13 +946,7 @@ TSubgoal GatherTroops::whatToDoToAchieve()
 		// sorted helper
 		auto comparator = [](const TDwellMap::value_type & a, const TDwellMap::value_type & b) -> bool
 		{
-			const CGPathNode *ln = ai->myCb->getPathsInfo(a.first)->getPathInfo(a.second->visitablePos()),
-			                 *rn = ai->myCb->getPathsInfo(b.first)->getPathInfo(b.second->visitablePos());
-
-			if(ln->turns != rn->turns)
-				return ln->turns < rn->turns;
-
-			return (ln->moveRemains > rn->moveRemains);
+			return ai->distanceField.getDistance(a.first, a.second->visitablePos()).isCloserThan(ai->distanceField.getDistance(b.first, b.second->visitablePos()));
 		};
 
 		// for all owned heroes generate map <hero -> nearest dwelling>
@@ -938,7 +960,7 @@ TSubgoal GatherTroops::whatToDoToAchieve()
 			// find hero who is nearest to a dwelling
 			const CGDwelling * nearest = boost::range::min_element(nearestDwellings, comparator)->second;
 			if (!nearest)
-				throw cannotFulfillGoalException("Cannot find nearest dwelling!");
+				return DecompositionResult::impossible("Cannot find nearest dwelling!");
 
 			return sptr(Goals::GetObj(nearest->id.getNum()));
 		}
@@ -950,7 +972,7 @@ TSubgoal GatherTroops::whatToDoToAchieve()
 	//TODO: exchange troops between heroes
 }
 
-TSubgoal Conquer::whatToDoToAchieve()
+DecompositionResult Conquer::whatToDoToAchieve()
 {
 	return fh->chooseSolution (getAllPossibleSubgoals());
 }
@@ -1033,12 +1055,12 @@ TGoalVec Conquer::getAllPossibleSubgoals()
 	return ret;
 }
 
-TSubgoal Build::whatToDoToAchieve()
+DecompositionResult Build::whatToDoToAchieve()
 {
 	return iAmElementar();
 }
 
-TSubgoal Invalid::whatToDoToAchieve()
+DecompositionResult Invalid::whatToDoToAchieve()
 {
 	return iAmElementar();
 }
@@ -1048,12 +1070,16 @@ std::string GatherArmy::completeMessage() const
 	return "Hero " + hero.get()->name + " gathered army of value " + boost::lexical_cast<std::string>(value);
 }
 
-TSubgoal GatherArmy::whatToDoToAchieve()
+DecompositionResult GatherArmy::whatToDoToAchieve()
 {
 	//TODO: find hero if none set
 	assert(hero.h);
 
-	return fh->chooseSolution (getAllPossibleSubgoals()); //find dwelling. use current hero to prevent him from doing nothing.
+	auto subgoals = getAllPossibleSubgoals();
+	if (subgoals.empty()) //workaround to break loop - seemingly there are no ways to explore left
+		return DecompositionResult::fulfilled(sptr(Goals::GatherArmy(0).sethero(hero)));
+
+	return fh->chooseSolution (subgoals); //find dwelling. use current hero to prevent him from doing nothing.
 }
 
 static const BuildingID unitsSource[] = { BuildingID::DWELL_LVL_1, BuildingID::DWELL_LVL_2, BuildingID::DWELL_LVL_3,
@@ -1149,13 +1175,8 @@ TGoalVec GatherArmy::getAllPossibleSubgoals()
 		}
 	}
 
-	if (ret.empty())
-	{
-		if (hero == ai->primaryHero() || value >= 1.1f)
-			ret.push_back (sptr(Goals::Explore()));
-		else //workaround to break loop - seemingly there are no ways to explore left
-			throw goalFulfilledException (sptr(Goals::GatherArmy(0).sethero(hero)));
-	}
+	if (ret.empty() && (hero == ai->primaryHero() || value >= 1.1f))
+		ret.push_back (sptr(Goals::Explore()));
 
 	return ret;
 }
@@ -63,6 +63,28 @@ enum {LOW_PR = -1};
 
 TSubgoal sptr(const AbstractGoal & tmp);
 
+/// Outcome of a single decomposition step, explicit result instead of exceptions used for control flow
+struct DecompositionResult
+{
+	enum EStatus
+	{
+		SUBGOAL, //goal is to be achieved by fulfilling subgoal
+		FULFILLED, //goal was completed as much as possible and can be released
+		IMPOSSIBLE //there is no known way to fulfill goal, see reason
+	};
+
+	EStatus status;
+	TSubgoal subgoal; //next goal to follow or, if FULFILLED, the goal that was completed
+	std::string reason;
+
+	DecompositionResult(TSubgoal Subgoal); //implicit - returning plain subgoal is the common case
+	static DecompositionResult fulfilled(TSubgoal Goal);
+	static DecompositionResult impossible(const std::string & Reason);
+};
+
+//all parameters of goal, goals with same key are decomposed in the same way
+typedef std::tuple<EGoals, bool, bool, int, int, int, int, int3, const CGHeroInstance *, const CGTownInstance *, int> TGoalKey;
+
 class AbstractGoal
 {
 public:
@@ -95,11 +117,12 @@ public:
 	//FIXME: abstract goal should be abstract, but serializer fails to instantiate subgoals in such case
 	virtual AbstractGoal * clone() const {return const_cast<AbstractGoal*>(this);};
 	virtual TGoalVec getAllPossibleSubgoals() {TGoalVec vec; return vec;};
-	virtual TSubgoal whatToDoToAchieve() {return sptr(AbstractGoal());};
+	virtual DecompositionResult whatToDoToAchieve() {return sptr(AbstractGoal());};
 
 	EGoals goalType;
 
 	std::string name() const;
+	TGoalKey getKey() const;
 	virtual std::string completeMessage() const {return "This goal is unspecified!";};
 
 	bool invalid() const;
@@ -191,14 +214,14 @@ class Invalid : public CGoal<Invalid>
 	public:
 	Invalid() : CGoal (Goals::INVALID) {priority = -1e10;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class Win : public CGoal<Win>
 {
 	public:
 	Win() : CGoal (Goals::WIN) {priority = 100;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class NotLose : public CGoal<NotLose>
 {
@@ -212,14 +235,14 @@ class Conquer : public CGoal<Conquer>
 	public:
 	Conquer() : CGoal (Goals::CONQUER) {priority = 10;};
 	TGoalVec getAllPossibleSubgoals() override;
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class Build : public CGoal<Build>
 {
 	public:
 	Build() : CGoal (Goals::BUILD) {priority = 1;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class Explore : public CGoal<Explore>
 {
@@ -227,7 +250,7 @@ class Explore : public CGoal<Explore>
 	Explore() : CGoal (Goals::EXPLORE){priority = 1;};
 	Explore(HeroPtr h) : CGoal (Goals::EXPLORE){hero = h; priority = 1;};
 	TGoalVec getAllPossibleSubgoals() override;
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	std::string completeMessage() const override;
 	bool fulfillsMe (TSubgoal goal) override;
 };
@@ -238,7 +261,7 @@ public:
 
 	GatherArmy(int val) : CGoal (Goals::GATHER_ARMY){value = val; priority = 2.5;};
 	TGoalVec getAllPossibleSubgoals() override;
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	std::string completeMessage() const override;
 };
 class BoostHero : public CGoal<BoostHero>
@@ -253,7 +276,7 @@ class RecruitHero : public CGoal<RecruitHero>
 	public:
 	RecruitHero() : CGoal (Goals::RECRUIT_HERO){priority = 1;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class BuildThis : public CGoal<BuildThis>
 {
@@ -263,7 +286,7 @@ public:
 	BuildThis(BuildingID Bid, const CGTownInstance *tid) : CGoal (Goals::BUILD_STRUCTURE) {bid = Bid; town = tid; priority =  5;};
 	BuildThis(BuildingID Bid) : CGoal (Goals::BUILD_STRUCTURE) {bid = Bid; priority = 5;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class CollectRes : public CGoal<CollectRes>
 {
@@ -272,7 +295,7 @@ public:
 
 	CollectRes(int rid, int val) : CGoal (Goals::COLLECT_RES) {resID = rid; value = val; priority = 2;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class GatherTroops : public CGoal<GatherTroops>
 {
@@ -281,7 +304,7 @@ public:
 
 	GatherTroops(int type, int val) : CGoal (Goals::GATHER_TROOPS){objid = type; value = val; priority = 2;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class GetObj : public CGoal<GetObj>
 {
@@ -290,7 +313,7 @@ public:
 
 	GetObj(int Objid) : CGoal(Goals::GET_OBJ) {objid = Objid; priority = 3;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	bool operator== (GetObj &g) {return g.objid ==  objid;}
 	bool fulfillsMe (TSubgoal goal) override;
 	std::string completeMessage() const override;
@@ -303,7 +326,7 @@ public:
 	FindObj(int ID) : CGoal(Goals::FIND_OBJ) {objid = ID; priority = 1;};
 	FindObj(int ID, int subID) : CGoal(Goals::FIND_OBJ) {objid = ID; resID = subID; priority = 1;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class VisitHero : public CGoal<VisitHero>
 {
@@ -312,7 +335,7 @@ public:
 
 	VisitHero(int hid) : CGoal (Goals::VISIT_HERO){objid = hid; priority = 4;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	bool operator== (VisitHero &g) { return g.goalType == goalType && g.objid == objid; }
 	bool fulfillsMe (TSubgoal goal) override;
 	std::string completeMessage() const override;
@@ -324,7 +347,7 @@ public:
 
 	GetArtOfType(int type) : CGoal (Goals::GET_ART_TYPE){aid = type; priority = 2;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 };
 class VisitTile : public CGoal<VisitTile>
 	//tile, in conjunction with hero elementar; assumes tile is reachable
@@ -334,7 +357,7 @@ public:
 
 	VisitTile(int3 Tile) : CGoal (Goals::VISIT_TILE) {tile = Tile; priority = 5;};
 	TGoalVec getAllPossibleSubgoals() override;
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	bool operator== (VisitTile &g) { return g.goalType == goalType && g.tile == tile; }
 	std::string completeMessage() const override;
 }; 
@@ -346,7 +369,7 @@ public:
 	ClearWayTo(int3 Tile) : CGoal (Goals::CLEAR_WAY_TO) {tile = Tile; priority = 5;};
 	ClearWayTo(int3 Tile, HeroPtr h) : CGoal (Goals::CLEAR_WAY_TO) {tile = Tile; hero = h; priority = 5;};
 	TGoalVec getAllPossibleSubgoals() override;
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	bool operator== (ClearWayTo &g) { return g.goalType == goalType && g.tile == tile; }
 };
 class DigAtTile : public CGoal<DigAtTile>
@@ -357,7 +380,7 @@ public:
 
 	DigAtTile(int3 Tile) : CGoal (Goals::DIG_AT_TILE) {tile = Tile; priority = 20;};
 	TGoalVec getAllPossibleSubgoals() override {return TGoalVec();};
-	TSubgoal whatToDoToAchieve() override;
+	DecompositionResult whatToDoToAchieve() override;
 	bool operator== (DigAtTile &g) { return g.goalType == goalType && g.tile == tile; }
 };
 
@@ -12,10 +12,13 @@
 #include "Fuzzy.h"
 
 #include "../../lib/UnlockGuard.h"
+#include "../../lib/ScopeGuard.h"
 #include "../../lib/mapObjects/MapObjects.h"
 #include "../../lib/CConfigHandler.h"
 #include "../../lib/CHeroHandler.h"
 #include "../../lib/CModHandler.h"
+#include "../../lib/CPerformanceCounters.h"
+#include "../../lib/StringConstants.h"
 #include "../../lib/CGameState.h"
 #include "../../lib/NetPacks.h"
 #include "../../lib/serializer/CTypeList.h"
@@ -99,6 +102,7 @@ void VCAI::availableCreaturesChanged(const CGDwelling *town)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	decompositionCache.clear();
 }
 
 void VCAI::heroMoved(const TryMoveHero & details)
@@ -109,9 +113,13 @@ void VCAI::heroMoved(const TryMoveHero & details)
 	validateObject(details.id); //enemy hero may have left visible area
 	auto hero = cb->getHero(details.id);
 	cachedSectorMaps.clear();
+	distanceField.clear();
+	decompositionCache.clear();
 
 	const int3 from = CGHeroInstance::convertPosition(details.start, false),
 		to = CGHeroInstance::convertPosition(details.end, false);
+	dangerMap.invalidate(from);
+	dangerMap.invalidate(to);
 	const CGObjectInstance *o1 = vstd::frontOrNull(cb->getVisitableObjs(from)),
 		*o2 = vstd::frontOrNull(cb->getVisitableObjs(to));
 
@@ -152,12 +160,19 @@ void VCAI::stackChagedCount(const StackLocation &location, const TQuantity &chan
 {
 	LOG_TRACE_PARAMS(logAi, "isAbsolute '%i'", isAbsolute);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(location.army->visitablePos());
+	distanceField.invalidate(location.army);
+	decompositionCache.clear();
 }
 
 void VCAI::heroInGarrisonChange(const CGTownInstance *town)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(town->visitablePos());
+	distanceField.invalidate(town->garrisonHero);
+	distanceField.invalidate(town->visitingHero);
+	decompositionCache.clear();
 }
 
 void VCAI::centerView(int3 pos, int focusTime)
@@ -170,12 +185,15 @@ void VCAI::artifactMoved(const ArtifactLocation &src, const ArtifactLocation &ds
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(src.relatedObj());
+	distanceField.invalidate(dst.relatedObj());
 }
 
 void VCAI::artifactAssembled(const ArtifactLocation &al)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(al.relatedObj());
 }
 
 void VCAI::showTavernWindow(const CGObjectInstance *townOrTavern)
@@ -238,24 +256,30 @@ void VCAI::artifactPut(const ArtifactLocation &al)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(al.relatedObj());
 }
 
 void VCAI::artifactRemoved(const ArtifactLocation &al)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(al.relatedObj());
 }
 
 void VCAI::stacksErased(const StackLocation &location)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(location.army->visitablePos());
+	distanceField.invalidate(location.army);
+	decompositionCache.clear();
 }
 
 void VCAI::artifactDisassembled(const ArtifactLocation &al)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(al.relatedObj());
 }
 
 
@@ -296,6 +320,8 @@ void VCAI::tileHidden(const std::unordered_set<int3, ShashInt3> &pos)
 
 	validateVisitableObjs();
 	clearPathsInfo();
+	for(int3 tile : pos)
+		dangerMap.invalidate(tile);
 }
 
 void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> &pos)
@@ -303,8 +329,11 @@ void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> &pos)
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
 	for(int3 tile : pos)
+	{
 		for(const CGObjectInstance *obj : myCb->getVisitableObjs(tile))
 			addVisitableObj(obj);
+		dangerMap.invalidate(tile);
+	}
 
 	clearPathsInfo();
 }
@@ -381,12 +410,21 @@ void VCAI::stackChangedType(const StackLocation &location, const CCreature &newT
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(location.army->visitablePos());
+	distanceField.invalidate(location.army);
+	decompositionCache.clear();
 }
 
 void VCAI::stacksRebalanced(const StackLocation &src, const StackLocation &dst, TQuantity count)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(src.army->visitablePos());
+	dangerMap.invalidate(dst.army->visitablePos());
+	distanceField.invalidate(src.army);
+	distanceField.invalidate(dst.army);
+	if (src.army != dst.army) //splitting stack does not change strength of army
+		decompositionCache.clear();
 }
 
 void VCAI::newObject(const CGObjectInstance * obj)
@@ -397,6 +435,9 @@ void VCAI::newObject(const CGObjectInstance * obj)
 		addVisitableObj(obj);
 
 	cachedSectorMaps.clear();
+	distanceField.clear();
+	decompositionCache.clear();
+	dangerMap.invalidate(obj->visitablePos());
 }
 
 void VCAI::objectRemoved(const CGObjectInstance *obj)
@@ -424,6 +465,9 @@ void VCAI::objectRemoved(const CGObjectInstance *obj)
 	}
 
 	cachedSectorMaps.clear(); //invalidate all paths
+	distanceField.clear();
+	decompositionCache.clear();
+	dangerMap.invalidate(obj->visitablePos());
 
 	//TODO
 	//there are other places where CGObjectinstance ptrs are stored...
@@ -450,19 +494,23 @@ void VCAI::playerBonusChanged(const Bonus &bonus, bool gain)
 {
 	LOG_TRACE_PARAMS(logAi, "gain '%i'", gain);
 	NET_EVENT_HANDLER;
+	distanceField.clear();
 }
 
 void VCAI::newStackInserted(const StackLocation &location, const CStackInstance &stack)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(location.army->visitablePos());
+	distanceField.invalidate(location.army);
+	decompositionCache.clear();
 }
 
 void VCAI::heroCreated(const CGHeroInstance* h)
 {
 	LOG_TRACE(logAi);
-	if (h->visitedTown)
-		townVisitsThisWeek[HeroPtr(h)].insert(h->visitedTown);
+	if (h->visitedTown && townVisitsThisWeek[HeroPtr(h)].insert(h->visitedTown).second)
+		decompositionCache.clear();
 	NET_EVENT_HANDLER;
 }
 
@@ -499,12 +547,19 @@ void VCAI::receivedResource()
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	decompositionCache.clear();
 }
 
 void VCAI::stacksSwapped(const StackLocation &loc1, const StackLocation &loc2)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	dangerMap.invalidate(loc1.army->visitablePos());
+	dangerMap.invalidate(loc2.army->visitablePos());
+	distanceField.invalidate(loc1.army);
+	distanceField.invalidate(loc2.army);
+	if (loc1.army != loc2.army) //reordering slots does not change strength of army
+		decompositionCache.clear();
 }
 
 void VCAI::showUniversityWindow(const IMarket *market, const CGHeroInstance *visitor)
@@ -523,6 +578,7 @@ void VCAI::heroSecondarySkillChanged(const CGHeroInstance * hero, int which, int
 {
 	LOG_TRACE_PARAMS(logAi, "which '%d', val '%d'", which % val);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(hero); //pathfinding, logistics or navigation
 }
 
 void VCAI::battleResultsApplied()
@@ -539,6 +595,8 @@ void VCAI::objectPropertyChanged(const SetObjectProperty * sop)
 	NET_EVENT_HANDLER;
 	if(sop->what == ObjProperty::OWNER)
 	{
+		if(auto obj = myCb->getObj(sop->id, false))
+			dangerMap.invalidate(obj->visitablePos()); //relations with owner decide if object is dangerous
 		if(myCb->getPlayerRelations(playerID, (PlayerColor)sop->val) == PlayerRelations::ENEMIES)
 		{
 			//we want to visit objects owned by oppponents
@@ -556,12 +614,14 @@ void VCAI::buildChanged(const CGTownInstance *town, BuildingID buildingID, int w
 {
 	LOG_TRACE_PARAMS(logAi, "what '%i'", what);
 	NET_EVENT_HANDLER;
+	decompositionCache.clear();
 }
 
 void VCAI::heroBonusChanged(const CGHeroInstance *hero, const Bonus &bonus, bool gain)
 {
 	LOG_TRACE_PARAMS(logAi, "gain '%i'", gain);
 	NET_EVENT_HANDLER;
+	distanceField.invalidate(hero);
 }
 
 void VCAI::showMarketWindow(const IMarket *market, const CGHeroInstance *visitor)
@@ -606,6 +666,7 @@ void VCAI::heroGotLevel(const CGHeroInstance *hero, PrimarySkill::PrimarySkill p
 	LOG_TRACE_PARAMS(logAi, "queryID '%i'", queryID);
 	NET_EVENT_HANDLER;
 	status.addQuery(queryID, boost::str(boost::format("Hero %s got level %d") % hero->name % hero->level));
+	distanceField.invalidate(hero);
 	requestActionASAP([=](){ answerQuery(queryID, 0); });
 }
 
@@ -755,6 +816,13 @@ void VCAI::makeTurn()
 	MAKING_TURN;
 	boost::shared_lock<boost::shared_mutex> gsLock(CGameState::mutex);
 	setThreadName("VCAI::makeTurn");
+	CPerformanceTimer turnTimer("aiTurn", GameConstants::PLAYER_COLOR_NAMES[playerID.getNum()]);
+
+	//enemies moved and recruited since our last turn
+	dangerMap.clear();
+	distanceField.clear();
+	decompositionCache.clear();
+	fh->resetCaches();
 
 	switch(cb->getDate(Date::DAY_OF_WEEK))
 	{
@@ -909,7 +977,8 @@ void VCAI::performObjectInteraction(const CGObjectInstance * obj, HeroPtr h)
 			moveCreaturesToHero (dynamic_cast<const CGTownInstance *>(obj));
 			if (h->visitedTown) //we are inside, not just attacking
 			{
-				townVisitsThisWeek[h].insert(h->visitedTown);
+				if (townVisitsThisWeek[h].insert(h->visitedTown).second)
+					decompositionCache.clear();
 				if (!h->hasSpellbook() && cb->getResourceAmount(Res::GOLD) >= GameConstants::SPELLBOOK_GOLD_COST + saving[Res::GOLD] &&
 					h->visitedTown->hasBuilt (BuildingID::MAGES_GUILD_1))
 					cb->buyArtifact(h.get(), ArtifactID::SPELLBOOK);
@@ -1216,8 +1285,11 @@ bool VCAI::tryBuildStructure(const CGTownInstance * t, BuildingID building, unsi
 			{
 				//int diff = currentRes[i] - cost[i] + income[i];
 				int diff = currentRes[i] - cost[i];
-				if(diff < 0)
+				if(diff < 0 && !saving[i])
+				{
 					saving[i] = 1;
+					decompositionCache.clear(); //goals see only resources we are not saving
+				}
 			}
 			continue;
 		}
@@ -1631,7 +1703,8 @@ void VCAI::wander(HeroPtr h)
 
 		if (h->visitedTown)
 		{
-			townVisitsThisWeek[h].insert(h->visitedTown);
+			if (townVisitsThisWeek[h].insert(h->visitedTown).second)
+				decompositionCache.clear();
 			buildArmyIn(h->visitedTown);
 		}
 	}
@@ -1639,6 +1712,10 @@ void VCAI::wander(HeroPtr h)
 
 void VCAI::setGoal(HeroPtr h, Goals::TSubgoal goal)
 {
+	auto previous = getGoal(h);
+	auto previousKey = previous->getKey();
+	auto previousPriority = previous->priority;
+
 	if(goal->invalid())
 		vstd::erase_if_present(lockedHeroes, h);
 	else
@@ -1646,6 +1723,11 @@ void VCAI::setGoal(HeroPtr h, Goals::TSubgoal goal)
 		lockedHeroes[h] = goal;
 		goal->setisElementar(false); //Force always evaluate goals before realizing
 	}
+
+	//decompositions depend on type and priority of missions of locked heroes, relocking hero with same goal changes nothing
+	auto current = getGoal(h);
+	if(current->getKey() != previousKey || current->priority != previousPriority)
+		decompositionCache.clear();
 }
 void VCAI::evaluateGoal(HeroPtr h)
 {
@@ -1655,6 +1737,13 @@ void VCAI::evaluateGoal(HeroPtr h)
 
 void VCAI::completeGoal (Goals::TSubgoal goal)
 {
+	auto lockedHeroesCount = lockedHeroes.size();
+	auto invalidateDecompositions = vstd::makeScopeGuard([&]()
+	{
+		if (lockedHeroes.size() != lockedHeroesCount) //some heroes were freed
+			decompositionCache.clear();
+	});
+
 	logAi->trace("Completing goal: %s", goal->name());
 	if (const CGHeroInstance * h = goal->hero.get(true))
 	{
@@ -1716,29 +1805,34 @@ void VCAI::markObjectVisited (const CGObjectInstance *obj)
 		dynamic_cast<const CGBonusingObject *>(obj) || //or another time
 		(obj->ID == Obj::MONSTER))
 		return;
-	alreadyVisited.insert(obj);
+	if (alreadyVisited.insert(obj).second)
+		decompositionCache.clear();
 }
 
 void VCAI::reserveObject(HeroPtr h, const CGObjectInstance *obj)
 {
-	reservedObjs.insert(obj);
+	if (reservedObjs.insert(obj).second)
+		decompositionCache.clear();
 	reservedHeroesMap[h].insert(obj);
 	logAi->debug("reserved object id=%d; address=%p; name=%s", obj->id ,obj, obj->getObjectName());
 }
 
 void VCAI::unreserveObject(HeroPtr h, const CGObjectInstance *obj)
 {
-	vstd::erase_if_present(reservedObjs, obj); //unreserve objects
+	if (reservedObjs.erase(obj)) //unreserve objects
+		decompositionCache.clear();
 	vstd::erase_if_present(reservedHeroesMap[h], obj);
 }
 
 void VCAI::markHeroUnableToExplore (HeroPtr h)
 {
-	heroesUnableToExplore.insert(h);
+	if (heroesUnableToExplore.insert(h).second)
+		decompositionCache.clear();
 }
 void VCAI::markHeroAbleToExplore (HeroPtr h)
 {
-	vstd::erase_if_present(heroesUnableToExplore, h);
+	if (heroesUnableToExplore.erase(h))
+		decompositionCache.clear();
 }
 bool VCAI::isAbleToExplore (HeroPtr h)
 {
@@ -1748,6 +1842,8 @@ void VCAI::clearPathsInfo()
 {
 	heroesUnableToExplore.clear();
 	cachedSectorMaps.clear();
+	distanceField.clear();
+	decompositionCache.clear();
 }
 
 void VCAI::validateVisitableObjs()
@@ -1786,36 +1882,31 @@ void VCAI::validateVisitableObjs()
 
 void VCAI::retreiveVisitableObjs(std::vector<const CGObjectInstance *> &out, bool includeOwned) const
 {
-	foreach_tile_pos([&](const int3 &pos)
+	for(const CGObjectInstance *obj : myCb->getAllVisitableObjs())
 	{
-		for(const CGObjectInstance *obj : myCb->getVisitableObjs(pos, false))
-		{
-			if(includeOwned || obj->tempOwner != playerID)
-				out.push_back(obj);
-		}
-	});
+		if(includeOwned || obj->tempOwner != playerID)
+			out.push_back(obj);
+	}
 }
 
 void VCAI::retreiveVisitableObjs()
 {
-	foreach_tile_pos([&](const int3 &pos)
+	for(const CGObjectInstance *obj : myCb->getAllVisitableObjs())
 	{
-		for(const CGObjectInstance *obj : myCb->getVisitableObjs(pos, false))
-		{
-			if(obj->tempOwner != playerID)
-				addVisitableObj(obj);
-		}
-	});
+		if(obj->tempOwner != playerID)
+			addVisitableObj(obj);
+	}
 }
 
 std::vector<const CGObjectInstance *> VCAI::getFlaggedObjects() const
 {
 	std::vector<const CGObjectInstance *> ret;
-	for(const CGObjectInstance *obj : visitableObjs)
+	for(const CGObjectInstance *obj : myCb->getMyObjects())
 	{
-		if(obj->tempOwner == playerID)
+		if(vstd::contains(visitableObjs, obj))
 			ret.push_back(obj);
 	}
+	boost::sort(ret, visitableObjs.key_comp()); //same order as in visitableObjs
 	return ret;
 }
 
@@ -1832,13 +1923,15 @@ void VCAI::addVisitableObj(const CGObjectInstance *obj)
 
 const CGObjectInstance * VCAI::lookForArt(int aid) const
 {
-	for(const CGObjectInstance *obj : ai->visitableObjs)
+	const CGObjectInstance * ret = nullptr;
+	for(const CGObjectInstance *obj : myCb->getObjectsOfType(Obj::ARTIFACT, aid))
 	{
-		if(obj->ID == Obj::ARTIFACT && obj->subID == aid)
-			return obj;
+		//first one in visitableObjs order
+		if(vstd::contains(visitableObjs, obj) && (!ret || visitableObjs.key_comp()(obj, ret)))
+			ret = obj;
 	}
 
-	return nullptr;
+	return ret;
 
 	//TODO what if more than one artifact is available? return them all or some slection criteria
 }
@@ -1887,7 +1980,7 @@ bool VCAI::isAccessibleForHero(const int3 & pos, HeroPtr h, bool includeAllies)
 				return false;
 		}
 	}
-	return cb->getPathsInfo(h.get())->getPathInfo(pos)->reachable();
+	return distanceField.getDistance(h.get(), pos).reachable();
 }
 
 bool VCAI::moveHeroToTile(int3 dst, HeroPtr h)
@@ -2193,7 +2286,11 @@ void VCAI::tryRealize(Goals::CollectRes & g)
 	}
 	else
 	{
-		saving[g.resID] = 1;
+		if (!saving[g.resID])
+		{
+			saving[g.resID] = 1;
+			decompositionCache.clear();
+		}
 		throw cannotFulfillGoalException("No object that could be used to raise resources!");
 	}
 }
@@ -2330,24 +2427,27 @@ Goals::TSubgoal VCAI::striveToGoalInternal(Goals::TSubgoal ultimateGoal, bool on
 		while(!goal->isElementar && maxGoals && (onlyAbstract || !goal->isAbstract))
 		{
 			logAi->debug("Considering goal %s", goal->name());
-			try
-			{
-				boost::this_thread::interruption_point();
-				goal = goal->whatToDoToAchieve();
-				--maxGoals;
-				if (*goal == *ultimateGoal) //compare objects by value
-					throw cannotFulfillGoalException("Goal dependency loop detected!");
-			}
-			catch(goalFulfilledException &e)
+			boost::this_thread::interruption_point();
+			auto result = decomposeGoal(goal);
+			switch(result.status)
 			{
+			case Goals::DecompositionResult::FULFILLED:
 				//it is impossible to continue some goals (like exploration, for example)
 				completeGoal (goal);
 				logAi->debug("Goal %s decomposition failed: goal was completed as much as possible", goal->name());
 				return sptr(Goals::Invalid());
+			case Goals::DecompositionResult::IMPOSSIBLE:
+				logAi->debug("Goal %s decomposition failed: %s", goal->name(), result.reason);
+				return sptr(Goals::Invalid());
+			default:
+				break;
 			}
-			catch(std::exception &e)
+
+			goal = result.subgoal;
+			--maxGoals;
+			if (*goal == *ultimateGoal) //compare objects by value
 			{
-				logAi->debug("Goal %s decomposition failed: %s", goal->name(), e.what());
+				logAi->debug("Goal %s decomposition failed: Goal dependency loop detected!", goal->name());
 				return sptr(Goals::Invalid());
 			}
 		}
@@ -2359,7 +2459,10 @@ Goals::TSubgoal VCAI::striveToGoalInternal(Goals::TSubgoal ultimateGoal, bool on
 			if (!maxGoals) //we counted down to 0 and found no solution
 			{
 				if (ultimateGoal->hero) // we seemingly don't know what to do with hero, free him
+				{
 					vstd::erase_if_present(lockedHeroes, ultimateGoal->hero);
+					decompositionCache.clear();
+				}
 				std::runtime_error e("Too many subgoals, don't know what to do");
 				throw (e);
 			}
@@ -2408,6 +2511,39 @@ Goals::TSubgoal VCAI::striveToGoalInternal(Goals::TSubgoal ultimateGoal, bool on
 	return abstractGoal;
 }
 
+Goals::DecompositionResult VCAI::decomposeGoal(Goals::TSubgoal goal)
+{
+	//callers modify returned goals (priority, hero locks), so cache never shares them
+	auto copyResult = [](Goals::DecompositionResult result)
+	{
+		if (result.subgoal)
+			result.subgoal = sptr(*result.subgoal);
+		return result;
+	};
+
+	auto key = goal->getKey();
+	auto cached = decompositionCache.find(key);
+	if (cached != decompositionCache.end())
+		return copyResult(cached->second);
+
+	auto result = Goals::DecompositionResult::impossible("");
+	try
+	{
+		result = goal->whatToDoToAchieve();
+	}
+	catch(boost::thread_interrupted &e)
+	{
+		throw;
+	}
+	catch(std::exception &e) //goals report failures by result, this handles errors in underlying code
+	{
+		result = Goals::DecompositionResult::impossible(e.what());
+	}
+
+	decompositionCache.insert(std::make_pair(key, copyResult(result)));
+	return result;
+}
+
 void VCAI::striveToQuest (const QuestInfo &q)
 {
 	if (q.quest->missionType && q.quest->progress != CQuest::COMPLETE)
@@ -3504,7 +3640,7 @@ int3 SectorMap::findFirstVisitableTile (HeroPtr h, crint3 dst)
 			logAi->warn("Another allied hero stands in our way");
 			return ret;
 		}
-		if(ai->myCb->getPathsInfo(h.get())->getPathInfo(curtile)->reachable())
+		if(ai->distanceField.getDistance(h.get(), curtile).reachable())
 		{
 			return curtile;
 		}
@@ -155,6 +155,9 @@ public:
 	std::set<const CGObjectInstance *> reservedObjs; //to be visited by specific hero
 
 	std::map <HeroPtr, std::shared_ptr<SectorMap>> cachedSectorMaps; //TODO: serialize? not necessary
+	DangerMap dangerMap; //rebuilt every turn, not serialized
+	mutable DistanceField distanceField; //refreshed lazily, not serialized
+	std::map<Goals::TGoalKey, Goals::DecompositionResult> decompositionCache; //cleared when game state or our bookkeeping seen by goals changes, not serialized
 
 	TResources saving;
 
@@ -260,6 +263,7 @@ public:
 	void buildArmyIn(const CGTownInstance * t);
 	void striveToGoal(Goals::TSubgoal ultimateGoal);
 	Goals::TSubgoal striveToGoalInternal(Goals::TSubgoal ultimateGoal, bool onlyAbstract);
+	Goals::DecompositionResult decomposeGoal(Goals::TSubgoal goal); //memoized single decomposition step
 	void endTurn();
 	void wander(HeroPtr h);
 	void setGoal(HeroPtr h, Goals::TSubgoal goal);
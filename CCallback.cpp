@@ -27,7 +27,6 @@
 #include "lib/GameConstants.h"
 #include "lib/CPlayerState.h"
 #include "lib/UnlockGuard.h"
-#include "lib/battle/BattleInfo.h"
 
 bool CCallback::teleportHero(const CGHeroInstance *who, const CGTownInstance *where)
 {
@@ -172,15 +171,7 @@ bool CCallback::buildBuilding(const CGTownInstance *town, BuildingID buildingID)
 	return true;
 }
 
-int CBattleCallback::battleMakeAction(BattleAction* action)
-{
-	assert(action->actionType == Battle::HERO_SPELL);
-	MakeCustomAction mca(*action);
-	sendRequest(&mca);
-	return 0;
-}
-
-int CBattleCallback::sendRequest(const CPack *request)
+int CCallback::sendRequest(const CPack *request)
 {
 	int requestID = cl->sendRequest(request, *player);
 	if(waitTillRealize)
@@ -280,7 +271,7 @@ void CCallback::buildBoat( const IShipyard *obj )
 }
 
 CCallback::CCallback( CGameState * GS, boost::optional<PlayerColor> Player, CClient *C )
-	:CBattleCallback(GS, Player, C)
+	:CBattleCallback(GS, Player), cl(C)
 {
 	waitTillRealize = false;
 	unlockGsWhenWaiting = false;
@@ -366,19 +357,3 @@ void CCallback::unregisterBattleInterface(std::shared_ptr<IBattleEventsReceiver>
 {
 	cl->additionalBattleInts[*player] -= battleEvents;
 }
-
-CBattleCallback::CBattleCallback(CGameState *GS, boost::optional<PlayerColor> Player, CClient *C )
-{
-	gs = GS;
-	player = Player;
-	cl = C;
-}
-
-bool CBattleCallback::battleMakeTacticAction( BattleAction * action )
-{
-	assert(cl->gs->curB->tacticDistance);
-	MakeAction ma;
-	ma.ba = *action;
-	sendRequest(&ma);
-	return true;
-}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "lib/CGameInfoCallback.h"
+#include "lib/battle/CBattleCallback.h"
 #include "lib/int3.h" // for int3
 
 class CGHeroInstance;
@@ -30,16 +31,6 @@ class IBattleEventsReceiver;
 class IGameEventsReceiver;
 struct ArtifactLocation;
 
-class IBattleCallback
-{
-public:
-	bool waitTillRealize; //if true, request functions will return after they are realized by server
-	bool unlockGsWhenWaiting;//if true after sending each request, gs mutex will be unlocked so the changes can be applied; NOTICE caller must have gs mx locked prior to any call to actiob callback!
-	//battle
-	virtual int battleMakeAction(BattleAction* action)=0;//for casting spells by hero - DO NOT use it for moving active stack
-	virtual bool battleMakeTacticAction(BattleAction * action) =0; // performs tactic phase actions
-};
-
 class IGameActionCallback
 {
 public:
@@ -78,26 +69,12 @@ public:
 	virtual void buildBoat(const IShipyard *obj) = 0;
 };
 
-struct CPack;
-
-class CBattleCallback : public IBattleCallback, public CPlayerBattleCallback
+class CCallback : public CPlayerSpecificInfoCallback, public IGameActionCallback, public CBattleCallback
 {
 protected:
-	int sendRequest(const CPack *request); //returns requestID (that'll be matched to requestID in PackageApplied)
+	int sendRequest(const CPack *request) override; //returns requestID (that'll be matched to requestID in PackageApplied)
 	CClient *cl;
-	//virtual bool hasAccess(int playerId) const;
 
-public:
-	CBattleCallback(CGameState *GS, boost::optional<PlayerColor> Player, CClient *C);
-	int battleMakeAction(BattleAction* action) override;//for casting spells by hero - DO NOT use it for moving active stack
-	bool battleMakeTacticAction(BattleAction * action) override; // performs tactic phase actions
-
-	friend class CCallback;
-	friend class CClient;
-};
-
-class CCallback : public CPlayerSpecificInfoCallback, public IGameActionCallback, public CBattleCallback
-{
 public:
 	CCallback(CGameState * GS, boost::optional<PlayerColor> Player, CClient *C);
 	virtual ~CCallback();
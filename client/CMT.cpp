@@ -53,7 +53,10 @@
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/StringConstants.h"
 #include "../lib/CPlayerState.h"
+#include "../lib/CPerformanceCounters.h"
+#include "../lib/rmg/CMapGenOptions.h"
 #include "gui/CAnimation.h"
+#include "gui/PalettedBlitter.h"
 
 #ifdef VCMI_WINDOWS
 #include "SDL_syswm.h"
@@ -113,11 +116,8 @@ void endGame();
 #include <getopt.h>
 #endif
 
-void startTestMap(const std::string &mapname)
+static void addComputerPlayers(StartInfo & si)
 {
-	StartInfo si;
-	si.mapname = mapname;
-	si.mode = StartInfo::NEW_GAME;
 	for (int i = 0; i < 8; i++)
 	{
 		PlayerSettings &pset = si.playerInfos[PlayerColor(i)];
@@ -130,12 +130,178 @@ void startTestMap(const std::string &mapname)
 		pset.heroPortrait = -1;
 		pset.handicap = PlayerSettings::NO_HANDICAP;
 	}
+}
+
+void startTestMap(const std::string &mapname)
+{
+	StartInfo si;
+	si.mapname = mapname;
+	si.mode = StartInfo::NEW_GAME;
+	addComputerPlayers(si);
 
 	while(GH.topInt())
 		GH.popIntTotally(GH.topInt());
 	startGame(&si);
 }
 
+/// Benchmark ends after given number of days or when there are no two teams left to play
+static bool isBenchmarkFinished(int days)
+{
+	boost::shared_lock<boost::shared_mutex> lock(CGameState::mutex);
+	if(client->getDate(Date::DAY) > days)
+		return true;
+
+	std::set<TeamID> teamsInGame;
+	for(auto & elem : client->getStartInfo()->playerInfos)
+	{
+		if(client->getPlayerStatus(elem.first, false) == EPlayerStatus::INGAME)
+			teamsInGame.insert(client->getPlayerTeam(elem.first)->id);
+	}
+	return teamsInGame.size() < 2;
+}
+
+/// Plays AI-only game with fixed seed, saves performance report of client and server and compares it with baseline
+/// Returns exit code of application
+static int runBenchmark()
+{
+	const std::string reportPath = vm["benchmark"].as<std::string>();
+	const std::string serverReportPath = reportPath + ".server";
+	const ui32 seed = vm.count("benchmark-seed") ? vm["benchmark-seed"].as<ui32>() : 1;
+	const int days = vm.count("benchmark-days") ? vm["benchmark-days"].as<int>() : 7;
+
+	StartInfo si;
+	si.mode = StartInfo::NEW_GAME;
+	si.seedToBeUsed = seed;
+	std::string mapName;
+	if(vm.count("benchmark-template"))
+	{
+		mapName = vm["benchmark-template"].as<std::string>();
+		si.mapGenOptions = std::make_shared<CMapGenOptions>();
+		si.mapGenOptions->setMapTemplate(mapName);
+		if(!si.mapGenOptions->getMapTemplate())
+		{
+			logGlobal->error("Benchmark: random map template %s was not found!", mapName);
+			return EXIT_FAILURE;
+		}
+	}
+	else if(vm.count("testmap"))
+	{
+		mapName = si.mapname = vm["testmap"].as<std::string>();
+	}
+	else
+	{
+		logGlobal->error("Benchmark: map has to be given by --testmap or --benchmark-template option!");
+		return EXIT_FAILURE;
+	}
+	addComputerPlayers(si);
+
+	logGlobal->info("Benchmark: playing %d days on %s with seed %d", days, mapName, seed);
+	bfs::remove(serverReportPath);
+	std::srand(seed);
+	CPerformanceCounters::get().reset();
+	CPerformanceCounters::get().setEnabled(true);
+	auto start = std::chrono::steady_clock::now();
+
+	startGame(&si);
+	while(!isBenchmarkFinished(days))
+		boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+
+	JsonNode report = CPerformanceCounters::get().toJson();
+	report["wallTimeMs"].Float() = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	report["map"].String() = mapName;
+	report["seed"].Integer() = seed;
+	{
+		boost::shared_lock<boost::shared_mutex> lock(CGameState::mutex);
+		report["days"].Integer() = client->getDate(Date::DAY) - 1;
+	}
+
+	endGame();
+	if(!settings["session"]["donotstartserver"].Bool())
+	{
+		//server saves its own report on exit
+		serverAlive.waitWhileTrue();
+		JsonNode serverReport = CPerformanceCounters::loadReport(serverReportPath);
+		if(!serverReport.isNull())
+			report["server"] = serverReport;
+	}
+	CPerformanceCounters::saveReport(reportPath, report);
+	logGlobal->info("Benchmark: report has been saved to %s", reportPath);
+
+	int result = EXIT_SUCCESS;
+	if(vm.count("benchmark-baseline"))
+	{
+		const std::string baselinePath = vm["benchmark-baseline"].as<std::string>();
+		const double tolerance = vm.count("benchmark-tolerance") ? vm["benchmark-tolerance"].as<double>() : 10.0;
+		JsonNode baseline = CPerformanceCounters::loadReport(baselinePath);
+		if(baseline.isNull())
+		{
+			logGlobal->error("Benchmark: baseline %s was not found!", baselinePath);
+			result = EXIT_FAILURE;
+		}
+		else
+		{
+			auto regressions = CPerformanceCounters::compare(report, baseline, tolerance / 100.0);
+			for(auto & regression : regressions)
+				logGlobal->error("Benchmark: regression of %s", regression);
+			if(!regressions.empty())
+				result = EXIT_FAILURE;
+			else
+				logGlobal->info("Benchmark: no regressions against %s", baselinePath);
+		}
+	}
+
+	dispose();
+	vstd::clear_pointer(console);
+	return result;
+}
+
+/// Draws all frames of animation, loaded both as plain and as RLE-compressed images, onto 32 bpp surface
+/// with every paletted blitting kernel supported by CPU and prints time spent by each of them
+static void runBlitBenchmark(const std::string & URI, int iterations)
+{
+	std::unique_ptr<CAnimation> plain = make_unique<CAnimation>(URI);
+	std::unique_ptr<CAnimation> compressed = make_unique<CAnimation>(URI, true);
+	plain->preload();
+	compressed->preload();
+
+	SDL_Surface * target = CSDL_Ext::createSurfaceWithBpp<4>(800, 600);
+	const PalettedBlitter::EKernel defaultKernel = PalettedBlitter::getKernel();
+
+	for(auto kernel : {PalettedBlitter::EKernel::SCALAR, PalettedBlitter::EKernel::SSE2, PalettedBlitter::EKernel::AVX2})
+	{
+		if(!PalettedBlitter::setKernel(kernel))
+			continue;
+
+		for(auto anim : {plain.get(), compressed.get()})
+		{
+			size_t frames = 0;
+			auto start = std::chrono::steady_clock::now();
+			for(int i = 0; i < iterations; i++)
+			{
+				//groups are not contiguous, this range covers all of them in creature animations
+				for(size_t group = 0; group < 64; group++)
+				{
+					for(size_t frame = 0; frame < anim->size(group); frame++)
+					{
+						IImage * image = anim->getImage(frame, group, false);
+						if(image)
+						{
+							image->draw(target);
+							frames++;
+						}
+					}
+				}
+			}
+			auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			std::cout << PalettedBlitter::getKernelName(kernel) << (anim == plain.get() ? " plain: " : " RLE: ")
+				<< frames << " frames in " << duration << " us\n";
+		}
+	}
+
+	PalettedBlitter::setKernel(defaultKernel);
+	SDL_FreeSurface(target);
+}
+
 void startGameFromFile(const bfs::path &fname)
 {
 	StartInfo si;
@@ -267,7 +433,13 @@ int main(int argc, char * argv[])
 		("loadserverport",po::value<std::string>(),"port for loaded game server")
 		("serverport", po::value<si64>(), "override port specified in config file")
 		("saveprefix", po::value<std::string>(), "prefix for auto save files")
-		("savefrequency", po::value<si64>(), "limit auto save creation to each N days");
+		("savefrequency", po::value<si64>(), "limit auto save creation to each N days")
+		("benchmark", po::value<std::string>(), "plays AI-only game without GUI and saves performance report to given file, implies --headless")
+		("benchmark-template", po::value<std::string>(), "random map template to be played by benchmark, otherwise map is given by --testmap")
+		("benchmark-seed", po::value<ui32>(), "random seed of benchmarked game, 1 by default")
+		("benchmark-days", po::value<int>(), "number of days played by benchmark, 7 by default")
+		("benchmark-baseline", po::value<std::string>(), "report to compare benchmark with, exit code is non-zero in case of regression")
+		("benchmark-tolerance", po::value<double>(), "allowed regression against baseline in percent, 10 by default");
 
 	if(argc > 1)
 	{
@@ -312,11 +484,12 @@ int main(int argc, char * argv[])
 	settings.init();
 	Settings session = settings.write["session"];
 	session["onlyai"].Bool() = vm.count("onlyAI");
-	if(vm.count("headless"))
+	if(vm.count("headless") || vm.count("benchmark"))
 	{
 		session["headless"].Bool() = true;
 		session["onlyai"].Bool() = true;
 	}
+	session["benchmark"].String() = vm.count("benchmark") ? vm["benchmark"].as<std::string>() : "";
 	// Server settings
 	session["donotstartserver"].Bool() = vm.count("donotstartserver");
 
@@ -519,7 +692,11 @@ int main(int argc, char * argv[])
 		if(vm.count("spectate-battle-speed"))
 			session["spectate-battle-speed"].Float() = vm["spectate-battle-speed"].as<int>();
 	}
-	if(!session["testmap"].isNull())
+	if(vm.count("benchmark"))
+	{
+		return runBenchmark();
+	}
+	else if(!session["testmap"].isNull())
 	{
 		startTestMap(session["testmap"].String());
 	}
@@ -843,6 +1020,19 @@ void processCommand(const std::string &message)
 		anim->preload();
 		anim->exportBitmaps(VCMIDirs::get().userCachePath() / "extracted");
 	}
+	else if(cn == "blitbench")
+	{
+		std::string URI;
+		int iterations = 100;
+		readed >> URI >> iterations;
+		runBlitBenchmark(URI, std::max(iterations, 1));
+	}
+	else if(cn == "animcache")
+	{
+		AnimationCacheStats stats = CAnimation::getCacheStats();
+		std::cout << "Def files: " << stats.fileHits << " hits, " << stats.fileMisses << " misses, " << stats.fileBytes << " bytes\n";
+		std::cout << "Frames: " << stats.frameHits << " hits, " << stats.frameMisses << " misses, " << stats.frameBytes << " bytes\n";
+	}
 	else if(cn == "extract")
 	{
 		std::string URI;
@@ -696,6 +696,7 @@ void CPlayerInterface::battleStacksHealedRes(const std::vector<std::pair<ui32, u
 		{
 			//stack has been resurrected
 			battleInt->creAnims[healed->ID]->setType(CCreatureAnim::HOLDING);
+			battleInt->stacksChanged();
 		}
 	}
 
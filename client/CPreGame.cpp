@@ -31,6 +31,7 @@
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/VCMIDirs.h"
 #include "../lib/mapping/CMap.h"
+#include "../lib/mapping/CMapHeaderIndex.h"
 #include "windows/GUIClasses.h"
 #include "CPlayerInterface.h"
 #include "../CCallback.h"
@@ -1117,23 +1118,22 @@ void SelectionTab::parseMaps(const std::unordered_set<ResourceID> &files)
 {
 	logGlobal->debug("Parsing %d maps", files.size());
 	allItems.clear();
-	for(auto & file : files)
+
+	CMapHeaderIndex index(VCMIDirs::get().userCachePath() / "MapHeaderIndex.bin");
+	for(auto & entry : index.getHeaders(files))
 	{
-		try
+		// ignore unsupported map versions (e.g. WoG maps without WoG)
+		// but accept VCMI maps
+		if((entry.second->version >= EMapFormat::VCMI) || (entry.second->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
 		{
 			CMapInfo mapInfo;
-			mapInfo.mapInit(file.getName());
-
-			// ignore unsupported map versions (e.g. WoG maps without WoG)
-			// but accept VCMI maps
-			if((mapInfo.mapHeader->version >= EMapFormat::VCMI) || (mapInfo.mapHeader->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
-				allItems.push_back(std::move(mapInfo));
-		}
-		catch(std::exception & e)
-		{
-			logGlobal->error("Map %s is invalid. Message: %s", file.getName(), e.what());
+			mapInfo.fileURI = entry.first;
+			mapInfo.mapHeader = make_unique<CMapHeader>(*entry.second);
+			mapInfo.countPlayers();
+			allItems.push_back(std::move(mapInfo));
 		}
 	}
+	index.save();
 }
 
 void SelectionTab::parseGames(const std::unordered_set<ResourceID> &files, CMenuScreen::EGameMode gameMode)
@@ -15,6 +15,7 @@
 #include "gui/SDL_Extensions.h"
 #include "CPlayerInterface.h"
 #include "../lib/filesystem/Filesystem.h"
+#include "../lib/CThreadHelper.h"
 
 extern CGuiHandler GH; //global gui handler
 
@@ -72,6 +73,8 @@ CVideoPlayer::CVideoPlayer()
 	refreshWait = 0;
 	refreshCount = 0;
 	doLoop = false;
+	stopDecoding = false;
+	decodingFinished = false;
 
 	// Register codecs. TODO: May be overkill. Should call a
 	// combination of av_register_input_format() /
@@ -229,21 +232,112 @@ bool CVideoPlayer::open(std::string fname, bool loop, bool useOverlay, bool scal
 	if (sws == nullptr)
 		return false;
 
+	startDecoding();
 	return true;
 }
 
+void CVideoPlayer::startDecoding()
+{
+	stopDecoding = false;
+	decodingFinished = false;
+	decoder = boost::thread(&CVideoPlayer::runDecoder, this);
+}
+
+void CVideoPlayer::stopDecoder()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		stopDecoding = true;
+	}
+	cond.notify_all();
+
+	if (decoder.joinable())
+		decoder.join();
+
+	decodedFrames.clear();
+	unusedFrames.clear();
+}
+
+void CVideoPlayer::runDecoder()
+{
+	setThreadName("CVideoPlayer::runDecoder");
+
+	while(true)
+	{
+		std::unique_ptr<VideoFrame> target;
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			while (!stopDecoding && decodedFrames.size() >= MAX_QUEUED_FRAMES)
+				cond.wait(lock);
+
+			if (stopDecoding)
+				return;
+
+			if (unusedFrames.empty())
+			{
+				target = make_unique<VideoFrame>();
+				allocateFrame(*target);
+			}
+			else
+			{
+				target = std::move(unusedFrames.back());
+				unusedFrames.pop_back();
+			}
+		}
+
+		bool decoded = decodeFrame(*target);
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			if (decoded)
+				decodedFrames.push_back(std::move(target));
+			else
+				decodingFinished = true;
+		}
+		cond.notify_all();
+
+		if (!decoded)
+			return;
+	}
+}
+
+void CVideoPlayer::allocateFrame(VideoFrame & target) const
+{
+	if (texture)
+	{
+		// YUV420P: full size luma plane followed by two chroma planes of half width and height
+		const int chromaWidth = (pos.w + 1) / 2;
+		const int chromaHeight = (pos.h + 1) / 2;
+
+		target.data.resize(pos.w * pos.h + 2 * chromaWidth * chromaHeight);
+		target.planes[0] = target.data.data();
+		target.planes[1] = target.planes[0] + pos.w * pos.h;
+		target.planes[2] = target.planes[1] + chromaWidth * chromaHeight;
+		target.linesize[0] = pos.w;
+		target.linesize[1] = target.linesize[2] = chromaWidth;
+	}
+	else
+	{
+		// same layout as destination surface, so frame can be copied as whole
+		target.data.resize(dest->pitch * dest->h);
+		target.planes[0] = target.data.data();
+		target.planes[1] = target.planes[2] = nullptr;
+		target.linesize[0] = dest->pitch;
+		target.linesize[1] = target.linesize[2] = 0;
+	}
+}
+
 // Read the next frame. Return false on error/end of file.
-bool CVideoPlayer::nextFrame()
+bool CVideoPlayer::decodeFrame(VideoFrame & target)
 {
 	AVPacket packet;
 	int frameFinished = 0;
 	bool gotError = false;
 
-	if (sws == nullptr)
-		return false;
-
 	while(!frameFinished)
 	{
+		if (stopDecoding)
+			break;
+
 		int ret = av_read_frame(format, &packet);
 		if (ret < 0)
 		{
@@ -272,27 +366,8 @@ bool CVideoPlayer::nextFrame()
 				// Did we get a video frame?
 				if (frameFinished)
 				{
-					AVPicture pict;
-
-					if (texture) {
-						avpicture_alloc(&pict, AV_PIX_FMT_YUV420P, pos.w, pos.h);
-
-						sws_scale(sws, frame->data, frame->linesize,
-								  0, codecContext->height, pict.data, pict.linesize);
-
-						SDL_UpdateYUVTexture(texture, NULL, pict.data[0], pict.linesize[0],
-								pict.data[1], pict.linesize[1],
-								pict.data[2], pict.linesize[2]);
-						avpicture_free(&pict);
-					}
-					else
-					{
-						pict.data[0] = (ui8 *)dest->pixels;
-						pict.linesize[0] = dest->pitch;
-
-						sws_scale(sws, frame->data, frame->linesize,
-								  0, codecContext->height, pict.data, pict.linesize);
-					}
+					sws_scale(sws, frame->data, frame->linesize,
+							  0, codecContext->height, target.planes, target.linesize);
 				}
 			}
 
@@ -303,6 +378,49 @@ bool CVideoPlayer::nextFrame()
 	return frameFinished != 0;
 }
 
+CVideoPlayer::EFrameState CVideoPlayer::fetchFrame(bool wait)
+{
+	std::unique_ptr<VideoFrame> current;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		while (wait && decodedFrames.empty() && !decodingFinished)
+			cond.wait(lock);
+
+		if (decodedFrames.empty())
+			return decodingFinished ? EFrameState::FINISHED : EFrameState::PENDING;
+
+		current = std::move(decodedFrames.front());
+		decodedFrames.pop_front();
+	}
+
+	if (texture)
+	{
+		SDL_UpdateYUVTexture(texture, NULL, current->planes[0], current->linesize[0],
+				current->planes[1], current->linesize[1],
+				current->planes[2], current->linesize[2]);
+	}
+	else
+	{
+		memcpy(dest->pixels, current->data.data(), current->data.size());
+	}
+
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		unusedFrames.push_back(std::move(current));
+	}
+	cond.notify_all();
+
+	return EFrameState::READY;
+}
+
+bool CVideoPlayer::nextFrame()
+{
+	if (sws == nullptr)
+		return false;
+
+	return fetchFrame(true) == EFrameState::READY;
+}
+
 void CVideoPlayer::show( int x, int y, SDL_Surface *dst, bool update )
 {
 	if (sws == nullptr)
@@ -328,11 +446,18 @@ void CVideoPlayer::update( int x, int y, SDL_Surface *dst, bool forceRedraw, boo
 
 	if (refreshCount <= 0)
 	{
-		refreshCount = refreshWait;
-		if (nextFrame())
-			show(x,y,dst,update);
-		else
+		switch (fetchFrame(false))
 		{
+		case EFrameState::READY:
+			refreshCount = refreshWait;
+			show(x,y,dst,update);
+			break;
+		case EFrameState::PENDING:
+			// decoder is late, keep old frame and check again on next refresh
+			redraw(x, y, dst, update);
+			break;
+		case EFrameState::FINISHED:
+			refreshCount = refreshWait;
 			open(fname);
 			nextFrame();
 
@@ -340,6 +465,7 @@ void CVideoPlayer::update( int x, int y, SDL_Surface *dst, bool forceRedraw, boo
 			// Note: either the windows player or the linux player is
 			// broken. Compensate here until the bug is found.
 			show(x, y--, dst, update);
+			break;
 		}
 	}
 	else
@@ -352,6 +478,9 @@ void CVideoPlayer::update( int x, int y, SDL_Surface *dst, bool forceRedraw, boo
 
 void CVideoPlayer::close()
 {
+	// decoder thread uses all ffmpeg contexts below
+	stopDecoder();
+
 	fname = "";
 	if (sws)
 	{
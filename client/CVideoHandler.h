@@ -91,6 +91,22 @@ inline void av_frame_free(AVFrame ** frame)
 
 class CVideoPlayer : public IMainVideoPlayer
 {
+	/// frame converted to format of destination texture or surface, waiting to be shown
+	struct VideoFrame
+	{
+		std::vector<ui8> data;
+		ui8 * planes[3];
+		int linesize[3];
+	};
+
+	enum class EFrameState
+	{
+		READY, PENDING, FINISHED
+	};
+
+	/// number of frames decoder thread may prepare in advance
+	static const size_t MAX_QUEUED_FRAMES = 4;
+
 	int stream;					// stream index in video
 	AVFormatContext *format;
 	AVCodecContext *codecContext; // codec context for stream
@@ -111,9 +127,27 @@ class CVideoPlayer : public IMainVideoPlayer
 	int refreshCount;
 	bool doLoop;				// loop through video
 
+	// Demuxing, decoding and conversion run on decoder thread, GUI thread only uploads finished frames
+	// Decoder stops once queue is full, so video that is not shown does not use CPU
+	boost::thread decoder;
+	boost::mutex mx;
+	boost::condition_variable cond;
+	std::deque<std::unique_ptr<VideoFrame>> decodedFrames; //ready to show, in order
+	std::vector<std::unique_ptr<VideoFrame>> unusedFrames; //already shown, buffers can be reused
+	std::atomic<bool> stopDecoding;
+	bool decodingFinished; //end of video or decoding error
+
 	bool playVideo(int x, int y, SDL_Surface *dst, bool stopOnKey);
 	bool open(std::string fname, bool loop, bool useOverlay = false, bool scale = false);
 
+	void startDecoding();
+	void stopDecoder();
+	void runDecoder();
+	bool decodeFrame(VideoFrame & target);
+	void allocateFrame(VideoFrame & target) const;
+	// takes next decoded frame and uploads it to texture or surface
+	EFrameState fetchFrame(bool wait);
+
 public:
 	CVideoPlayer();
 	~CVideoPlayer();
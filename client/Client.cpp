@@ -34,6 +34,7 @@
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
 #include "../lib/serializer/CLoadIntegrityValidator.h"
+#include "../lib/CPerformanceCounters.h"
 #ifndef VCMI_ANDROID
 #include "../lib/Interprocess.h"
 #endif
@@ -680,7 +681,10 @@ void CClient::handlePack( CPack * pack )
 		boost::unique_lock<boost::recursive_mutex> guiLock(*CPlayerInterface::pim);
 		apply->applyOnClBefore(this, pack);
 		logNetwork->trace("\tMade first apply on cl");
-		gs->apply(pack);
+		{
+			CPerformanceTimer timer("packApply");
+			gs->apply(pack);
+		}
 		logNetwork->trace("\tApplied on gs");
 		apply->applyOnClAfter(this, pack);
 		logNetwork->trace("\tMade second apply on cl");
@@ -951,7 +955,7 @@ void CClient::installNewBattleInterface(std::shared_ptr<CBattleGameInterface> ba
 	if(needCallback)
 	{
 		logGlobal->trace("\tInitializing the battle interface for player %s", *color);
-		auto cbc = std::make_shared<CBattleCallback>(gs, color, this);
+		auto cbc = std::make_shared<CCallback>(gs, color, this);
 		battleCallbacks[colorUsed] = cbc;
 		battleInterface->init(cbc);
 	}
@@ -1134,6 +1138,8 @@ void CServerHandler::callServer()
 		+ " --port=" + getDefaultPortStr()
 		+ " --run-by-client"
 		+ " --uuid=" + uuid;
+	if(!settings["session"]["benchmark"].String().empty())
+		comm += " --benchmark-report=\"" + settings["session"]["benchmark"].String() + ".server\"";
 	if(shared)
 	{
 		comm += " --enable-shm";
@@ -236,7 +236,6 @@ public:
 
 	//////////////////////////////////////////////////////////////////////////
 	friend class CCallback; //handling players actions
-	friend class CBattleCallback; //handling players actions
 
 	int sendRequest(const CPack *request, PlayerColor player); //returns ID given to that request
 
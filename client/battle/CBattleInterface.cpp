@@ -99,7 +99,7 @@ CBattleInterface::CBattleInterface(const CCreatureSet *army1, const CCreatureSet
 	: background(nullptr), queue(nullptr), attackingHeroInstance(hero1), defendingHeroInstance(hero2), animCount(0),
       activeStack(nullptr), mouseHoveredStack(nullptr), stackToActivate(nullptr), selectedStack(nullptr), previouslyHoveredHex(-1),
 	  currentlyHoveredHex(-1), attackingHex(-1), stackCanCastSpell(false), creatureCasting(false), spellDestSelectMode(false), spellToCast(nullptr), sp(nullptr),
-	  creatureSpellToCast(-1),
+	  creatureSpellToCast(-1), staticObjectsValid(false), stackObjectsValid(false),
 	  siegeH(nullptr), attackerInt(att), defenderInt(defen), curInt(att), animIDhelper(0),
 	  myTurn(false), resWindow(nullptr), moveStarted(false), moveSoundHander(-1), bresult(nullptr)
 {
@@ -157,6 +157,14 @@ CBattleInterface::CBattleInterface(const CCreatureSet *army1, const CCreatureSet
 	this->army1 = army1;
 	this->army2 = army2;
 	std::vector<const CStack*> stacks = curInt->cb->battleGetAllStacks(true);
+
+	//decode creature animations in background, in reverse order so workers and GUI thread meet in the middle
+	for (auto it = stacks.rbegin(); it != stacks.rend(); ++it)
+	{
+		if ((*it)->position >= 0)
+			CAnimation::prefetch((*it)->getCreature()->animDefName);
+	}
+
 	for (const CStack *s : stacks)
 	{
 		newStack(s);
@@ -951,6 +959,7 @@ void CBattleInterface::bConsoleDownf()
 
 void CBattleInterface::newStack(const CStack *stack)
 {
+	stacksChanged();
 	creDir[stack->ID] = stack->side == BattleSide::ATTACKER; // must be set before getting stack position
 
 	Point coords = CClickableHex::getXYUnitAnim(stack->position, stack, this);
@@ -1022,6 +1031,7 @@ void CBattleInterface::initStackProjectile(const CStack * stack)
 
 void CBattleInterface::stackRemoved(int stackID)
 {
+	stacksChanged();
 	if (activeStack != nullptr)
 	{
 		if (activeStack->ID == stackID)
@@ -1051,12 +1061,14 @@ void CBattleInterface::stackActivated(const CStack *stack) //TODO: check it all
 
 void CBattleInterface::stackMoved(const CStack *stack, std::vector<BattleHex> destHex, int distance)
 {
+	stacksChanged(); //e.g. quicksand could be revealed
 	addNewAnim(new CMovementAnimation(this, stack, destHex, distance));
 	waitForAnims();
 }
 
 void CBattleInterface::stacksAreAttacked(std::vector<StackAttackedInfo> attackedInfos)
 {
+	stacksChanged();
 	for (auto & attackedInfo : attackedInfos)
 	{
 		//if (!attackedInfo.cloneKilled) //FIXME: play dead animation for cloned creature before it vanishes
@@ -2712,6 +2724,7 @@ void CBattleInterface::obstaclePlaced(const CObstacleInstance & oi)
 {
 	//so when multiple obstacles are added, they show up one after another
 	waitForAnims();
+	staticObjectsValid = false;
 
 	int effectID = -1;
 	soundBase::soundID sound; // FIXME(v.markovtsev): soundh->playSound() is commented in the end => warning
@@ -3265,7 +3278,8 @@ void CBattleInterface::showBattlefieldObjects(SDL_Surface *to)
 		showBattleEffects(to, hex.effects);
 	};
 
-	BattleObjectsByHex objects = sortObjectsByHex();
+	sortObjectsByHex();
+	BattleObjectsByHex & objects = sceneObjects;
 
 	// dead stacks should be blit first
 	showStacks(to, objects.beforeAll.dead);
@@ -3291,11 +3305,19 @@ void CBattleInterface::showBattlefieldObjects(SDL_Surface *to)
 	showHexEntry(objects.afterAll);
 }
 
-void CBattleInterface::showAliveStacks(SDL_Surface *to, std::vector<const CStack *> stacks)
+void CBattleInterface::showAliveStacks(SDL_Surface *to, const std::vector<const CStack *> & stacks)
 {
+	auto isSiegeWeapon = [&](const CStack *stack) -> bool
+	{
+		auto cached = siegeWeaponStacks.find(stack->ID);
+		if(cached == siegeWeaponStacks.end())
+			cached = siegeWeaponStacks.insert(std::make_pair(stack->ID, stack->hasBonusOfType(Bonus::SIEGE_WEAPON))).first;
+		return cached->second;
+	};
+
 	auto isAmountBoxVisible = [&](const CStack *stack) -> bool
 	{
-		if(stack->hasBonusOfType(Bonus::SIEGE_WEAPON) && stack->getCount() == 1) //do not show box for singular war machines, stacked war machines with box shown are supported as extension feature
+		if(stack->getCount() == 1 && isSiegeWeapon(stack)) //do not show box for singular war machines, stacked war machines with box shown are supported as extension feature
 			return false;
 
 		if(stack->getCount() == 0) //hide box when target is going to die anyway - do not display "0 creatures"
@@ -3380,7 +3402,7 @@ void CBattleInterface::showAliveStacks(SDL_Surface *to, std::vector<const CStack
 	}
 }
 
-void CBattleInterface::showStacks(SDL_Surface *to, std::vector<const CStack *> stacks)
+void CBattleInterface::showStacks(SDL_Surface *to, const std::vector<const CStack *> & stacks)
 {
 	for (const CStack *stack : stacks)
 	{
@@ -3389,7 +3411,7 @@ void CBattleInterface::showStacks(SDL_Surface *to, std::vector<const CStack *> s
 	}
 }
 
-void CBattleInterface::showObstacles(SDL_Surface *to, std::vector<std::shared_ptr<const CObstacleInstance> > &obstacles)
+void CBattleInterface::showObstacles(SDL_Surface *to, const std::vector<std::shared_ptr<const CObstacleInstance> > &obstacles)
 {
 	for (auto & obstacle : obstacles)
 	{
@@ -3466,7 +3488,34 @@ void CBattleInterface::showInterface(SDL_Surface *to)
 	}
 }
 
-BattleObjectsByHex CBattleInterface::sortObjectsByHex()
+void CBattleInterface::sortObjectsByHex()
+{
+	BattleObjectsByHex & sorted = sceneObjects;
+
+	// walls, obstacles and standing stacks stay in place, only effects change every frame
+	sorted.beforeAll.effects.clear();
+	sorted.afterAll.effects.clear();
+	for (auto & data : sorted.hex)
+		data.effects.clear();
+
+	if (!staticObjectsValid)
+		placeStaticObjects();
+
+	// stacks change their place or state only during animations
+	if (!stackObjectsValid || !pendingAnims.empty())
+		placeStacks();
+
+	// Sort battle effects (spells)
+	for (auto & battleEffect : battleEffects)
+	{
+		if (battleEffect.position.isValid())
+			sorted.hex[battleEffect.position].effects.push_back(&battleEffect);
+		else
+			sorted.afterAll.effects.push_back(&battleEffect);
+	}
+}
+
+void CBattleInterface::placeStacks()
 {
 	auto getCurrentPosition = [&](const CStack *stack) -> BattleHex
 	{
@@ -3485,16 +3534,35 @@ BattleObjectsByHex CBattleInterface::sortObjectsByHex()
 		return stack->position;
 	};
 
-	BattleObjectsByHex sorted;
+	BattleObjectsByHex & sorted = sceneObjects;
+
+	auto clearStacks = [](BattleObjectsByHex::HexData & data)
+	{
+		data.dead.clear();
+		data.alive.clear();
+	};
+	clearStacks(sorted.beforeAll);
+	clearStacks(sorted.afterAll);
+	for (auto & data : sorted.hex)
+		clearStacks(data);
+
+	turrets.clear();
 
-	auto stacks = curInt->cb->battleGetStacksIf([](const CStack *s)
+	auto stacks = curInt->cb->battleGetStacksIf([](const CStack *)
 	{
-		return !s->isTurret();
+		return true;
 	});
 
 	// Sort creatures
 	for (auto & stack : stacks)
 	{
+		if (stack->isTurret())
+		{
+			if (!stack->isGhost())
+				turrets[stack->position] = stack;
+			continue;
+		}
+
 		if (creAnims.find(stack->ID) == creAnims.end()) //e.g. for summoned but not yet handled stacks
 			continue;
 
@@ -3521,14 +3589,29 @@ BattleObjectsByHex CBattleInterface::sortObjectsByHex()
 			sorted.hex[stack->position].dead.push_back(stack);
 	}
 
-	// Sort battle effects (spells)
-	for (auto & battleEffect : battleEffects)
+	// sorted again after last frame of animation
+	stackObjectsValid = pendingAnims.empty();
+}
+
+void CBattleInterface::stacksChanged()
+{
+	staticObjectsValid = false;
+	stackObjectsValid = false;
+}
+
+void CBattleInterface::placeStaticObjects()
+{
+	BattleObjectsByHex & sorted = sceneObjects;
+
+	auto clearStatic = [](BattleObjectsByHex::HexData & data)
 	{
-		if (battleEffect.position.isValid())
-			sorted.hex[battleEffect.position].effects.push_back(&battleEffect);
-		else
-			sorted.afterAll.effects.push_back(&battleEffect);
-	}
+		data.walls.clear();
+		data.obstacles.clear();
+	};
+	clearStatic(sorted.beforeAll);
+	clearStatic(sorted.afterAll);
+	for (auto & data : sorted.hex)
+		clearStatic(data);
 
 	// Sort obstacles
 	{
@@ -3572,7 +3655,7 @@ BattleObjectsByHex CBattleInterface::sortObjectsByHex()
 			sorted.beforeAll.walls.push_back(SiegeHelper::UPPER_BATTLEMENT);
 		}
 	}
-	return sorted;
+	staticObjectsValid = true;
 }
 
 void CBattleInterface::updateBattleAnimations()
@@ -3663,6 +3746,7 @@ Point CBattleInterface::getObstaclePosition(SDL_Surface *image, const CObstacleI
 
 void CBattleInterface::redrawBackgroundWithHexes(const CStack *activeStack)
 {
+	staticObjectsValid = false; //obstacles may have been removed
 	attackableHexes.clear();
 	if (activeStack)
 		occupyableHexes = curInt->cb->battleGetAvailableHexes(activeStack, true, &attackableHexes);
@@ -3697,7 +3781,7 @@ void CBattleInterface::redrawBackgroundWithHexes(const CStack *activeStack)
 		CSDL_Ext::blit8bppAlphaTo24bpp(cellBorders, nullptr, backgroundWithHexes, nullptr);
 }
 
-void CBattleInterface::showPiecesOfWall(SDL_Surface *to, std::vector<int> pieces)
+void CBattleInterface::showPiecesOfWall(SDL_Surface *to, const std::vector<int> & pieces)
 {
 	if (!siegeH)
 		return;
@@ -3713,22 +3797,11 @@ void CBattleInterface::showPiecesOfWall(SDL_Surface *to, std::vector<int> pieces
 			// 17 = upper, -4
 
 			// tower. check if tower is alive - stack is found
-			int stackPos = 13 - piece;
-
-			const CStack *turret = nullptr;
-
-			for (auto & stack : curInt->cb->battleGetAllStacks(true))
-			{
-				if (stack->position == stackPos)
-				{
-					turret = stack;
-					break;
-				}
-			}
+			auto turret = turrets.find(BattleHex(13 - piece));
 
-			if (turret)
+			if (turret != turrets.end())
 			{
-				std::vector<const CStack *> stackList(1, turret);
+				std::vector<const CStack *> stackList(1, turret->second);
 				showStacks(to, stackList);
 				siegeH->printPartOfWall(to, piece);
 			}
@@ -191,6 +191,12 @@ private:
 
 	std::list<BattleEffect> battleEffects; //different animations to display on the screen like spell effects
 
+	BattleObjectsByHex sceneObjects; //kept between frames, only effects are placed again every frame
+	bool staticObjectsValid; //if false, walls and obstacles in sceneObjects have to be placed again
+	bool stackObjectsValid; //if false, stacks in sceneObjects have to be sorted again
+	std::map<BattleHex, const CStack *> turrets; //alive turrets by their position, updated with sceneObjects
+	std::map<int, bool> siegeWeaponStacks; //<stack ID, is siege weapon> - does not change during battle
+
 	/// Class which is responsible for drawing the wall of a siege during battle
 	class SiegeHelper
 	{
@@ -248,15 +254,18 @@ private:
 
 	void showBattlefieldObjects(SDL_Surface *to);
 
-	void showAliveStacks(SDL_Surface *to, std::vector<const CStack *> stacks);
-	void showStacks(SDL_Surface *to, std::vector<const CStack *> stacks);
-	void showObstacles(SDL_Surface *to, std::vector<std::shared_ptr<const CObstacleInstance>> &obstacles);
-	void showPiecesOfWall(SDL_Surface *to, std::vector<int> pieces);
+	void showAliveStacks(SDL_Surface *to, const std::vector<const CStack *> & stacks);
+	void showStacks(SDL_Surface *to, const std::vector<const CStack *> & stacks);
+	void showObstacles(SDL_Surface *to, const std::vector<std::shared_ptr<const CObstacleInstance>> &obstacles);
+	void showPiecesOfWall(SDL_Surface *to, const std::vector<int> & pieces);
 
 	void showBattleEffects(SDL_Surface *to, const std::vector<const BattleEffect *> &battleEffects);
 	void showProjectiles(SDL_Surface *to);
 
-	BattleObjectsByHex sortObjectsByHex();
+	void sortObjectsByHex(); //updates sceneObjects for current frame
+	void placeStaticObjects(); //walls and obstacles
+	void placeStacks();
+	void stacksChanged(); //stacks moved, died or appeared - they and obstacles visible to player have to be placed again
 	void updateBattleAnimations();
 
 	SDL_Surface *getObstacleImage(const CObstacleInstance &oi);
@@ -11,16 +11,20 @@
 #include "CAnimation.h"
 
 #include <SDL_image.h>
+#include <boost/lockfree/queue.hpp>
 
 #include "../CBitmapHandler.h"
 #include "../Graphics.h"
 #include "../gui/SDL_Extensions.h"
 #include "../gui/SDL_Pixels.h"
+#include "../gui/PalettedBlitter.h"
 
 #include "../lib/filesystem/Filesystem.h"
+#include "../lib/filesystem/CMappedFile.h"
 #include "../lib/filesystem/ISimpleResourceLoader.h"
 #include "../lib/JsonNode.h"
 #include "../lib/CRandomGenerator.h"
+#include "../lib/CThreadHelper.h"
 
 class SDLImageLoader;
 class CompImageLoader;
@@ -49,7 +53,10 @@ private:
 	//offset[group][frame] - offset of frame data in file
 	std::map<size_t, std::vector <size_t> > offset;
 
-	std::unique_ptr<ui8[]>       data;
+	std::unique_ptr<CInputStream> stream; //kept open while data points into memory-mapped archive
+	std::unique_ptr<ui8[]>       ownedData;
+	const ui8 *                  data;
+	size_t                       dataSize;
 	std::unique_ptr<SDL_Color[]> palette;
 
 public:
@@ -61,6 +68,9 @@ public:
 	void loadFrame(size_t frame, size_t group, ImageLoader &loader) const;
 
 	const std::map<size_t, size_t> getEntries() const;
+
+	//size of raw file data in bytes
+	size_t getSize() const;
 };
 
 
@@ -79,7 +89,7 @@ public:
 
 public:
 	//Load image from def file
-	SDLImage(CDefFile *data, size_t frame, size_t group=0, bool compressed=false);
+	SDLImage(const CDefFile *data, size_t frame, size_t group=0, bool compressed=false);
 	//Load from bitmap file
 	SDLImage(std::string filename, bool compressed=false);
 
@@ -91,6 +101,7 @@ public:
 	void draw(SDL_Surface * where, int posX=0, int posY=0, Rect *src=nullptr, ui8 alpha=255) const override;
 	void draw(SDL_Surface * where, SDL_Rect * dest, SDL_Rect * src, ui8 alpha=255) const override;
 	std::unique_ptr<IImage> scaleFast(float scale) const override;
+	std::unique_ptr<IImage> clone() const override;
 	void exportBitmap(const boost::filesystem::path & path) const override;
 	void playerColored(PlayerColor player) override;
 	void setFlagColor(PlayerColor player) override;
@@ -133,10 +144,20 @@ class CompImage : public IImage
 	//palette
 	SDL_Color *palette;
 
+	//owners of RLE-d data and line offsets, which are never changed after loading and are shared with clones
+	std::shared_ptr<ui8> surfOwner;
+	std::shared_ptr<ui32> lineOwner;
+
+	//palette converted to 32 bpp format, created on first draw and reset when palette changes
+	mutable std::unique_ptr<PalettedBlitter> blitter;
+
+	CompImage();
+
 	//Used internally to blit one block of data
 	template<int bpp, int dir>
 	void BlitBlock(ui8 type, ui8 size, ui8 *&data, ui8 *&dest, ui8 alpha) const;
 	void BlitBlockWithBpp(ui8 bpp, ui8 type, ui8 size, ui8 *&data, ui8 *&dest, ui8 alpha, bool rotated) const;
+	void BlitBlock32(ui8 type, ui8 size, ui8 *&data, ui8 *&dest) const;
 
 public:
 	//Load image from def file
@@ -149,6 +170,10 @@ public:
 	void draw(SDL_Surface * where, SDL_Rect * dest, SDL_Rect * src, ui8 alpha=255) const override;
 
 	std::unique_ptr<IImage> scaleFast(float scale) const override;
+	std::unique_ptr<IImage> clone() const override;
+
+	//size of RLE-d data in bytes
+	size_t dataSize() const;
 
 	void exportBitmap(const boost::filesystem::path & path) const override;
 
@@ -208,50 +233,161 @@ public:
 	~CompImageLoader();
 };
 
-// Extremely simple file cache. TODO: smarter, more general solution
-class CFileCache
+/// Cache with limited memory budget, evicts least recently used entries once budget is exceeded
+template<typename Key, typename Value>
+class CLRUCache
 {
-	static const int cacheSize = 50; //Max number of cached files
-	struct FileData
+	struct Entry
 	{
-		ResourceID             name;
-		size_t                 size;
-		std::unique_ptr<ui8[]> data;
+		Key key;
+		Value value;
+		size_t size;
+	};
+
+	typedef std::list<Entry> TEntries;
 
-		std::unique_ptr<ui8[]> getCopy()
+	//most recently used entries are at front
+	TEntries entries;
+	std::unordered_map<Key, typename TEntries::iterator> index;
+
+	const size_t budget;
+	size_t usedBytes;
+
+public:
+	ui64 hits;
+	ui64 misses;
+
+	CLRUCache(size_t budget):
+		budget(budget),
+		usedBytes(0),
+		hits(0),
+		misses(0)
+	{}
+
+	//returns cached value and marks it as recently used, nullptr on cache miss
+	const Value * find(const Key & key)
+	{
+		auto iter = index.find(key);
+		if(iter == index.end())
 		{
-			auto ret = std::unique_ptr<ui8[]>(new ui8[size]);
-			std::copy(data.get(), data.get() + size, ret.get());
-			return ret;
+			misses++;
+			return nullptr;
 		}
-		FileData(ResourceID name_, size_t size_, std::unique_ptr<ui8[]> data_):
-			name{std::move(name_)},
-			size{size_},
-			data{std::move(data_)}
-		{}
-	};
+		hits++;
+		entries.splice(entries.begin(), entries, iter->second);
+		return &iter->second->value;
+	}
 
-	std::deque<FileData> cache;
-public:
-	std::unique_ptr<ui8[]> getCachedFile(ResourceID rid)
+	void insert(const Key & key, Value value, size_t size)
 	{
-		for(auto & file : cache)
+		auto iter = index.find(key);
+		if(iter != index.end())
 		{
-			if (file.name == rid)
-				return file.getCopy();
+			usedBytes -= iter->second->size;
+			entries.erase(iter->second);
+			index.erase(iter);
 		}
-		// Still here? Cache miss
-		if (cache.size() > cacheSize)
-			cache.pop_front();
 
-		auto data =  CResourceHandler::get()->load(rid)->readAll();
+		entries.push_front(Entry{key, std::move(value), size});
+		index[key] = entries.begin();
+		usedBytes += size;
 
-		cache.emplace_back(std::move(rid), data.second, std::move(data.first));
+		//always keep at least newly added entry, even if it alone exceeds the budget
+		while(usedBytes > budget && entries.size() > 1)
+		{
+			usedBytes -= entries.back().size;
+			index.erase(entries.back().key);
+			entries.pop_back();
+		}
+	}
 
-		return cache.back().getCopy();
+	bool contains(const Key & key) const
+	{
+		return index.count(key) != 0;
+	}
+
+	size_t size() const
+	{
+		return usedBytes;
 	}
 };
 
+/// Two-tier cache for animations: parsed def files (raw data with frame tables) and decoded frames
+/// Decoded frames are stored in pristine state, each request receives its own copy that can be modified freely
+class CAnimationCache
+{
+	static const size_t defFilesBudget = 32 * 1024 * 1024;
+	static const size_t framesBudget = 32 * 1024 * 1024;
+
+	boost::mutex mx;
+	CLRUCache<ResourceID, std::shared_ptr<const CDefFile>> defFiles;
+	CLRUCache<std::string, std::shared_ptr<const IImage>> frames;
+
+public:
+	CAnimationCache():
+		defFiles(defFilesBudget),
+		frames(framesBudget)
+	{}
+
+	std::shared_ptr<const CDefFile> getDefFile(const std::string & name);
+
+	IImage * loadFrame(const std::string & name, const CDefFile & defFile, size_t frame, size_t group, bool compressed);
+
+	//decodes frame without touching the cache, returns image and its size in bytes
+	static std::pair<std::shared_ptr<const IImage>, size_t> decodeFrame(const CDefFile & defFile, size_t frame, size_t group, bool compressed);
+	static std::string frameKey(const std::string & name, size_t frame, size_t group, bool compressed);
+
+	//checks presence of frame without affecting hit/miss counters or LRU order
+	bool hasFrame(const std::string & key);
+	void addFrame(const std::string & key, std::shared_ptr<const IImage> image, size_t size);
+
+	AnimationCacheStats getStats();
+};
+
+/// Decodes frames of requested animations on background threads
+/// Decoded frames are handed back through lock-free queue and moved into the cache by the thread that loads frames
+class CAnimationPrefetcher
+{
+	struct Task
+	{
+		std::string name;
+		std::vector<size_t> groups;
+		bool compressed;
+	};
+
+	struct DecodedFrame
+	{
+		std::string key;
+		std::shared_ptr<const IImage> image;
+		size_t size;
+	};
+
+	//workers stop decoding while frames of this total size are waiting for collect()
+	static const size_t maxDecodedBytes = 8 * 1024 * 1024;
+
+	boost::mutex mx;
+	boost::condition_variable cond;
+	boost::condition_variable collected;
+	std::deque<Task> tasks;
+	std::atomic<bool> terminating;
+	boost::thread_group workers;
+
+	boost::lockfree::queue<DecodedFrame *> decoded;
+	std::atomic<size_t> decodedBytes;
+
+	void runWorker();
+	void processTask(const Task & task);
+
+public:
+	CAnimationPrefetcher();
+	~CAnimationPrefetcher();
+
+	void schedule(const std::string & name, const std::vector<size_t> & groups, bool compressed);
+
+	//moves all frames decoded so far into the cache
+	void collect();
+};
+
 enum class DefType : uint32_t
 {
 	SPELL = 0x40,
@@ -266,7 +402,8 @@ enum class DefType : uint32_t
 	BATTLE_HERO = 0x49
 };
 
-static CFileCache animationCache;
+static CAnimationCache animationCache;
+static CAnimationPrefetcher animationPrefetcher;
 
 /*************************************************************************
  *  DefFile, class used for def loading                                  *
@@ -279,6 +416,7 @@ bool operator== (const SDL_Color & lhs, const SDL_Color & rhs)
 
 CDefFile::CDefFile(std::string Name):
 	data(nullptr),
+	dataSize(0),
 	palette(nullptr)
 {
 
@@ -308,17 +446,30 @@ CDefFile::CDefFile(std::string Name):
 		{   0,   0,   0, 128},//  50% - shadow body   below selection
 		{   0,   0,   0,  64} // 75% - shadow border below selection
 	};
-	data = animationCache.getCachedFile(ResourceID(std::string("SPRITES/") + Name, EResType::ANIMATION));
+	stream = CResourceHandler::get()->load(ResourceID(std::string("SPRITES/") + Name, EResType::ANIMATION));
+	if(auto mapped = dynamic_cast<CMappedFileStream *>(stream.get()))
+	{
+		data = mapped->getData();
+		dataSize = mapped->getSize();
+	}
+	else
+	{
+		auto file = stream->readAll();
+		ownedData = std::move(file.first);
+		data = ownedData.get();
+		dataSize = file.second;
+		stream.reset();
+	}
 
 	palette = std::unique_ptr<SDL_Color[]>(new SDL_Color[256]);
 	int it = 0;
 
-	ui32 type = read_le_u32(data.get() + it);
+	ui32 type = read_le_u32(data + it);
 	it+=4;
 	//int width  = read_le_u32(data + it); it+=4;//not used
 	//int height = read_le_u32(data + it); it+=4;
 	it+=8;
-	ui32 totalBlocks = read_le_u32(data.get() + it);
+	ui32 totalBlocks = read_le_u32(data + it);
 	it+=4;
 
 	for (ui32 i= 0; i<256; i++)
@@ -384,9 +535,9 @@ CDefFile::CDefFile(std::string Name):
 
 	for (ui32 i=0; i<totalBlocks; i++)
 	{
-		size_t blockID = read_le_u32(data.get() + it);
+		size_t blockID = read_le_u32(data + it);
 		it+=4;
-		size_t totalEntries = read_le_u32(data.get() + it);
+		size_t totalEntries = read_le_u32(data + it);
 		it+=12;
 		//8 unknown bytes - skipping
 
@@ -395,7 +546,7 @@ CDefFile::CDefFile(std::string Name):
 
 		for (ui32 j=0; j<totalEntries; j++)
 		{
-			size_t currOffset = read_le_u32(data.get() + it);
+			size_t currOffset = read_le_u32(data + it);
 			offset[blockID].push_back(currOffset);
 			it += 4;
 		}
@@ -409,7 +560,7 @@ void CDefFile::loadFrame(size_t frame, size_t group, ImageLoader &loader) const
 	it = offset.find(group);
 	assert (it != offset.end());
 
-	const ui8 * FDef = data.get()+it->second[frame];
+	const ui8 * FDef = data+it->second[frame];
 
 	const SSpriteDef sd = * reinterpret_cast<const SSpriteDef *>(FDef);
 	SSpriteDef sprite;
@@ -549,6 +700,220 @@ const std::map<size_t, size_t > CDefFile::getEntries() const
 	return ret;
 }
 
+size_t CDefFile::getSize() const
+{
+	return dataSize;
+}
+
+/*************************************************************************
+ *  CAnimationCache, shared by all animations                            *
+ *************************************************************************/
+
+std::shared_ptr<const CDefFile> CAnimationCache::getDefFile(const std::string & name)
+{
+	ResourceID resource(std::string("SPRITES/") + name, EResType::ANIMATION);
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		if(auto cached = defFiles.find(resource))
+			return *cached;
+	}
+
+	//parse outside of lock, other threads may request other files meanwhile
+	auto ret = std::make_shared<const CDefFile>(name);
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	defFiles.insert(resource, ret, ret->getSize());
+	return ret;
+}
+
+IImage * CAnimationCache::loadFrame(const std::string & name, const CDefFile & defFile, size_t frame, size_t group, bool compressed)
+{
+	animationPrefetcher.collect();
+
+	std::string key = frameKey(name, frame, group, compressed);
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		if(auto cached = frames.find(key))
+			return (*cached)->clone().release();
+	}
+
+	auto decoded = decodeFrame(defFile, frame, group, compressed);
+	addFrame(key, decoded.first, decoded.second);
+	return decoded.first->clone().release();
+}
+
+std::pair<std::shared_ptr<const IImage>, size_t> CAnimationCache::decodeFrame(const CDefFile & defFile, size_t frame, size_t group, bool compressed)
+{
+	if(compressed)
+	{
+		auto image = std::make_shared<const CompImage>(&defFile, frame, group);
+		return std::make_pair(image, image->dataSize());
+	}
+	else
+	{
+		auto image = std::make_shared<const SDLImage>(&defFile, frame, group);
+		return std::make_pair(image, size_t(image->surf->pitch * image->surf->h));
+	}
+}
+
+std::string CAnimationCache::frameKey(const std::string & name, size_t frame, size_t group, bool compressed)
+{
+	return boost::str(boost::format("%s:%d:%d:%d") % name % group % frame % compressed);
+}
+
+bool CAnimationCache::hasFrame(const std::string & key)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return frames.contains(key);
+}
+
+void CAnimationCache::addFrame(const std::string & key, std::shared_ptr<const IImage> image, size_t size)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	frames.insert(key, std::move(image), size);
+}
+
+CAnimationPrefetcher::CAnimationPrefetcher():
+	terminating(false),
+	decoded(128),
+	decodedBytes(0)
+{
+}
+
+CAnimationPrefetcher::~CAnimationPrefetcher()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		terminating = true;
+		tasks.clear();
+	}
+	cond.notify_all();
+	collected.notify_all();
+	workers.join_all();
+
+	DecodedFrame * frame;
+	while(decoded.pop(frame))
+		delete frame;
+}
+
+void CAnimationPrefetcher::schedule(const std::string & name, const std::vector<size_t> & groups, bool compressed)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	//threads are started on first request, leaving one core for GUI thread
+	if(workers.size() == 0)
+	{
+		unsigned threads = boost::thread::hardware_concurrency();
+		vstd::amax(threads, 2);
+		for(unsigned i = 0; i < threads - 1; i++)
+			workers.create_thread(std::bind(&CAnimationPrefetcher::runWorker, this));
+	}
+
+	tasks.push_back(Task{name, groups, compressed});
+	cond.notify_one();
+}
+
+void CAnimationPrefetcher::collect()
+{
+	size_t collectedBytes = 0;
+	DecodedFrame * frame;
+	while(decoded.pop(frame))
+	{
+		collectedBytes += frame->size;
+		animationCache.addFrame(frame->key, std::move(frame->image), frame->size);
+		delete frame;
+	}
+
+	if(collectedBytes != 0)
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		decodedBytes -= collectedBytes;
+		collected.notify_all();
+	}
+}
+
+void CAnimationPrefetcher::runWorker()
+{
+	setThreadName("CAnimationPrefetcher::runWorker");
+
+	while(true)
+	{
+		Task task;
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			while(tasks.empty() && !terminating)
+				cond.wait(lock);
+
+			if(terminating)
+				return;
+
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+
+		try
+		{
+			processTask(task);
+		}
+		catch(const std::exception & e)
+		{
+			logAnim->error("Failed to prefetch animation %s: %s", task.name, e.what());
+		}
+	}
+}
+
+void CAnimationPrefetcher::processTask(const Task & task)
+{
+	if(!CResourceHandler::get()->existsResource(ResourceID(std::string("SPRITES/") + task.name, EResType::ANIMATION)))
+		return;
+
+	auto defFile = animationCache.getDefFile(task.name);
+
+	for(auto & entry : defFile->getEntries())
+	{
+		if(!task.groups.empty() && !vstd::contains(task.groups, entry.first))
+			continue;
+
+		for(size_t frame = 0; frame < entry.second; frame++)
+		{
+			if(terminating)
+				return;
+
+			//frame was already requested by GUI or prefetched earlier
+			std::string key = CAnimationCache::frameKey(task.name, frame, entry.first, task.compressed);
+			if(animationCache.hasFrame(key))
+				continue;
+
+			{
+				boost::unique_lock<boost::mutex> lock(mx);
+				while(decodedBytes >= maxDecodedBytes && !terminating)
+					collected.wait(lock);
+			}
+
+			if(terminating)
+				return;
+
+			auto image = CAnimationCache::decodeFrame(*defFile, frame, entry.first, task.compressed);
+			decodedBytes += image.second;
+			decoded.push(new DecodedFrame{key, image.first, image.second});
+		}
+	}
+}
+
+AnimationCacheStats CAnimationCache::getStats()
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	AnimationCacheStats ret;
+	ret.fileHits = defFiles.hits;
+	ret.fileMisses = defFiles.misses;
+	ret.fileBytes = defFiles.size();
+	ret.frameHits = frames.hits;
+	ret.frameMisses = frames.misses;
+	ret.frameBytes = frames.size();
+	return ret;
+}
+
 /*************************************************************************
  *  Classes for image loaders - helpers for loading from def files       *
  *************************************************************************/
@@ -782,6 +1147,9 @@ CompImageLoader::~CompImageLoader()
 	ui8* newPtr = (ui8*)realloc((void*)image->surf, position - image->surf);
 	if (newPtr)
 		image->surf = newPtr;
+
+	image->surfOwner.reset(image->surf, free);
+	image->lineOwner.reset(image->line, std::default_delete<ui32[]>());
 }
 
 /*************************************************************************
@@ -805,7 +1173,7 @@ void IImage::increaseRef()
 	refCount++;
 }
 
-SDLImage::SDLImage(CDefFile * data, size_t frame, size_t group, bool compressed)
+SDLImage::SDLImage(const CDefFile * data, size_t frame, size_t group, bool compressed)
 	: surf(nullptr),
 	margins(0, 0),
 	fullSize(0, 0)
@@ -820,6 +1188,8 @@ SDLImage::SDLImage(SDL_Surface * from, bool extraRef)
 	fullSize(0, 0)
 {
 	surf = from;
+	if (surf == nullptr)
+		return;
 	if (extraRef)
 		surf->refcount++;
 	fullSize.x = surf->w;
@@ -966,6 +1336,34 @@ std::unique_ptr<IImage> SDLImage::scaleFast(float scale) const
 	return std::unique_ptr<IImage>(ret);
 }
 
+std::unique_ptr<IImage> SDLImage::clone() const
+{
+	SDL_Surface * copy = nullptr;
+
+	if(surf && surf->format->palette)
+	{
+		//copy manually - blitting would skip color-keyed pixels
+		copy = SDL_CreateRGBSurface(SDL_SWSURFACE, surf->w, surf->h, 8, 0, 0, 0, 0);
+		SDL_SetPaletteColors(copy->format->palette, surf->format->palette->colors, 0, surf->format->palette->ncolors);
+
+		Uint32 colorKey;
+		if(SDL_GetColorKey(surf, &colorKey) == 0)
+			SDL_SetColorKey(copy, SDL_TRUE, colorKey);
+
+		for(int y = 0; y < surf->h; y++)
+			memcpy((ui8 *)copy->pixels + y * copy->pitch, (ui8 *)surf->pixels + y * surf->pitch, surf->w);
+	}
+	else if(surf)
+	{
+		copy = SDL_ConvertSurface(surf, surf->format, surf->flags);
+	}
+
+	SDLImage * ret = new SDLImage(copy, false);
+	ret->margins = margins;
+	ret->fullSize = fullSize;
+	return std::unique_ptr<IImage>(ret);
+}
+
 void SDLImage::exportBitmap(const boost::filesystem::path& path) const
 {
 	SDL_SaveBMP(surf, path.string().c_str());
@@ -1058,6 +1456,39 @@ CompImage::CompImage(SDL_Surface * surf)
 	assert(0);
 }
 
+CompImage::CompImage():
+	surf(nullptr),
+	line(nullptr),
+	palette(nullptr)
+{
+}
+
+std::unique_ptr<IImage> CompImage::clone() const
+{
+	//only palette can be changed (by player colouring), RLE-d data is shared
+	std::unique_ptr<CompImage> ret(new CompImage());
+	ret->sprite = sprite;
+	ret->fullSize = fullSize;
+	ret->surf = surf;
+	ret->line = line;
+	ret->surfOwner = surfOwner;
+	ret->lineOwner = lineOwner;
+
+	if(palette)
+	{
+		ret->palette = new SDL_Color[256];
+		std::copy(palette, palette + 256, ret->palette);
+	}
+	return std::move(ret);
+}
+
+size_t CompImage::dataSize() const
+{
+	if(!surf)
+		return 0;
+	return line[sprite.h];
+}
+
 void CompImage::draw(SDL_Surface *where, int posX, int posY, Rect *src, ui8 alpha) const
 {
 	Rect dest(posX,posY, width(), height());
@@ -1094,6 +1525,9 @@ void CompImage::draw(SDL_Surface* where, SDL_Rect* dest, SDL_Rect* src, ui8 alph
 
 	sourceRect -= sprite.topLeft();
 
+	if (where->format->BytesPerPixel == 4 && alpha == 255 && !blitter)
+		blitter.reset(new PalettedBlitter(palette));
+
 	for (int currY = 0; currY <sourceRect.h; currY++)
 	{
 		ui8* data = surf + line[currY+sourceRect.y];
@@ -1159,6 +1593,12 @@ void CompImage::BlitBlockWithBpp(ui8 bpp, ui8 type, ui8 size, ui8 *&data, ui8 *&
 {
 	assert(bpp>1 && bpp<5);
 
+	if (bpp == 4 && alpha == 255)
+	{
+		BlitBlock32(type, size, data, dest);
+		return;
+	}
+
 	if (rotated)
 		switch (bpp)
 		{
@@ -1176,6 +1616,25 @@ void CompImage::BlitBlockWithBpp(ui8 bpp, ui8 type, ui8 size, ui8 *&data, ui8 *&
 }
 #undef CASEBPP
 
+//Blit one block to 32 bpp surface without per-surface alpha, whole block is processed by vector kernels
+void CompImage::BlitBlock32(ui8 type, ui8 size, ui8 *&data, ui8 *&dest) const
+{
+	//Raw data
+	if (type == 0xff)
+	{
+		if (palette[*data].a == 255)
+			blitter->copyRow(data, dest, size);
+		else
+			blitter->blitRow(data, dest, size);
+		data += size;
+	}
+	//RLE-d sequence
+	else
+		blitter->fillRow(type, dest, size);
+
+	dest += size*4;
+}
+
 //Blit one block from RLE-d surface
 template<int bpp, int dir>
 void CompImage::BlitBlock(ui8 type, ui8 size, ui8 *&data, ui8 *&dest, ui8 alpha) const
@@ -1264,6 +1723,7 @@ void CompImage::playerColored(PlayerColor player)
 	{
 		CSDL_Ext::colorAssign(palette[224+i],pal[i]);
 	}
+	blitter.reset();
 }
 
 void CompImage::setFlagColor(PlayerColor player)
@@ -1283,8 +1743,6 @@ int CompImage::height() const
 
 CompImage::~CompImage()
 {
-	free(surf);
-	delete [] line;
 	delete [] palette;
 }
 
@@ -1364,10 +1822,7 @@ bool CAnimation::loadFrame(size_t frame, size_t group)
 
 			if(vstd::contains(frameList, group) && frameList.at(group) > frame) // frame is present
 			{
-				if(compressed)
-					images[group][frame] = new CompImage(defFile, frame, group);
-				else
-					images[group][frame] = new SDLImage(defFile, frame, group);
+				images[group][frame] = animationCache.loadFrame(name, *defFile, frame, group, compressed);
 				return true;
 			}
 		}
@@ -1512,21 +1967,25 @@ void CAnimation::printError(size_t frame, size_t group, std::string type) const
 	logGlobal->error("%s error: Request for frame not present in CAnimation! File name: %s, Group: %d, Frame: %d", type, name, group, frame);
 }
 
-CAnimation::CAnimation(std::string Name, bool Compressed):
-	name(Name),
-	compressed(Compressed),
-	preloaded(false),
-	defFile(nullptr)
+static std::string normalizeAnimationName(std::string name)
 {
 	size_t dotPos = name.find_last_of('.');
 	if ( dotPos!=-1 )
 		name.erase(dotPos);
 	std::transform(name.begin(), name.end(), name.begin(), toupper);
+	return name;
+}
 
+CAnimation::CAnimation(std::string Name, bool Compressed):
+	name(normalizeAnimationName(Name)),
+	compressed(Compressed),
+	preloaded(false),
+	defFile(nullptr)
+{
 	ResourceID resource(std::string("SPRITES/") + name, EResType::ANIMATION);
 
 	if(CResourceHandler::get()->existsResource(resource))
-		defFile = new CDefFile(name);
+		defFile = animationCache.getDefFile(name);
 
 	init();
 
@@ -1555,8 +2014,6 @@ CAnimation::~CAnimation()
 			for (auto & _image : elem.second)
 				delete _image.second;
 	}
-	if(defFile)
-		delete defFile;
 }
 
 void CAnimation::duplicateImage(const size_t sourceGroup, const size_t sourceFrame, const size_t targetGroup)
@@ -1648,6 +2105,16 @@ void CAnimation::unload(size_t frame, size_t group)
 	unloadFrame(frame, group);
 }
 
+void CAnimation::prefetch(const std::string & name, const std::vector<size_t> & groups, bool compressed)
+{
+	animationPrefetcher.schedule(normalizeAnimationName(name), groups, compressed);
+}
+
+AnimationCacheStats CAnimation::getCacheStats()
+{
+	return animationCache.getStats();
+}
+
 size_t CAnimation::size(size_t group) const
 {
 	auto iter = source.find(group);
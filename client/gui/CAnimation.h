@@ -32,6 +32,9 @@ public:
 
 	virtual std::unique_ptr<IImage> scaleFast(float scale) const = 0;
 
+	//creates independent copy of this image with reference count of 1
+	virtual std::unique_ptr<IImage> clone() const = 0;
+
 	virtual void exportBitmap(const boost::filesystem::path & path) const = 0;
 
 	//decrease ref count, returns true if image can be deleted (refCount <= 0)
@@ -60,6 +63,20 @@ public:
 	virtual ~IImage() {};
 };
 
+/// Hit and miss counters of caches shared by all animations
+struct AnimationCacheStats
+{
+	//parsed def files
+	ui64 fileHits;
+	ui64 fileMisses;
+	size_t fileBytes;
+
+	//decoded frames
+	ui64 frameHits;
+	ui64 frameMisses;
+	size_t frameBytes;
+};
+
 /// Class for handling animation
 class CAnimation
 {
@@ -78,7 +95,7 @@ private:
 
 	bool preloaded;
 
-	CDefFile * defFile;
+	std::shared_ptr<const CDefFile> defFile;
 
 	//loader, will be called by load(), require opened def file for loading from it. Returns true if image is loaded
 	bool loadFrame(size_t frame, size_t group);
@@ -135,6 +152,12 @@ public:
 	void playerColored(PlayerColor player);
 
 	void createFlippedGroup(const size_t sourceGroup, const size_t targetGroup);
+
+	//schedules decoding of frames from selected groups (all groups if empty) on background threads
+	//frames that are requested before they are decoded will be loaded synchronously as usual
+	static void prefetch(const std::string & name, const std::vector<size_t> & groups = std::vector<size_t>(), bool compressed = false);
+
+	static AnimationCacheStats getCacheStats();
 };
 
 const float DEFAULT_DELTA = 0.05f;
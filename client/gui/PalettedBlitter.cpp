@@ -0,0 +1,325 @@
+/*
+ * PalettedBlitter.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "PalettedBlitter.h"
+
+#include "SDL_Pixels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VCMI_BLIT_SSE2
+	#include <emmintrin.h>
+#endif
+
+// AVX2 kernel is compiled for the function only, rest of the client keeps baseline instruction set
+#if defined(VCMI_BLIT_SSE2) && (defined(__GNUC__) || defined(_MSC_VER))
+	#define VCMI_BLIT_AVX2
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define VCMI_AVX2_TARGET
+	#else
+		#define VCMI_AVX2_TARGET __attribute__((target("avx2")))
+	#endif
+#endif
+
+static bool cpuSupportsAVX2()
+{
+#if !defined(VCMI_BLIT_AVX2)
+	return false;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if(info[0] < 7)
+		return false;
+
+	//AVX has to be enabled by OS as well, it saves YMM registers on context switch
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if(!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static PalettedBlitter::EKernel detectKernel()
+{
+	if(cpuSupportsAVX2())
+		return PalettedBlitter::EKernel::AVX2;
+#ifdef VCMI_BLIT_SSE2
+	return PalettedBlitter::EKernel::SSE2;
+#else
+	return PalettedBlitter::EKernel::SCALAR;
+#endif
+}
+
+static std::atomic<PalettedBlitter::EKernel> & currentKernel()
+{
+	static std::atomic<PalettedBlitter::EKernel> kernel(detectKernel());
+	return kernel;
+}
+
+PalettedBlitter::PalettedBlitter(const SDL_Color * colors):
+	colors(colors)
+{
+	for(int i = 0; i < 256; i++)
+	{
+		Uint8 * ptr = reinterpret_cast<Uint8 *>(&opaque[i]);
+		ColorPutter<4, 0>::PutColor(ptr, colors[i].r, colors[i].g, colors[i].b);
+		alpha[i] = colors[i].a;
+	}
+	alphaMask = 0;
+	Channels::px<4>::a.set(reinterpret_cast<Uint8 *>(&alphaMask), 255);
+}
+
+PalettedBlitter::EKernel PalettedBlitter::getKernel()
+{
+	return currentKernel();
+}
+
+bool PalettedBlitter::setKernel(EKernel kernel)
+{
+	if(!isSupported(kernel))
+		return false;
+	currentKernel() = kernel;
+	return true;
+}
+
+bool PalettedBlitter::isSupported(EKernel kernel)
+{
+	switch(kernel)
+	{
+	case EKernel::AVX2:
+		return cpuSupportsAVX2();
+	case EKernel::SSE2:
+#ifdef VCMI_BLIT_SSE2
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return true;
+	}
+}
+
+std::string PalettedBlitter::getKernelName(EKernel kernel)
+{
+	switch(kernel)
+	{
+	case EKernel::AVX2:
+		return "AVX2";
+	case EKernel::SSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+STRONG_INLINE void PalettedBlitter::blitPixel(Uint8 index, Uint8 *& p) const
+{
+	switch(alpha[index])
+	{
+	case 0:
+		p += 4;
+		break;
+	case 255:
+		memcpy(p, &opaque[index], 4);
+		p += 4;
+		break;
+	default:
+		{
+			const SDL_Color & tbc = colors[index];
+			ColorPutter<4, +1>::PutColor(p, tbc.r, tbc.g, tbc.b, tbc.a);
+			break;
+		}
+	}
+}
+
+void PalettedBlitter::blitRow(const Uint8 * indices, Uint8 * dest, int w) const
+{
+	switch(currentKernel().load(std::memory_order_relaxed))
+	{
+	case EKernel::AVX2:
+		blitRowAVX2(indices, dest, w);
+		break;
+	case EKernel::SSE2:
+		blitRowSSE2(indices, dest, w);
+		break;
+	default:
+		blitRowScalar(indices, dest, w);
+		break;
+	}
+}
+
+void PalettedBlitter::fillRow(Uint8 index, Uint8 * dest, int w) const
+{
+	switch(alpha[index])
+	{
+	case 0:
+		break;
+	case 255:
+		for(int i = 0; i < w; i++)
+			memcpy(dest + i * 4, &opaque[index], 4);
+		break;
+	default:
+		{
+			//semi-transparent runs are blended by vector kernels in chunks
+			static const int CHUNK = 64;
+			Uint8 indices[CHUNK];
+			memset(indices, index, std::min(w, CHUNK));
+			for(; w > 0; w -= CHUNK, dest += CHUNK * 4)
+				blitRow(indices, dest, std::min(w, CHUNK));
+			break;
+		}
+	}
+}
+
+void PalettedBlitter::copyRow(const Uint8 * indices, Uint8 * dest, int w) const
+{
+	for(int i = 0; i < w; i++)
+		memcpy(dest + i * 4, &opaque[indices[i]], 4);
+}
+
+void PalettedBlitter::blitRowScalar(const Uint8 * color, Uint8 * p, int w) const
+{
+	for(; w; w--)
+		blitPixel(*color++, p);
+}
+
+#ifdef VCMI_BLIT_SSE2
+
+/// Blends 4 pixels, fully opaque pixels are copied and fully transparent ones are left untouched
+/// dst + ((src - dst) * A >> 8), truncated to 8 bits like in ColorPutter
+static STRONG_INLINE __m128i blendSSE2(__m128i src, __m128i a32, __m128i dst, __m128i alphaBits)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	//alpha of each pixel repeated in all four 16-bit channels
+	const __m128i a16 = _mm_or_si128(a32, _mm_slli_epi32(a32, 16));
+	const __m128i aLo = _mm_unpacklo_epi32(a16, a16);
+	const __m128i aHi = _mm_unpackhi_epi32(a16, a16);
+
+	const __m128i dstLo = _mm_unpacklo_epi8(dst, zero);
+	const __m128i dstHi = _mm_unpackhi_epi8(dst, zero);
+	const __m128i byteMask = _mm_set1_epi16(0xFF);
+	__m128i lo = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(src, zero), dstLo), aLo);
+	__m128i hi = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(src, zero), dstHi), aHi);
+	lo = _mm_and_si128(_mm_add_epi16(_mm_srli_epi16(lo, 8), dstLo), byteMask);
+	hi = _mm_and_si128(_mm_add_epi16(_mm_srli_epi16(hi, 8), dstHi), byteMask);
+	__m128i result = _mm_or_si128(_mm_packus_epi16(lo, hi), alphaBits);
+
+	const __m128i isOpaque = _mm_cmpeq_epi32(a32, _mm_set1_epi32(255));
+	const __m128i isTransparent = _mm_cmpeq_epi32(a32, zero);
+	result = _mm_or_si128(_mm_and_si128(isOpaque, src), _mm_andnot_si128(isOpaque, result));
+	return _mm_or_si128(_mm_and_si128(isTransparent, dst), _mm_andnot_si128(isTransparent, result));
+}
+
+void PalettedBlitter::blitRowSSE2(const Uint8 * color, Uint8 * p, int w) const
+{
+	const __m128i alphaBits = _mm_set1_epi32(alphaMask);
+
+	for(; w >= 4; w -= 4, color += 4, p += 16)
+	{
+		const Uint8 a0 = alpha[color[0]], a1 = alpha[color[1]], a2 = alpha[color[2]], a3 = alpha[color[3]];
+
+		if((a0 | a1 | a2 | a3) == 0)
+			continue;
+
+		const __m128i src = _mm_set_epi32(opaque[color[3]], opaque[color[2]], opaque[color[1]], opaque[color[0]]);
+		if((a0 & a1 & a2 & a3) == 255)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(p), src);
+		}
+		else
+		{
+			const __m128i a32 = _mm_set_epi32(a3, a2, a1, a0);
+			const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(p), blendSSE2(src, a32, dst, alphaBits));
+		}
+	}
+	blitRowScalar(color, p, w);
+}
+
+#else
+
+void PalettedBlitter::blitRowSSE2(const Uint8 * color, Uint8 * p, int w) const
+{
+	blitRowScalar(color, p, w);
+}
+
+#endif
+
+#ifdef VCMI_BLIT_AVX2
+
+/// Same as blendSSE2 for 8 pixels, unpacking and packing work within 128-bit lanes so pixels stay in order
+VCMI_AVX2_TARGET static inline __m256i blendAVX2(__m256i src, __m256i a32, __m256i dst, __m256i alphaBits)
+{
+	const __m256i zero = _mm256_setzero_si256();
+
+	const __m256i a16 = _mm256_or_si256(a32, _mm256_slli_epi32(a32, 16));
+	const __m256i aLo = _mm256_unpacklo_epi32(a16, a16);
+	const __m256i aHi = _mm256_unpackhi_epi32(a16, a16);
+
+	const __m256i dstLo = _mm256_unpacklo_epi8(dst, zero);
+	const __m256i dstHi = _mm256_unpackhi_epi8(dst, zero);
+	const __m256i byteMask = _mm256_set1_epi16(0xFF);
+	__m256i lo = _mm256_mullo_epi16(_mm256_sub_epi16(_mm256_unpacklo_epi8(src, zero), dstLo), aLo);
+	__m256i hi = _mm256_mullo_epi16(_mm256_sub_epi16(_mm256_unpackhi_epi8(src, zero), dstHi), aHi);
+	lo = _mm256_and_si256(_mm256_add_epi16(_mm256_srli_epi16(lo, 8), dstLo), byteMask);
+	hi = _mm256_and_si256(_mm256_add_epi16(_mm256_srli_epi16(hi, 8), dstHi), byteMask);
+	__m256i result = _mm256_or_si256(_mm256_packus_epi16(lo, hi), alphaBits);
+
+	const __m256i isOpaque = _mm256_cmpeq_epi32(a32, _mm256_set1_epi32(255));
+	const __m256i isTransparent = _mm256_cmpeq_epi32(a32, zero);
+	result = _mm256_blendv_epi8(result, src, isOpaque);
+	return _mm256_blendv_epi8(result, dst, isTransparent);
+}
+
+VCMI_AVX2_TARGET void PalettedBlitter::blitRowAVX2(const Uint8 * color, Uint8 * p, int w) const
+{
+	const __m256i alphaBits = _mm256_set1_epi32(alphaMask);
+
+	for(; w >= 8; w -= 8, color += 8, p += 32)
+	{
+		const Uint8 a0 = alpha[color[0]], a1 = alpha[color[1]], a2 = alpha[color[2]], a3 = alpha[color[3]];
+		const Uint8 a4 = alpha[color[4]], a5 = alpha[color[5]], a6 = alpha[color[6]], a7 = alpha[color[7]];
+
+		if((a0 | a1 | a2 | a3 | a4 | a5 | a6 | a7) == 0)
+			continue;
+
+		const __m256i src = _mm256_set_epi32(opaque[color[7]], opaque[color[6]], opaque[color[5]], opaque[color[4]],
+			opaque[color[3]], opaque[color[2]], opaque[color[1]], opaque[color[0]]);
+		if((a0 & a1 & a2 & a3 & a4 & a5 & a6 & a7) == 255)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(p), src);
+		}
+		else
+		{
+			const __m256i a32 = _mm256_set_epi32(a7, a6, a5, a4, a3, a2, a1, a0);
+			const __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(p), blendAVX2(src, a32, dst, alphaBits));
+		}
+	}
+	blitRowSSE2(color, p, w);
+}
+
+#else
+
+void PalettedBlitter::blitRowAVX2(const Uint8 * color, Uint8 * p, int w) const
+{
+	blitRowSSE2(color, p, w);
+}
+
+#endif
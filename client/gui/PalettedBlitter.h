@@ -0,0 +1,56 @@
+/*
+ * PalettedBlitter.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include <SDL_pixels.h>
+
+/**
+ * Blits rows of 8 bpp paletted pixels to 32 bpp surfaces using palette converted to destination format once.
+ * Result for every pixel is same as of ColorPutter<4, +1>::PutColorAlphaSwitch.
+ *
+ * Groups of pixels are copied or alpha-blended with single vector operation, kernel is chosen at runtime
+ * by features of CPU: AVX2 (8 pixels), SSE2 (4 pixels) or scalar fallback.
+ */
+class PalettedBlitter
+{
+public:
+	enum class EKernel
+	{
+		SCALAR, SSE2, AVX2
+	};
+
+	/// @param colors Palette, must stay valid and unchanged while blitter is used
+	explicit PalettedBlitter(const SDL_Color * colors);
+
+	/// Blits w pixels given by palette indices
+	void blitRow(const Uint8 * indices, Uint8 * dest, int w) const;
+	/// Blits w pixels of single palette color
+	void fillRow(Uint8 index, Uint8 * dest, int w) const;
+	/// Writes w pixels given by palette indices as fully opaque, regardless of alpha of their colors
+	void copyRow(const Uint8 * indices, Uint8 * dest, int w) const;
+
+	/// Returns kernel used by all blitters, best one supported by CPU unless it was overridden
+	static EKernel getKernel();
+	/// Overrides kernel used by all blitters (e.g. to compare them), returns false if CPU does not support it
+	static bool setKernel(EKernel kernel);
+	static bool isSupported(EKernel kernel);
+	static std::string getKernelName(EKernel kernel);
+
+private:
+	Uint32 opaque[256]; //palette colors in destination format with full alpha
+	Uint8 alpha[256];
+	Uint32 alphaMask;
+	const SDL_Color * colors;
+
+	void blitPixel(Uint8 index, Uint8 *& p) const;
+	void blitRowScalar(const Uint8 * indices, Uint8 * dest, int w) const;
+	void blitRowSSE2(const Uint8 * indices, Uint8 * dest, int w) const;
+	void blitRowAVX2(const Uint8 * indices, Uint8 * dest, int w) const;
+};
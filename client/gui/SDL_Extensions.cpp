@@ -10,6 +10,7 @@
 #include "StdInc.h"
 #include "SDL_Extensions.h"
 #include "SDL_Pixels.h"
+#include "PalettedBlitter.h"
 
 #include "../CGameInfo.h"
 #include "../CMessage.h"
@@ -301,15 +302,24 @@ int CSDL_Ext::blit8bppAlphaTo24bppT(const SDL_Surface * src, const SDL_Rect * sr
 			Uint8 *colory = (Uint8*)src->pixels + srcy*src->pitch + srcx;
 			Uint8 *py = (Uint8*)dst->pixels + dstRect->y*dst->pitch + dstRect->x*bpp;
 
-			for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
+			if(bpp == 4)
 			{
-				Uint8 *color = colory;
-				Uint8 *p = py;
-
-				for(int x = w; x; x--)
+				const PalettedBlitter blitter(colors);
+				for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
+					blitter.blitRow(colory, py, w);
+			}
+			else
+			{
+				for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
 				{
-					const SDL_Color &tbc = colors[*color++]; //color to blit
-					ColorPutter<bpp, +1>::PutColorAlphaSwitch(p, tbc.r, tbc.g, tbc.b, tbc.a);
+					Uint8 *color = colory;
+					Uint8 *p = py;
+
+					for(int x = w; x; x--)
+					{
+						const SDL_Color &tbc = colors[*color++]; //color to blit
+						ColorPutter<bpp, +1>::PutColorAlphaSwitch(p, tbc.r, tbc.g, tbc.b, tbc.a);
+					}
 				}
 			}
 			SDL_UnlockSurface(dst);
@@ -26,6 +26,7 @@
 #include "../lib/CGeneralTextHandler.h"
 #include "../lib/GameConstants.h"
 #include "../lib/CStopWatch.h"
+#include "../lib/CThreadHelper.h"
 #include "CMT.h"
 #include "../lib/CRandomGenerator.h"
 
@@ -285,6 +286,16 @@ void CMapHandler::initBorderGraphics()
 
 void CMapHandler::initObjectRects()
 {
+	//decode object graphics in background, in reverse order so workers and this thread meet in the middle
+	//only group 0 is used for idle objects on adventure map, other groups (e.g. hero movement) are loaded on demand
+	static const std::vector<size_t> PREFETCHED_GROUPS = {0};
+	std::set<std::string> prefetched;
+	for(auto it = map->objects.rbegin(); it != map->objects.rend(); ++it)
+	{
+		if(*it && (*it)->ID != Obj::EVENT && !(*it)->appearance.animationFile.empty() && prefetched.insert((*it)->appearance.animationFile).second)
+			CAnimation::prefetch((*it)->appearance.animationFile, PREFETCHED_GROUPS);
+	}
+
 	//initializing objects / rects
 	for(auto & elem : map->objects)
 	{
@@ -469,6 +480,11 @@ CMapHandler::CMapNormalBlitter::CMapNormalBlitter(CMapHandler * parent)
 	defaultTileRect = Rect(0, 0, tileSize, tileSize);
 }
 
+bool CMapHandler::CMapNormalBlitter::canUseTileCache() const
+{
+	return settings["video"]["mapTileCache"].Bool();
+}
+
 IImage * CMapHandler::CMapWorldViewBlitter::objectToIcon(Obj id, si32 subId, PlayerColor owner) const
 {
 	int ownerIndex = 0;
@@ -710,12 +726,16 @@ CMapHandler::CMapPuzzleViewBlitter::CMapPuzzleViewBlitter(CMapHandler * parent)
 }
 
 CMapHandler::CMapBlitter::CMapBlitter(CMapHandler * p)
-	:parent(p), tileSize(0), halfTileSizeCeil(0), info(nullptr)
+	:parent(p), tileSize(0), halfTileSizeCeil(0), info(nullptr), tileCache(nullptr)
 {
 
 }
 
-CMapHandler::CMapBlitter::~CMapBlitter() = default;
+CMapHandler::CMapBlitter::~CMapBlitter()
+{
+	if (tileCache)
+		SDL_FreeSurface(tileCache);
+}
 
 void CMapHandler::CMapBlitter::drawFrame(SDL_Surface * targetSurf) const
 {
@@ -840,11 +860,137 @@ void CMapHandler::CMapBlitter::drawFow(SDL_Surface * targetSurf) const
 	drawElement(EMapCacheType::FOW, image, nullptr, targetSurf, &destRect);
 }
 
+void CMapHandler::CMapBlitter::drawTileContents(SDL_Surface * targetSurf)
+{
+	const bool isVisible = canDrawCurrentTile();
+
+	realTileRect.x = realPos.x;
+	realTileRect.y = realPos.y;
+
+	const TerrainTile2 & tile = parent->ttiles[pos.x][pos.y][pos.z];
+	const TerrainTile & tinfo = parent->map->getTile(pos);
+	const TerrainTile * tinfoUpper = pos.y > 0 ? &parent->map->getTile(int3(pos.x, pos.y - 1, pos.z)) : nullptr;
+
+	if(isVisible || info->showAllTerrain)
+	{
+		drawTileTerrain(targetSurf, tinfo, tile);
+		if (tinfo.riverType)
+			drawRiver(targetSurf, tinfo);
+		drawRoad(targetSurf, tinfo, tinfoUpper);
+	}
+
+	if(isVisible)
+		drawObjects(targetSurf, tile);
+}
+
+void CMapHandler::CMapBlitter::drawTileFowAndFrame(SDL_Surface * targetSurf)
+{
+	realTileRect.x = realPos.x;
+	realTileRect.y = realPos.y;
+
+	if (pos.x < 0 || pos.x >= parent->sizes.x ||
+		pos.y < 0 || pos.y >= parent->sizes.y)
+	{
+		drawFrame(targetSurf);
+	}
+	else
+	{
+		const TerrainTile2 & tile = parent->ttiles[pos.x][pos.y][pos.z];
+
+		if(!settings["session"]["spectate"].Bool() && !(*info->visibilityMap)[pos.x][pos.y][topTile.z] && !info->showAllTerrain)
+			drawFow(targetSurf);
+
+		// overlay needs to be drawn over fow, because of artifacts-aura-like spells
+		drawTileOverlay(targetSurf, tile);
+	}
+}
+
+void CMapHandler::CMapBlitter::drawTileDebug(SDL_Surface * targetSurf)
+{
+	realTileRect.x = realPos.x;
+	realTileRect.y = realPos.y;
+
+	if (settings["session"]["showBlock"].Bool())
+	{
+		if(parent->map->getTile(int3(pos.x, pos.y, pos.z)).blocked) //temporary hiding blocked positions
+		{
+			static SDL_Surface * block = nullptr;
+			if (!block)
+				block = BitmapHandler::loadBitmap("blocked");
+
+			CSDL_Ext::blitSurface(block, nullptr, targetSurf, &realTileRect);
+		}
+	}
+	if (settings["session"]["showVisit"].Bool())
+	{
+		if(parent->map->getTile(int3(pos.x, pos.y, pos.z)).visitable) //temporary hiding visitable positions
+		{
+			static SDL_Surface * visit = nullptr;
+			if (!visit)
+				visit = BitmapHandler::loadBitmap("visitable");
+
+			CSDL_Ext::blitSurface(visit, nullptr, targetSurf, &realTileRect);
+		}
+	}
+}
+
+void CMapHandler::CMapBlitter::drawDebugGrid(SDL_Surface * targetSurf)
+{
+	if (!settings["session"]["showGrid"].Bool())
+		return;
+
+	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
+	{
+		for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
+		{
+			const int3 color(0x555555, 0x555555, 0x555555);
+
+			if (realPos.y >= info->drawBounds->y &&
+				realPos.y < info->drawBounds->y + info->drawBounds->h)
+				for(int i = 0; i < tileSize; i++)
+					if (realPos.x + i >= info->drawBounds->x &&
+						realPos.x + i < info->drawBounds->x + info->drawBounds->w)
+						CSDL_Ext::SDL_PutPixelWithoutRefresh(targetSurf, realPos.x + i, realPos.y, color.x, color.y, color.z);
+
+			if (realPos.x >= info->drawBounds->x &&
+				realPos.x < info->drawBounds->x + info->drawBounds->w)
+				for(int i = 0; i < tileSize; i++)
+					if (realPos.y + i >= info->drawBounds->y &&
+						realPos.y + i < info->drawBounds->y + info->drawBounds->h)
+						CSDL_Ext::SDL_PutPixelWithoutRefresh(targetSurf, realPos.x, realPos.y + i, color.x, color.y, color.z);
+		}
+	}
+}
+
 void CMapHandler::CMapBlitter::blit(SDL_Surface * targetSurf, const MapDrawingInfo * info)
 {
 	init(info);
 	auto prevClip = clip(targetSurf);
 
+	if (canUseTileCache())
+	{
+		blitChangedTiles(targetSurf);
+	}
+	else
+	{
+		if (tileCache)
+		{
+			SDL_FreeSurface(tileCache);
+			tileCache = nullptr;
+		}
+		blitAllTiles(targetSurf);
+	}
+
+	drawOverlayEx(targetSurf);
+	drawDebugGrid(targetSurf);
+
+	postProcessing(targetSurf);
+
+	SDL_SetClipRect(targetSurf, &prevClip);
+}
+
+void CMapHandler::CMapBlitter::blitAllTiles(SDL_Surface * targetSurf)
+{
 	pos = int3(0, 0, topTile.z);
 
 	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
@@ -857,108 +1003,214 @@ void CMapHandler::CMapBlitter::blit(SDL_Surface * targetSurf, const MapDrawingIn
 			if (pos.y < 0 || pos.y >= parent->sizes.y)
 				continue;
 
-			const bool isVisible = canDrawCurrentTile();
+			drawTileContents(targetSurf);
+		}
+	}
+
+	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
+	{
+		for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
+		{
+			drawTileFowAndFrame(targetSurf);
+
+			if (pos.x >= 0 && pos.x < parent->sizes.x &&
+				pos.y >= 0 && pos.y < parent->sizes.y)
+				drawTileDebug(targetSurf);
+		}
+	}
+}
+
+void CMapHandler::CMapBlitter::blitChangedTiles(SDL_Surface * targetSurf)
+{
+	updateTileCache(targetSurf);
+
+	auto tileIndex = [&](int x, int y)
+	{
+		return (x - topTile.x) * tileCount.y + (y - topTile.y);
+	};
+
+	auto isOnMap = [&](int x, int y)
+	{
+		return x >= 0 && x < parent->sizes.x && y >= 0 && y < parent->sizes.y;
+	};
 
-			realTileRect.x = realPos.x;
-			realTileRect.y = realPos.y;
+	// Heroes, boats and fading objects change almost every frame and hero flags are drawn outside
+	// of their tile, so such tiles (and tiles covered by flags) are always redrawn directly on target surface
+	std::vector<bool> dynamicTiles(tileCount.x * tileCount.y, false);
 
-			const TerrainTile2 & tile = parent->ttiles[pos.x][pos.y][pos.z];
-			const TerrainTile & tinfo = parent->map->getTile(pos);
-			const TerrainTile * tinfoUpper = pos.y > 0 ? &parent->map->getTile(int3(pos.x, pos.y - 1, pos.z)) : nullptr;
+	pos = int3(0, 0, topTile.z);
+
+	for (pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++)
+	{
+		for (pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++)
+		{
+			if (!isOnMap(pos.x, pos.y))
+				continue;
 
-			if(isVisible || info->showAllTerrain)
+			for (auto & object : parent->ttiles[pos.x][pos.y][pos.z].objects)
 			{
-				drawTileTerrain(targetSurf, tinfo, tile);
-				if (tinfo.riverType)
-					drawRiver(targetSurf, tinfo);
-				drawRoad(targetSurf, tinfo, tinfoUpper);
+				if (object.fadeAnimKey < 0 && object.obj && object.obj->ID != Obj::HERO && object.obj->ID != Obj::BOAT)
+					continue;
+
+				for (int x = pos.x - 2; x <= pos.x; x++)
+					for (int y = pos.y - 1; y <= pos.y; y++)
+						if (x >= topTile.x && y >= topTile.y && isOnMap(x, y))
+							dynamicTiles[tileIndex(x, y)] = true;
 			}
+		}
+	}
+
+	// redraw changed tiles in cache
+	for (pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++)
+	{
+		for (pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++)
+		{
+			const int index = tileIndex(pos.x, pos.y);
+			const size_t signature = dynamicTiles[index] ? 0 : getTileSignature();
+
+			if (signature != 0 && signature == tileCacheSignatures[index])
+				continue;
+
+			tileCacheSignatures[index] = signature;
+
+			realPos.x = (pos.x - topTile.x) * tileSize;
+			realPos.y = (pos.y - topTile.y) * tileSize;
+
+			Rect tileRect(realPos.x, realPos.y, tileSize, tileSize);
+			SDL_SetClipRect(tileCache, &tileRect);
+			CSDL_Ext::fillRectBlack(tileCache, &tileRect);
+
+			if (signature == 0)
+				continue;
 
-			if(isVisible)
-				drawObjects(targetSurf, tile);
+			if (isOnMap(pos.x, pos.y))
+				drawTileContents(tileCache);
+			drawTileFowAndFrame(tileCache);
 		}
 	}
+	SDL_SetClipRect(tileCache, nullptr);
+
+	Rect cacheRect(initPos.x, initPos.y, tileCache->w, tileCache->h);
+	CSDL_Ext::blitSurface(tileCache, nullptr, targetSurf, &cacheRect);
 
+	// draw dynamic tiles in the same order as full redraw does
 	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
-	{
 		for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
-		{
-			realTileRect.x = realPos.x;
-			realTileRect.y = realPos.y;
+			if (dynamicTiles[tileIndex(pos.x, pos.y)])
+				drawTileContents(targetSurf);
 
-			if (pos.x < 0 || pos.x >= parent->sizes.x ||
-				pos.y < 0 || pos.y >= parent->sizes.y)
-			{
-				drawFrame(targetSurf);
-			}
-			else
-			{
-				const TerrainTile2 & tile = parent->ttiles[pos.x][pos.y][pos.z];
+	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
+		for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
+			if (dynamicTiles[tileIndex(pos.x, pos.y)])
+				drawTileFowAndFrame(targetSurf);
 
-				if(!settings["session"]["spectate"].Bool() && !(*info->visibilityMap)[pos.x][pos.y][topTile.z] && !info->showAllTerrain)
-					drawFow(targetSurf);
+	for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
+		for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
+			if (isOnMap(pos.x, pos.y))
+				drawTileDebug(targetSurf);
+}
 
-				// overlay needs to be drawn over fow, because of artifacts-aura-like spells
-				drawTileOverlay(targetSurf, tile);
+void CMapHandler::CMapBlitter::updateTileCache(SDL_Surface * targetSurf)
+{
+	const int3 cacheSize(tileCount.x, tileCount.y, 1);
 
-				// drawDebugVisitables()
-				if (settings["session"]["showBlock"].Bool())
-				{
-					if(parent->map->getTile(int3(pos.x, pos.y, pos.z)).blocked) //temporary hiding blocked positions
-					{
-						static SDL_Surface * block = nullptr;
-						if (!block)
-							block = BitmapHandler::loadBitmap("blocked");
+	if (tileCache && tileCacheTopTile == topTile && tileCacheSize == cacheSize)
+		return;
 
-						CSDL_Ext::blitSurface(block, nullptr, targetSurf, &realTileRect);
-					}
-				}
-				if (settings["session"]["showVisit"].Bool())
-				{
-					if(parent->map->getTile(int3(pos.x, pos.y, pos.z)).visitable) //temporary hiding visitable positions
-					{
-						static SDL_Surface * visit = nullptr;
-						if (!visit)
-							visit = BitmapHandler::loadBitmap("visitable");
+	SDL_Surface * newCache = CSDL_Ext::newSurface(tileCount.x * tileSize, tileCount.y * tileSize, targetSurf);
+	SDL_SetSurfaceBlendMode(newCache, SDL_BLENDMODE_NONE);
+	std::vector<size_t> newSignatures(tileCount.x * tileCount.y, 0);
 
-						CSDL_Ext::blitSurface(visit, nullptr, targetSurf, &realTileRect);
-					}
-				}
-			}
+	if (tileCache && tileCacheTopTile.z == topTile.z)
+	{
+		// keep tiles that are still visible after viewport movement
+		const int beginX = std::max(topTile.x, tileCacheTopTile.x);
+		const int beginY = std::max(topTile.y, tileCacheTopTile.y);
+		const int endX = std::min(topTile.x + tileCount.x, tileCacheTopTile.x + tileCacheSize.x);
+		const int endY = std::min(topTile.y + tileCount.y, tileCacheTopTile.y + tileCacheSize.y);
+
+		if (beginX < endX && beginY < endY)
+		{
+			Rect srcRect((beginX - tileCacheTopTile.x) * tileSize, (beginY - tileCacheTopTile.y) * tileSize, (endX - beginX) * tileSize, (endY - beginY) * tileSize);
+			Rect dstRect((beginX - topTile.x) * tileSize, (beginY - topTile.y) * tileSize, 0, 0);
+			SDL_BlitSurface(tileCache, &srcRect, newCache, &dstRect);
+
+			for (int x = beginX; x < endX; x++)
+				for (int y = beginY; y < endY; y++)
+					newSignatures[(x - topTile.x) * tileCount.y + (y - topTile.y)] = tileCacheSignatures[(x - tileCacheTopTile.x) * tileCacheSize.y + (y - tileCacheTopTile.y)];
 		}
 	}
 
-	drawOverlayEx(targetSurf);
+	if (tileCache)
+		SDL_FreeSurface(tileCache);
+
+	tileCache = newCache;
+	tileCacheTopTile = topTile;
+	tileCacheSize = cacheSize;
+	tileCacheSignatures = std::move(newSignatures);
+}
+
+size_t CMapHandler::CMapBlitter::getTileSignature() const
+{
+	size_t signature = 0;
+
+	if (pos.x < 0 || pos.x >= parent->sizes.x ||
+		pos.y < 0 || pos.y >= parent->sizes.y)
+	{
+		vstd::hash_combine(signature, parent->edgeFrames[pos.x][pos.y][topTile.z]);
+		return signature != 0 ? signature : 1;
+	}
 
-	// drawDebugGrid()
-	if (settings["session"]["showGrid"].Bool())
+	const bool isVisible = canDrawCurrentTile();
+
+	vstd::hash_combine(signature, isVisible);
+	vstd::hash_combine(signature, info->showAllTerrain);
+	vstd::hash_combine(signature, settings["session"]["spectate"].Bool());
+
+	// fog of war image depends on visibility of neighbouring tiles
+	for (int x = pos.x - 1; x <= pos.x + 1; x++)
+		for (int y = pos.y - 1; y <= pos.y + 1; y++)
+			if (x >= 0 && x < parent->sizes.x && y >= 0 && y < parent->sizes.y)
+				vstd::hash_combine(signature, static_cast<bool>((*info->visibilityMap)[x][y][pos.z]));
+
+	const TerrainTile & tinfo = parent->map->getTile(pos);
+	vstd::hash_combine(signature, static_cast<int>(tinfo.terType.num));
+	vstd::hash_combine(signature, tinfo.terView);
+	vstd::hash_combine(signature, static_cast<int>(tinfo.riverType));
+	vstd::hash_combine(signature, tinfo.riverDir);
+	vstd::hash_combine(signature, static_cast<int>(tinfo.roadType));
+	vstd::hash_combine(signature, tinfo.roadDir);
+	vstd::hash_combine(signature, tinfo.extTileFlags);
+
+	if (pos.y > 0)
+	{
+		const TerrainTile & tinfoUpper = parent->map->getTile(int3(pos.x, pos.y - 1, pos.z));
+		vstd::hash_combine(signature, static_cast<int>(tinfoUpper.roadType));
+		vstd::hash_combine(signature, tinfoUpper.roadDir);
+		vstd::hash_combine(signature, tinfoUpper.extTileFlags);
+	}
+
+	// palette of water, lava and some rivers is shifted by updateWater
+	if (parent->isAnimatedTerrain(tinfo))
+		vstd::hash_combine(signature, parent->waterAnimPhase);
+
+	if (isVisible)
 	{
-		for (realPos.x = initPos.x, pos.x = topTile.x; pos.x < topTile.x + tileCount.x; pos.x++, realPos.x += tileSize)
+		for (auto & object : parent->ttiles[pos.x][pos.y][pos.z].objects)
 		{
-			for (realPos.y = initPos.y, pos.y = topTile.y; pos.y < topTile.y + tileCount.y; pos.y++, realPos.y += tileSize)
+			vstd::hash_combine(signature, object.obj);
+			vstd::hash_combine(signature, object.rect.x);
+			vstd::hash_combine(signature, object.rect.y);
+
+			if (object.obj && canDrawObject(object.obj))
 			{
-				const int3 color(0x555555, 0x555555, 0x555555);
-
-				if (realPos.y >= info->drawBounds->y &&
-					realPos.y < info->drawBounds->y + info->drawBounds->h)
-					for(int i = 0; i < tileSize; i++)
-						if (realPos.x + i >= info->drawBounds->x &&
-							realPos.x + i < info->drawBounds->x + info->drawBounds->w)
-							CSDL_Ext::SDL_PutPixelWithoutRefresh(targetSurf, realPos.x + i, realPos.y, color.x, color.y, color.z);
-
-				if (realPos.x >= info->drawBounds->x &&
-					realPos.x < info->drawBounds->x + info->drawBounds->w)
-					for(int i = 0; i < tileSize; i++)
-						if (realPos.y + i >= info->drawBounds->y &&
-							realPos.y + i < info->drawBounds->y + info->drawBounds->h)
-							CSDL_Ext::SDL_PutPixelWithoutRefresh(targetSurf, realPos.x, realPos.y + i, color.x, color.y, color.z);
+				vstd::hash_combine(signature, findObjectBitmap(object.obj, info->anim).objBitmap);
+				vstd::hash_combine(signature, object.obj->tempOwner.getNum());
 			}
 		}
 	}
 
-	postProcessing(targetSurf);
-
-	SDL_SetClipRect(targetSurf, &prevClip);
+	return signature != 0 ? signature : 1;
 }
 
 CMapHandler::AnimBitmapHolder CMapHandler::CMapBlitter::findHeroBitmap(const CGHeroInstance * hero, int anim) const
@@ -1319,6 +1571,12 @@ bool CMapHandler::canStartHeroMovement()
 
 void CMapHandler::updateWater() //shift colors in palettes of water tiles
 {
+	//palettes must not change while background thread scales these images for world view
+	if(cache.isPrescaling())
+		return;
+
+	waterAnimPhase++;
+
 	for(auto & elem : terrainImages[7])
 	{
 		for(IImage * img : elem)
@@ -1360,8 +1618,15 @@ void CMapHandler::updateWater() //shift colors in palettes of water tiles
 	}
 }
 
+bool CMapHandler::isAnimatedTerrain(const TerrainTile & tinfo) const
+{
+	return tinfo.terType == ETerrainType::LAVA || tinfo.terType == ETerrainType::WATER ||
+		tinfo.riverType == ERiverType::CLEAR_RIVER || tinfo.riverType == ERiverType::MUDDY_RIVER || tinfo.riverType == ERiverType::LAVA_RIVER;
+}
+
 CMapHandler::~CMapHandler()
 {
+	cache.stopPrescaling(); //before terrain graphics are destroyed
 	delete normalBlitter;
 	delete worldViewBlitter;
 	delete puzzleViewBlitter;
@@ -1379,6 +1644,7 @@ CMapHandler::CMapHandler()
 	worldViewBlitter = new CMapWorldViewBlitter(this);
 	puzzleViewBlitter = new CMapPuzzleViewBlitter(this);
 	fadeAnimCounter = 0;
+	waterAnimPhase = 0;
 	map = nullptr;
 	tilesW = tilesH = 0;
 	offsetX = offsetY = 0;
@@ -1418,29 +1684,94 @@ void CMapHandler::discardWorldViewCache()
 	cache.discardWorldViewCache();
 }
 
-CMapHandler::CMapCache::CMapCache()
+void CMapHandler::prescaleWorldView(std::vector<float> scales)
+{
+	std::vector<std::pair<EMapCacheType, const IImage *>> images;
+
+	auto addFlipped = [&](EMapCacheType type, const TFlippedCache & flipped)
+	{
+		for(auto & views : flipped)
+			for(auto & rotations : views)
+				for(IImage * image : rotations)
+					images.push_back(std::make_pair(type, image));
+	};
+
+	addFlipped(EMapCacheType::TERRAIN, terrainImages);
+	addFlipped(EMapCacheType::ROADS, roadImages);
+	addFlipped(EMapCacheType::RIVERS, riverImages);
+
+	for(const IImage * image : FoWfullHide)
+		images.push_back(std::make_pair(EMapCacheType::FOW, image));
+	for(const IImage * image : FoWpartialHide)
+		images.push_back(std::make_pair(EMapCacheType::FOW, image));
+	for(const IImage * image : egdeImages)
+		images.push_back(std::make_pair(EMapCacheType::FRAME, image));
+
+	cache.prescale(images, scales);
+}
+
+CMapHandler::CMapCache::CMapCache():
+	currentScaleKey(0),
+	worldViewCachedScale(0),
+	hasPrescaled(false),
+	prescaling(false),
+	terminating(false)
+{
+}
+
+CMapHandler::CMapCache::~CMapCache()
+{
+	stopPrescaling();
+}
+
+int CMapHandler::CMapCache::toScaleKey(float scale)
+{
+	return (int)round(scale * 1000);
+}
+
+bool CMapHandler::CMapCache::isPermanent(EMapCacheType type)
 {
-	worldViewCachedScale = 0;
+	switch(type)
+	{
+	case EMapCacheType::TERRAIN:
+	case EMapCacheType::ROADS:
+	case EMapCacheType::RIVERS:
+	case EMapCacheType::FOW:
+	case EMapCacheType::FRAME:
+		return true;
+	default:
+		return false;
+	}
 }
 
 void CMapHandler::CMapCache::discardWorldViewCache()
 {
-	for(auto & cache : data)
-		cache.clear();
+	//images of objects may be unloaded or replaced while world view is closed, map graphics live as long as map handler
+	for(auto & scale : data)
+	{
+		for(ui8 type = 0; type < (ui8)EMapCacheType::AFTER_LAST; type++)
+		{
+			if(!isPermanent((EMapCacheType)type))
+				scale.second[type].clear();
+		}
+	}
 	logAnim->debug("Discarded world view cache");
 }
 
 void CMapHandler::CMapCache::updateWorldViewScale(float scale)
 {
-	if (fabs(scale - worldViewCachedScale) > 0.001f)
-		discardWorldViewCache();
 	worldViewCachedScale = scale;
+	currentScaleKey = toScaleKey(scale);
+	collectPrescaled();
 }
 
 IImage * CMapHandler::CMapCache::requestWorldViewCacheOrCreate(CMapHandler::EMapCacheType type, const IImage * fullSurface)
 {
+	if(hasPrescaled)
+		collectPrescaled();
+
 	intptr_t key = (intptr_t) fullSurface;
-	auto & cache = data[(ui8)type];
+	auto & cache = data[currentScaleKey][(ui8)type];
 
 	auto iter = cache.find(key);
 	if(iter == cache.end())
@@ -1456,6 +1787,100 @@ IImage * CMapHandler::CMapCache::requestWorldViewCacheOrCreate(CMapHandler::EMap
 	}
 }
 
+void CMapHandler::CMapCache::prescale(const std::vector<std::pair<EMapCacheType, const IImage *>> & images, const std::vector<float> & scales)
+{
+	if(prescaling)
+		return;
+
+	if(prescaler.joinable())
+		prescaler.join();
+
+	collectPrescaled();
+
+	std::vector<PrescaleTask> tasks;
+	for(float scale : scales)
+	{
+		const int scaleKey = toScaleKey(scale);
+		auto & cache = data[scaleKey];
+		for(auto & image : images)
+		{
+			if(image.second && !vstd::contains(cache[(ui8)image.first], (intptr_t)image.second))
+				tasks.push_back(PrescaleTask{scaleKey, image.first, image.second, nullptr});
+		}
+	}
+
+	if(tasks.empty())
+		return;
+
+	logAnim->debug("Scaling %d images for world view in background", tasks.size());
+	prescaling = true;
+	terminating = false;
+	auto queued = std::make_shared<std::vector<PrescaleTask>>(std::move(tasks));
+	prescaler = boost::thread([this, queued](){ runPrescaler(*queued); });
+}
+
+bool CMapHandler::CMapCache::isPrescaling() const
+{
+	return prescaling;
+}
+
+void CMapHandler::CMapCache::stopPrescaling()
+{
+	terminating = true;
+	if(prescaler.joinable())
+		prescaler.join();
+	prescaling = false;
+}
+
+void CMapHandler::CMapCache::runPrescaler(std::vector<PrescaleTask> & tasks)
+{
+	setThreadName("CMapCache::runPrescaler");
+
+	//results are published in batches to keep GUI thread from contending for mutex on every tile
+	static const size_t BATCH_SIZE = 64;
+
+	std::vector<PrescaleTask> batch;
+	auto publish = [&]()
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		for(auto & task : batch)
+			prescaled.push_back(std::move(task));
+		batch.clear();
+		hasPrescaled = true;
+	};
+
+	for(auto & task : tasks)
+	{
+		if(terminating)
+			break;
+
+		task.scaled = task.source->scaleFast(task.scaleKey / 1000.0f);
+		batch.push_back(std::move(task));
+		if(batch.size() >= BATCH_SIZE)
+			publish();
+	}
+	publish();
+	prescaling = false;
+}
+
+void CMapHandler::CMapCache::collectPrescaled()
+{
+	std::vector<PrescaleTask> finished;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		std::swap(finished, prescaled);
+		hasPrescaled = false;
+	}
+
+	//GUI thread may have already scaled same image on demand, keep that one since it may be in use
+	for(auto & task : finished)
+	{
+		auto & cache = data[task.scaleKey][(ui8)task.type];
+		if(!vstd::contains(cache, (intptr_t)task.source))
+			cache[(intptr_t)task.source] = std::move(task.scaled);
+	}
+}
+
 bool CMapHandler::compareObjectBlitOrder(const CGObjectInstance * a, const CGObjectInstance * b)
 {
 	if (!a)
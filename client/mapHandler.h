@@ -155,19 +155,52 @@ class CMapHandler
 		TERRAIN, OBJECTS, ROADS, RIVERS, FOW, HEROES, HERO_FLAGS, FRAME, AFTER_LAST
 	};
 
-	/// temporarily caches rescaled frames for map world view redrawing
+	/// caches rescaled frames for map world view redrawing, separately for each scale
+	/// graphics owned by map handler (terrain, roads, rivers, fog of war, map edges) are kept between world view sessions
+	/// and can be scaled in advance on background thread
 	class CMapCache
 	{
-		std::array< std::map<intptr_t, std::unique_ptr<IImage>>, (ui8)EMapCacheType::AFTER_LAST> data;
+		typedef std::array< std::map<intptr_t, std::unique_ptr<IImage>>, (ui8)EMapCacheType::AFTER_LAST> TScaledImages;
+
+		struct PrescaleTask
+		{
+			int scaleKey;
+			EMapCacheType type;
+			const IImage * source;
+			std::unique_ptr<IImage> scaled;
+		};
+
+		std::map<int, TScaledImages> data; //[scale in thousandths]
+		int currentScaleKey;
 		float worldViewCachedScale;
+
+		boost::mutex mx;
+		std::vector<PrescaleTask> prescaled; //finished by background thread but not yet moved to data
+		std::atomic<bool> hasPrescaled;
+		std::atomic<bool> prescaling;
+		std::atomic<bool> terminating;
+		boost::thread prescaler;
+
+		static int toScaleKey(float scale);
+		static bool isPermanent(EMapCacheType type);
+		void runPrescaler(std::vector<PrescaleTask> & tasks);
+		void collectPrescaled();
 	public:
 		CMapCache();
-		/// destroys all cached data (frees surfaces)
+		~CMapCache();
+		/// destroys cached frames of objects and heroes (frees surfaces), pre-scaled map graphics stay cached
 		void discardWorldViewCache();
-		/// updates scale and determines if currently cached data is still valid
+		/// selects cache for given scale, previously cached scales stay valid
 		void updateWorldViewScale(float scale);
 		/// asks for cached data; @returns cached data if found, new scaled surface otherwise, may return nullptr in case of scaling error
 		IImage * requestWorldViewCacheOrCreate(EMapCacheType type, const IImage * fullSurface);
+
+		/// scales given images to all given scales on background thread, images must stay valid until stopPrescaling() or prescaling ends
+		/// does nothing if previous request is still being processed
+		void prescale(const std::vector<std::pair<EMapCacheType, const IImage *>> & images, const std::vector<float> & scales);
+		bool isPrescaling() const;
+		/// interrupts background scaling and waits for its thread to finish
+		void stopPrescaling();
 	};
 
 	/// helper struct to pass around resolved bitmaps of an object; images can be nullptr if object doesn't have bitmap of that type
@@ -200,6 +233,11 @@ class CMapHandler
 		Rect defaultTileRect; // default rect based on 0: [0, 0, tileSize, tileSize]
 		const MapDrawingInfo * info; // data for drawing passed from outside
 
+		SDL_Surface * tileCache; // fully drawn tiles of current viewport that are reused while their content is unchanged
+		int3 tileCacheTopTile; // top-left tile stored in tile cache
+		int3 tileCacheSize; // size of tile cache [in tiles]
+		std::vector<size_t> tileCacheSignatures; // content signatures of cached tiles, 0 if tile is not cached
+
 		/// general drawing method, called internally by more specialized ones
 		virtual void drawElement(EMapCacheType cacheType, const IImage * source, SDL_Rect * sourceRect, SDL_Surface * targetSurf, SDL_Rect * destRect) const = 0;
 
@@ -227,6 +265,15 @@ class CMapHandler
 		/// draws additional icons (for VIEW_AIR, VIEW_EARTH spells atm)
 		virtual void drawOverlayEx(SDL_Surface * targetSurf);
 
+		/// current tile: first drawing pass - terrain, river, road and objects
+		void drawTileContents(SDL_Surface * targetSurf);
+		/// current tile: second drawing pass - map frame or fog of war and overlay
+		void drawTileFowAndFrame(SDL_Surface * targetSurf);
+		/// current tile: debug information (blocked and visitable positions)
+		void drawTileDebug(SDL_Surface * targetSurf);
+		/// draws debug grid over whole viewport
+		void drawDebugGrid(SDL_Surface * targetSurf);
+
 		// third drawing pass
 
 		/// custom post-processing, if needed (used by puzzle view)
@@ -245,6 +292,19 @@ class CMapHandler
 		virtual bool canDrawObject(const CGObjectInstance * obj) const;
 		virtual bool canDrawCurrentTile() const;
 
+		// tile cache
+
+		/// true if unchanged tiles can be reused from tile cache
+		virtual bool canUseTileCache() const { return false; }
+		/// redraws whole viewport without tile cache
+		void blitAllTiles(SDL_Surface * targetSurf);
+		/// redraws only tiles with changed or animated content, other tiles are taken from tile cache
+		void blitChangedTiles(SDL_Surface * targetSurf);
+		/// reallocates tile cache if viewport moved, keeping tiles that are still visible
+		void updateTileCache(SDL_Surface * targetSurf);
+		/// returns hash of everything that affects look of current tile, except for always redrawn objects (heroes, boats, fading objects)
+		size_t getTileSignature() const;
+
 		// internal helper methods to choose correct bitmap(s) for object; called internally by findObjectBitmap
 		AnimBitmapHolder findHeroBitmap(const CGHeroInstance * hero, int anim) const;
 		AnimBitmapHolder findBoatBitmap(const CGBoat * hero, int anim) const;
@@ -268,6 +328,7 @@ class CMapHandler
 		void drawTileOverlay(SDL_Surface * targetSurf,const TerrainTile2 & tile) const override {}
 		void init(const MapDrawingInfo * info) override;
 		SDL_Rect clip(SDL_Surface * targetSurf) const override;
+		bool canUseTileCache() const override;
 	public:
 		CMapNormalBlitter(CMapHandler * parent);
 		virtual ~CMapNormalBlitter(){}
@@ -302,6 +363,7 @@ class CMapHandler
 		void postProcessing(SDL_Surface * targetSurf) const override;
 		bool canDrawObject(const CGObjectInstance * obj) const override;
 		bool canDrawCurrentTile() const override { return true; }
+		bool canUseTileCache() const override { return false; }
 	public:
 		CMapPuzzleViewBlitter(CMapHandler * parent);
 	};
@@ -314,6 +376,9 @@ class CMapHandler
 	std::map<int, std::pair<int3, CFadeAnimation*>> fadeAnims;
 	int fadeAnimCounter;
 
+	int waterAnimPhase; // incremented on every palette shift of water, lava and river images
+	bool isAnimatedTerrain(const TerrainTile & tinfo) const;
+
 	CMapBlitter * resolveBlitter(const MapDrawingInfo * info) const;
 	bool updateObjectsFade();
 	bool startObjectFade(TerrainTileObject & obj, bool in, int3 pos);
@@ -384,6 +449,8 @@ public:
 	bool canStartHeroMovement();
 
 	void discardWorldViewCache();
+	/// starts scaling of terrain, roads, rivers, fog of war and map edges for world view in background
+	void prescaleWorldView(std::vector<float> scales);
 
 	static bool compareObjectBlitOrder(const CGObjectInstance * a, const CGObjectInstance * b);
 };
@@ -728,20 +728,23 @@ void CAdvMapInt::fworldViewBack()
 		centerOn(hero);
 }
 
+//scales of world view for 1x, 2x and 4x magnification
+static const std::vector<float> WORLD_VIEW_SCALES = {0.22f, 0.36f, 0.5f};
+
 void CAdvMapInt::fworldViewScale1x()
 {
 	// TODO set corresponding scale button to "selected" mode
-	changeMode(EAdvMapMode::WORLD_VIEW, 0.22f);
+	changeMode(EAdvMapMode::WORLD_VIEW, WORLD_VIEW_SCALES[0]);
 }
 
 void CAdvMapInt::fworldViewScale2x()
 {
-	changeMode(EAdvMapMode::WORLD_VIEW, 0.36f);
+	changeMode(EAdvMapMode::WORLD_VIEW, WORLD_VIEW_SCALES[1]);
 }
 
 void CAdvMapInt::fworldViewScale4x()
 {
-	changeMode(EAdvMapMode::WORLD_VIEW, 0.5f);
+	changeMode(EAdvMapMode::WORLD_VIEW, WORLD_VIEW_SCALES[2]);
 }
 
 void CAdvMapInt::fswitchLevel()
@@ -1899,6 +1902,16 @@ void CAdvMapInt::changeMode(EAdvMapMode newMode, float newScale)
 			infoBar.showSelection(); // to prevent new day animation interfering world view mode
 			infoBar.deactivate();
 
+			{
+				//map graphics for selected scale are scaled first, other magnifications follow
+				std::vector<float> scales = {newScale};
+				for(float scale : WORLD_VIEW_SCALES)
+				{
+					if(scale != newScale)
+						scales.push_back(scale);
+				}
+				CGI->mh->prescaleWorldView(scales);
+			}
 			break;
 		}
 		worldViewScale = newScale;
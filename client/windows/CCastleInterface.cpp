@@ -22,6 +22,7 @@
 #include "../CMusicHandler.h"
 #include "../CPlayerInterface.h"
 #include "../Graphics.h"
+#include "../gui/CAnimation.h"
 #include "../gui/CGuiHandler.h"
 #include "../gui/SDL_Extensions.h"
 #include "../windows/InfoWindows.h"
@@ -511,11 +512,13 @@ void CCastleBuildings::recreate()
 		}
 	}
 
+	std::vector<const CStructure *> toCreate;
+
 	for(const CStructure * structure : town->town->clientInfo.structures)
 	{
 		if (!structure->building)
 		{
-			buildings.push_back(new CBuildingRect(this, town, structure));
+			toCreate.push_back(structure);
 			continue;
 		}
 		if (vstd::contains(buildingsCopy, structure->building->bid))
@@ -534,8 +537,15 @@ void CCastleBuildings::recreate()
 			     < build->getDistance(b->building->bid);
 		});
 
-		buildings.push_back(new CBuildingRect(this, town, toAdd));
+		toCreate.push_back(toAdd);
 	}
+
+	//decode building animations in background, in reverse order so workers and GUI thread meet in the middle
+	for(auto it = toCreate.rbegin(); it != toCreate.rend(); ++it)
+		CAnimation::prefetch((*it)->defName, std::vector<size_t>(), true);
+
+	for(const CStructure * structure : toCreate)
+		buildings.push_back(new CBuildingRect(this, town, structure));
 	boost::sort(buildings, [] (const CBuildingRect * a, const CBuildingRect * b)
 	{
 		return *a < *b;
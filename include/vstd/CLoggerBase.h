@@ -49,6 +49,75 @@ namespace ELogLevel
 
 namespace vstd
 {
+/// Log message which is rendered only when it is written, possibly on the logging thread.
+class DLL_LINKAGE CLogMessage
+{
+public:
+	virtual ~CLogMessage();
+	virtual std::string str() const = 0;
+};
+
+/// Type under which log argument is stored until the message is rendered.
+/// C strings are copied since they may be gone by then.
+template<typename T>
+struct LogArgument
+{
+	typedef T type;
+};
+
+template<>
+struct LogArgument<const char *>
+{
+	typedef std::string type;
+};
+
+template<>
+struct LogArgument<char *>
+{
+	typedef std::string type;
+};
+
+/// Format string and its arguments captured by value, formatted with boost::format on demand.
+template<typename ... Args>
+class CFormattedLogMessage : public CLogMessage
+{
+public:
+	CFormattedLogMessage(const std::string & format, Args ... args)
+		: format(format), args(std::move(args)...)
+	{
+	}
+
+	std::string str() const override
+	{
+		try
+		{
+			boost::format fmt(format);
+			makeFormat<0>(fmt);
+			return fmt.str();
+		}
+		catch(...)
+		{
+			return "Log formatting failed, format was: " + format;
+		}
+	}
+
+private:
+	template<size_t I>
+	typename std::enable_if<(I < sizeof...(Args))>::type makeFormat(boost::format & fmt) const
+	{
+		fmt % std::get<I>(args);
+		makeFormat<I + 1>(fmt);
+	}
+
+	template<size_t I>
+	typename std::enable_if<(I == sizeof...(Args))>::type makeFormat(boost::format &) const
+	{
+	}
+
+	std::string format;
+	std::tuple<Args...> args;
+};
+
 class DLL_LINKAGE CLoggerBase
 {
 public:
@@ -56,6 +125,12 @@ public:
 
 	virtual void log(ELogLevel::ELogLevel level, const std::string & message) const = 0;
 	virtual void log(ELogLevel::ELogLevel level, const boost::format & fmt) const = 0;
+	/// Logs message which isn't rendered yet. Should be called only if level is enabled.
+	virtual void log(ELogLevel::ELogLevel level, std::unique_ptr<CLogMessage> message) const = 0;
+
+	/// Returns true if a log message of the given level will be logged, false if not.
+	/// This check is cheap and is done before the message gets formatted.
+	virtual bool isLevelEnabled(ELogLevel::ELogLevel level) const = 0;
 
 	/// Returns true if a debug/trace log message will be logged, false if not.
 	/// Useful if performance is important and concatenating the log message is a expensive task.
@@ -65,17 +140,11 @@ public:
 	template<typename T, typename ... Args>
 	void log(ELogLevel::ELogLevel level, const std::string & format, T t, Args ... args) const
 	{
-		try
-		{
-			boost::format fmt(format);
-			makeFormat(fmt, t, args...);
-			log(level, fmt);
-		}
-		catch(...)
-		{
-			log(ELogLevel::ERROR, "Log formatting failed, format was:");
-			log(ELogLevel::ERROR, format);
-		}
+		if(!isLevelEnabled(level))
+			return;
+
+		typedef CFormattedLogMessage<typename LogArgument<T>::type, typename LogArgument<Args>::type...> TMessage;
+		log(level, std::unique_ptr<CLogMessage>(new TMessage(format, t, args...)));
 	}
 
 	/// Log methods for various log levels
@@ -134,20 +203,6 @@ public:
 	{
 		log(ELogLevel::TRACE, format, t, args...);
 	}
-
-private:
-	template <typename T>
-	void makeFormat(boost::format & fmt, T t) const
-	{
-		fmt % t;
-	}
-
-	template <typename T, typename ... Args>
-	void makeFormat(boost::format & fmt, T t, Args ... args) const
-	{
-		fmt % t;
-		makeFormat(fmt, args...);
-	}
 };
 
 /// RAII class for tracing the program execution.
@@ -466,6 +466,35 @@ std::vector < const CGObjectInstance * > CGameInfoCallback::getFlaggableObjects(
 	return ret;
 }
 
+std::vector < const CGObjectInstance * > CGameInfoCallback::getObjectsOfType(Obj type, si32 subID) const
+{
+	std::vector<const CGObjectInstance *> ret;
+	auto objects = subID < 0 ? gs->objectRegistry.getObjectsOfType(gs->map, type) : gs->objectRegistry.getObjectsOfType(gs->map, type, subID);
+	for(const CGObjectInstance * obj : objects)
+	{
+		if(isVisible(obj))
+			ret.push_back(obj);
+	}
+	return ret;
+}
+
+std::vector < const CGObjectInstance * > CGameInfoCallback::getVisitableObjsAround(int3 center, int radius) const
+{
+	std::vector<const CGObjectInstance *> ret;
+	int3 offset(radius, radius, 0);
+	for(const int3 & tile : gs->objectRegistry.getVisitableTiles(gs->map, center - offset, center + offset))
+		vstd::concatenate(ret, getVisitableObjs(tile, false));
+	return ret;
+}
+
+std::vector < const CGObjectInstance * > CGameInfoCallback::getAllVisitableObjs() const
+{
+	std::vector<const CGObjectInstance *> ret;
+	for(const int3 & tile : gs->objectRegistry.getVisitableTiles(gs->map, int3(0, 0, 0), getMapSize() - int3(1, 1, 1)))
+		vstd::concatenate(ret, getVisitableObjs(tile, false));
+	return ret;
+}
+
 int3 CGameInfoCallback::getMapSize() const
 {
 	return int3(gs->map->width, gs->map->height, gs->map->twoLevel ? 2 : 1);
@@ -772,13 +801,9 @@ int3 CPlayerSpecificInfoCallback::getGrailPos( double *outKnownRatio )
 
 std::vector < const CGObjectInstance * > CPlayerSpecificInfoCallback::getMyObjects() const
 {
-	std::vector < const CGObjectInstance * > ret;
-	for(const CGObjectInstance * obj : gs->map->objects)
-	{
-		if(obj && obj->tempOwner == player)
-			ret.push_back(obj);
-	}
-	return ret;
+	if(!player)
+		return std::vector < const CGObjectInstance * >();
+	return gs->objectRegistry.getObjectsOfOwner(gs->map, *player);
 }
 
 std::vector < const CGDwelling * > CPlayerSpecificInfoCallback::getMyDwellings() const
@@ -80,6 +80,9 @@ public:
 	std::vector <const CGObjectInstance * > getBlockingObjs(int3 pos)const;
 	std::vector <const CGObjectInstance * > getVisitableObjs(int3 pos, bool verbose = true)const;
 	std::vector <const CGObjectInstance * > getFlaggableObjects(int3 pos) const;
+	std::vector <const CGObjectInstance * > getObjectsOfType(Obj type, si32 subID = -1) const; //visible objects of given type, any subtype if subID is -1
+	std::vector <const CGObjectInstance * > getVisitableObjsAround(int3 center, int radius) const; //getVisitableObjs of visible tiles at most radius tiles away on the same level, tile by tile
+	std::vector <const CGObjectInstance * > getAllVisitableObjs() const; //getVisitableObjs of all visible tiles, tile by tile
 	const CGObjectInstance * getTopObj (int3 pos) const;
 	PlayerColor getOwner(ObjectInstanceID heroID) const;
 	const CGObjectInstance *getObjByQuestIdentifier(int identifier) const; //nullptr if object has been removed (eg. killed)
@@ -66,8 +66,6 @@ public:
 	void applyOnGS(CGameState *gs, void *pack) const override
 	{
 		T *ptr = static_cast<T*>(pack);
-
-		boost::unique_lock<boost::shared_mutex> lock(CGameState::mutex);
 		ptr->applyGs(gs);
 	}
 };
@@ -1963,7 +1961,12 @@ PlayerRelations::PlayerRelations CGameState::getPlayerRelations( PlayerColor col
 void CGameState::apply(CPack *pack)
 {
 	ui16 typ = typeList.getTypeID(pack);
+
+	boost::unique_lock<boost::shared_mutex> lock(mutex);
 	applierGs->getApplier(typ)->applyOnGS(this,pack);
+	//pack hooks get pack as passed here, some packs have more than one CPack base
+	victoryConditionTracker.packApplied(map, pack);
+	objectRegistry.packApplied(map, pack);
 }
 
 void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
@@ -2207,20 +2210,7 @@ bool CGameState::checkForVictory(PlayerColor player, const EventCondition & cond
 		case EventCondition::HAVE_CREATURES:
 		{
 			//check if in players armies there is enough creatures
-			int total = 0; //creature counter
-			for(size_t i = 0; i < map->objects.size(); i++)
-			{
-				const CArmedInstance *ai = nullptr;
-				if(map->objects[i]
-					&& map->objects[i]->tempOwner == player //object controlled by player
-					&&  (ai = dynamic_cast<const CArmedInstance*>(map->objects[i].get()))) //contains army
-				{
-					for(auto & elem : ai->Slots()) //iterate through army
-						if(elem.second->type->idNumber == condition.objectType) //it's searched creature
-							total += elem.second->count;
-				}
-			}
-			return total >= condition.value;
+			return victoryConditionTracker.getCreatureCount(map, player, CreatureID(condition.objectType)) >= condition.value;
 		}
 		case EventCondition::HAVE_RESOURCES:
 		{
@@ -2254,12 +2244,7 @@ bool CGameState::checkForVictory(PlayerColor player, const EventCondition & cond
 			}
 			else
 			{
-				for(auto & elem : map->objects) // mode B - destroy all objects of this type
-				{
-					if(elem && elem->ID == condition.objectType)
-						return false;
-				}
-				return true;
+				return victoryConditionTracker.getObjectCount(map, Obj(condition.objectType)) == 0; // mode B - destroy all objects of this type
 			}
 		}
 		case EventCondition::CONTROL:
@@ -2274,13 +2259,11 @@ bool CGameState::checkForVictory(PlayerColor player, const EventCondition & cond
 			}
 			else
 			{
-				for(auto & elem : map->objects) // mode B - flag all objects of this type
-				{
-					 //check not flagged objs
-					if ( elem && elem->ID == condition.objectType && team.count(elem->tempOwner) == 0 )
-						return false;
-				}
-				return true;
+				// mode B - flag all objects of this type
+				int flagged = 0;
+				for(PlayerColor member : team)
+					flagged += victoryConditionTracker.getObjectCount(map, Obj(condition.objectType), member);
+				return flagged == victoryConditionTracker.getObjectCount(map, Obj(condition.objectType));
 			}
 		}
 		case EventCondition::TRANSPORT:
@@ -2476,12 +2459,8 @@ struct statsHLP
 
 		/// FIXME: Dirty dirty hack
 		/// Stats helper need some access to gamestate.
-		std::vector<const CGObjectInstance *> ownedObjects;
-		for(const CGObjectInstance * obj : heroOrTown->cb->gameState()->map->objects)
-		{
-			if(obj && obj->tempOwner == ps->color)
-				ownedObjects.push_back(obj);
-		}
+		const CGameState * gameState = heroOrTown->cb->gameState();
+		auto ownedObjects = gameState->objectRegistry.getObjectsOfOwner(gameState->map, ps->color);
 		/// This is code from CPlayerSpecificInfoCallback::getMyObjects
 		/// I'm really need to find out about callback interface design...
 
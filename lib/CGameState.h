@@ -21,6 +21,8 @@
 #include "CRandomGenerator.h"
 #include "CGameStateFwd.h"
 #include "CPathfinder.h"
+#include "CVictoryConditionTracker.h"
+#include "CObjectRegistry.h"
 
 class CTown;
 class CCallback;
@@ -163,6 +165,8 @@ public:
 	std::map<TeamID, TeamState> teams;
 	CBonusSystemNode globalEffects;
 	RumorState rumor;
+	mutable CVictoryConditionTracker victoryConditionTracker; //not serialized, rebuilt on first check
+	mutable CObjectRegistry objectRegistry; //not serialized, rebuilt on first query
 
 	static boost::shared_mutex mutex;
 
@@ -0,0 +1,297 @@
+/*
+ * CObjectRegistry.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CObjectRegistry.h"
+
+#include "NetPacks.h"
+#include "mapping/CMap.h"
+#include "mapObjects/CGHeroInstance.h"
+
+template <typename Index, typename Key>
+static CObjectRegistry::TObjects findObjects(const Index & index, const Key & key)
+{
+	auto it = index.find(key);
+	return it == index.end() ? CObjectRegistry::TObjects() : it->second;
+}
+
+template <typename Index, typename Key>
+static void addObject(Index & index, const Key & key, const CGObjectInstance * obj)
+{
+	CObjectRegistry::TObjects & objects = index[key];
+	//keep objects ordered by id like after rebuild
+	objects.insert(boost::range::upper_bound(objects, obj, [](const CGObjectInstance * lhs, const CGObjectInstance * rhs)
+	{
+		return lhs->id < rhs->id;
+	}), obj);
+}
+
+template <typename Index, typename Key>
+static void removeObject(Index & index, const Key & key, const CGObjectInstance * obj)
+{
+	//object may be already deleted, compare only pointers
+	auto it = index.find(key);
+	if(it != index.end())
+		vstd::erase_if_present(it->second, obj);
+}
+
+CObjectRegistry::ObjectEntry::ObjectEntry(const CGObjectInstance * obj):
+	obj(obj),
+	subID(-1)
+{
+	if(obj)
+	{
+		owner = obj->tempOwner;
+		type = obj->ID;
+		subID = obj->subID;
+		areaTo = obj->pos;
+		areaFrom = obj->pos - int3(std::max(obj->getWidth(), 1) - 1, std::max(obj->getHeight(), 1) - 1, 0);
+	}
+}
+
+CObjectRegistry::CObjectRegistry():
+	valid(false)
+{
+}
+
+void CObjectRegistry::packApplied(const CMap * map, const CPack * pack)
+{
+	boost::mutex::scoped_lock lock(mx);
+	if(!valid)
+		return;
+
+	if(auto p = dynamic_cast<const TryMoveHero *>(pack))
+	{
+		updateObject(map, p->id);
+		auto hero = dynamic_cast<const CGHeroInstance *>(map->objects[p->id.getNum()].get());
+		if(hero && hero->boat)
+			updateObject(map, hero->boat->id);
+
+		if(p->result == TryMoveHero::DISEMBARK) //boat was left on start tile
+		{
+			for(const CGObjectInstance * obj : map->getTile(CGHeroInstance::convertPosition(p->start, false)).visitableObjects)
+			{
+				if(obj->ID == Obj::BOAT)
+					updateObject(map, obj->id);
+			}
+		}
+	}
+	else if(auto p = dynamic_cast<const NewObject *>(pack))
+	{
+		updateObject(map, p->id);
+	}
+	else if(auto p = dynamic_cast<const RemoveObject *>(pack))
+	{
+		bool removesHero = p->id.getNum() >= 0 && p->id.getNum() < entries.size() && entries[p->id.getNum()].type == Obj::HERO;
+		updateObject(map, p->id);
+		if(removesHero) //boat of removed hero is deleted as well
+		{
+			for(size_t i = 0; i < entries.size(); i++)
+			{
+				if(entries[i].obj && entries[i].type == Obj::BOAT && entries[i].obj != map->objects[i].get())
+					updateObject(map, ObjectInstanceID(i));
+			}
+		}
+	}
+	else if(auto p = dynamic_cast<const SetObjectProperty *>(pack))
+	{
+		if(p->what == ObjProperty::OWNER || p->what == ObjProperty::ID || p->what == ObjProperty::SUBID)
+			updateObject(map, p->id);
+	}
+	else if(auto p = dynamic_cast<const ChangeObjPos *>(pack))
+	{
+		updateObject(map, p->objid);
+	}
+	else if(auto p = dynamic_cast<const SetHeroesInTown *>(pack))
+	{
+		updateObject(map, p->visiting);
+		updateObject(map, p->garrison);
+	}
+	else if(auto p = dynamic_cast<const GiveHero *>(pack))
+	{
+		updateObject(map, p->id);
+	}
+	else if(dynamic_cast<const HeroRecruited *>(pack))
+	{
+		updateObject(map, map->heroesOnMap.back()->id);
+	}
+}
+
+void CObjectRegistry::invalidate()
+{
+	boost::mutex::scoped_lock lock(mx);
+	valid = false;
+}
+
+CObjectRegistry::TObjects CObjectRegistry::getObjectsOfOwner(const CMap * map, PlayerColor owner)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	return findObjects(byOwner, owner);
+}
+
+CObjectRegistry::TObjects CObjectRegistry::getObjectsOfType(const CMap * map, Obj type)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	return findObjects(byType, type);
+}
+
+CObjectRegistry::TObjects CObjectRegistry::getObjectsOfType(const CMap * map, Obj type, si32 subID)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	return findObjects(bySubtype, std::make_pair(type, subID));
+}
+
+std::vector<int3> CObjectRegistry::getVisitableTiles(const CMap * map, int3 from, int3 to)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+
+	vstd::amax(from.x, 0);
+	vstd::amax(from.y, 0);
+	vstd::amax(from.z, 0);
+	vstd::amin(to.x, map->width - 1);
+	vstd::amin(to.y, map->height - 1);
+	vstd::amin(to.z, chunksCount.z - 1);
+
+	std::vector<int3> ret;
+	for(int z = from.z; z <= to.z; z++)
+	{
+		for(int y = from.y / CHUNK_SIZE; y <= to.y / CHUNK_SIZE && from.y <= to.y; y++)
+		{
+			for(int x = from.x / CHUNK_SIZE; x <= to.x / CHUNK_SIZE && from.x <= to.x; x++)
+			{
+				for(const int3 & tile : chunks[getChunkIndex(int3(x * CHUNK_SIZE, y * CHUNK_SIZE, z))])
+				{
+					if(tile.x >= from.x && tile.x <= to.x && tile.y >= from.y && tile.y <= to.y)
+						ret.push_back(tile);
+				}
+			}
+		}
+	}
+
+	//same order as when iterating over all tiles of map
+	boost::sort(ret, [](const int3 & lhs, const int3 & rhs)
+	{
+		return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+	});
+	return ret;
+}
+
+void CObjectRegistry::rebuild(const CMap * map)
+{
+	if(valid)
+		return;
+
+	byOwner.clear();
+	byType.clear();
+	bySubtype.clear();
+	entries.clear();
+	chunks.clear();
+
+	chunksCount = int3((map->width + CHUNK_SIZE - 1) / CHUNK_SIZE, (map->height + CHUNK_SIZE - 1) / CHUNK_SIZE, map->twoLevel ? 2 : 1);
+	chunks.resize(chunksCount.x * chunksCount.y * chunksCount.z);
+	entries.resize(map->objects.size());
+
+	for(size_t i = 0; i < map->objects.size(); i++)
+	{
+		const CGObjectInstance * obj = map->objects[i].get();
+		if(!obj)
+			continue;
+
+		byOwner[obj->tempOwner].push_back(obj);
+		byType[obj->ID].push_back(obj);
+		bySubtype[std::make_pair(obj->ID, obj->subID)].push_back(obj);
+		entries[i] = ObjectEntry(obj);
+	}
+
+	for(int z = 0; z < chunksCount.z; z++)
+	{
+		for(int y = 0; y < chunksCount.y; y++)
+		{
+			for(int x = 0; x < chunksCount.x; x++)
+				updateChunk(map, x, y, z);
+		}
+	}
+	valid = true;
+}
+
+void CObjectRegistry::updateObject(const CMap * map, ObjectInstanceID id)
+{
+	if(id.getNum() < 0 || id.getNum() >= map->objects.size())
+		return;
+
+	if(entries.size() < map->objects.size())
+		entries.resize(map->objects.size());
+
+	ObjectEntry & entry = entries[id.getNum()];
+	const CGObjectInstance * obj = map->objects[id.getNum()].get();
+
+	bool keysChanged = entry.obj != obj || (obj && (entry.owner != obj->tempOwner || entry.type != obj->ID || entry.subID != obj->subID));
+	if(entry.obj)
+	{
+		if(keysChanged)
+		{
+			removeObject(byOwner, entry.owner, entry.obj);
+			removeObject(byType, entry.type, entry.obj);
+			removeObject(bySubtype, std::make_pair(entry.type, entry.subID), entry.obj);
+		}
+		updateArea(map, entry.areaFrom, entry.areaTo);
+	}
+
+	entry = ObjectEntry(obj);
+	if(obj)
+	{
+		if(keysChanged)
+		{
+			addObject(byOwner, entry.owner, obj);
+			addObject(byType, entry.type, obj);
+			addObject(bySubtype, std::make_pair(entry.type, entry.subID), obj);
+		}
+		updateArea(map, entry.areaFrom, entry.areaTo);
+	}
+}
+
+void CObjectRegistry::updateArea(const CMap * map, int3 from, int3 to)
+{
+	vstd::amax(from.x, 0);
+	vstd::amax(from.y, 0);
+	vstd::amin(to.x, map->width - 1);
+	vstd::amin(to.y, map->height - 1);
+	if(from.x > to.x || from.y > to.y || from.z < 0 || from.z >= chunksCount.z)
+		return;
+
+	for(int y = from.y / CHUNK_SIZE; y <= to.y / CHUNK_SIZE; y++)
+	{
+		for(int x = from.x / CHUNK_SIZE; x <= to.x / CHUNK_SIZE; x++)
+			updateChunk(map, x, y, from.z);
+	}
+}
+
+void CObjectRegistry::updateChunk(const CMap * map, int chunkX, int chunkY, int z)
+{
+	std::vector<int3> & chunk = chunks[getChunkIndex(int3(chunkX * CHUNK_SIZE, chunkY * CHUNK_SIZE, z))];
+	chunk.clear();
+	for(int x = chunkX * CHUNK_SIZE; x < std::min<int>(map->width, (chunkX + 1) * CHUNK_SIZE); x++)
+	{
+		for(int y = chunkY * CHUNK_SIZE; y < std::min<int>(map->height, (chunkY + 1) * CHUNK_SIZE); y++)
+		{
+			int3 tile(x, y, z);
+			if(!map->getTile(tile).visitableObjects.empty())
+				chunk.push_back(tile);
+		}
+	}
+}
+
+size_t CObjectRegistry::getChunkIndex(const int3 & tile) const
+{
+	return (static_cast<size_t>(tile.z) * chunksCount.y + tile.y / CHUNK_SIZE) * chunksCount.x + tile.x / CHUNK_SIZE;
+}
@@ -0,0 +1,75 @@
+/*
+ * CObjectRegistry.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "GameConstants.h"
+#include "int3.h"
+
+class CMap;
+class CGObjectInstance;
+struct CPack;
+
+/**
+ * Secondary indexes over map objects: by owner, by type, by type and subtype and tiles with visitable objects by map chunk.
+ *
+ * Indexes are built on first query and then updated by packs which add, remove or move objects on map or change
+ * their owner or type. Only chunks touched by such object are rescanned, all other packs are ignored.
+ * Queries return copies since indexes may be updated by other thread reading game state.
+ */
+class DLL_LINKAGE CObjectRegistry
+{
+public:
+	typedef std::vector<const CGObjectInstance *> TObjects;
+
+	/// Size of square map area covered by one chunk of visitable tiles index
+	static const int CHUNK_SIZE = 8;
+
+	CObjectRegistry();
+
+	/// Has to be called after pack was applied on game state, with game state still locked
+	void packApplied(const CMap * map, const CPack * pack);
+	/// Forgets all indexes, e.g. when map was changed
+	void invalidate();
+
+	/// Objects ordered by id, same as in map
+	TObjects getObjectsOfOwner(const CMap * map, PlayerColor owner);
+	TObjects getObjectsOfType(const CMap * map, Obj type);
+	TObjects getObjectsOfType(const CMap * map, Obj type, si32 subID);
+	/// Tiles with at least one visitable object within rectangle [from, to] (inclusive), ordered by x, then y, then z
+	std::vector<int3> getVisitableTiles(const CMap * map, int3 from, int3 to);
+
+private:
+	/// Indexed state of object, used to find its old place in indexes once object was changed or removed
+	struct ObjectEntry
+	{
+		const CGObjectInstance * obj;
+		PlayerColor owner;
+		Obj type;
+		si32 subID;
+		int3 areaFrom, areaTo; //tiles covered by object
+
+		explicit ObjectEntry(const CGObjectInstance * obj = nullptr);
+	};
+
+	boost::mutex mx;
+	bool valid;
+	int3 chunksCount;
+	std::map<PlayerColor, TObjects> byOwner;
+	std::map<Obj, TObjects> byType;
+	std::map<std::pair<Obj, si32>, TObjects> bySubtype;
+	std::vector<ObjectEntry> entries; //by object id
+	std::vector<std::vector<int3>> chunks;
+
+	void rebuild(const CMap * map);
+	void updateObject(const CMap * map, ObjectInstanceID id);
+	void updateArea(const CMap * map, int3 from, int3 to);
+	void updateChunk(const CMap * map, int chunkX, int chunkY, int z);
+	size_t getChunkIndex(const int3 & tile) const;
+};
@@ -17,6 +17,7 @@
 #include "GameConstants.h"
 #include "CStopWatch.h"
 #include "CConfigHandler.h"
+#include "CPerformanceCounters.h"
 #include "../lib/CPlayerState.h"
 
 CPathfinder::PathfinderOptions::PathfinderOptions()
@@ -65,6 +66,8 @@ CPathfinder::CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstan
 
 void CPathfinder::calculatePaths()
 {
+	CPerformanceTimer timer("pathfinding");
+
 	auto passOneTurnLimitCheck = [&]() -> bool
 	{
 		if(!options.oneTurnSpecialLayersLimit)
@@ -840,6 +843,59 @@ bool CPathfinder::addTeleportWhirlpool(const CGWhirlpool * obj) const
 	return options.useTeleportWhirlpool && hlp->hasBonusOfType(Bonus::WHIRLPOOL_PROTECTION) && obj;
 }
 
+MovementCosts::MovementCosts(const CGHeroInstance * hero, const TurnInfo * ti)
+{
+	const int pathfindingSkill = hero->valOfBonuses(Selector::typeSubtype(Bonus::SECONDARY_SKILL_PREMY, SecondarySkill::PATHFINDING));
+	for(int i = 0; i < GameConstants::TERRAIN_TYPES; i++)
+	{
+		if(ti->nativeTerrain == i || (i < ETerrainType::ROCK && ti->hasBonusOfType(Bonus::NO_TERRAIN_PENALTY, i)))
+			terrainCosts[i] = GameConstants::BASE_MOVEMENT_COST;
+		else
+			terrainCosts[i] = std::max<int>(VLC->heroh->terrCosts[i] - pathfindingSkill, GameConstants::BASE_MOVEMENT_COST);
+	}
+
+	roadCosts[ERoadType::NO_ROAD] = GameConstants::BASE_MOVEMENT_COST;
+	roadCosts[ERoadType::DIRT_ROAD] = 75;
+	roadCosts[ERoadType::GRAVEL_ROAD] = 65;
+	roadCosts[ERoadType::COBBLESTONE_ROAD] = 50;
+
+	flyingMovement = ti->hasBonusOfType(Bonus::FLYING_MOVEMENT);
+	flyingMovementFactor = (100.0 + ti->valOfBonuses(Bonus::FLYING_MOVEMENT)) / 100.0;
+	waterWalking = ti->hasBonusOfType(Bonus::WATER_WALKING);
+	waterWalkingFactor = (100.0 + ti->valOfBonuses(Bonus::WATER_WALKING)) / 100.0;
+}
+
+int MovementCosts::getTileCost(const TerrainTile & dest, const TerrainTile & from) const
+{
+	//if there is road both on dest and src tiles - use road movement cost
+	if(dest.roadType != ERoadType::NO_ROAD && from.roadType != ERoadType::NO_ROAD)
+	{
+		int road = std::min(dest.roadType, from.roadType); //used road ID
+		if(road <= ERoadType::COBBLESTONE_ROAD)
+			return roadCosts[road];
+
+		logGlobal->error("Unknown road type: %d", road);
+		return GameConstants::BASE_MOVEMENT_COST;
+	}
+	return terrainCosts[from.terType];
+}
+
+int MovementCosts::applyDestinationModifiers(int cost, const TerrainTile & dest, const TerrainTile & from, bool inBoat) const
+{
+	if(dest.blocked && flyingMovement)
+	{
+		cost *= flyingMovementFactor;
+	}
+	else if(dest.terType == ETerrainType::WATER)
+	{
+		if(inBoat && from.hasFavorableWinds() && dest.hasFavorableWinds())
+			cost *= 0.666;
+		else if(!inBoat && waterWalking)
+			cost *= waterWalkingFactor;
+	}
+	return cost;
+}
+
 TurnInfo::BonusCache::BonusCache(TBonusListPtr bl)
 {
 	noTerrainPenalty.reserve(ETerrainType::ROCK);
@@ -928,6 +984,14 @@ int TurnInfo::getMaxMovePoints(const EPathfindingLayer layer) const
 	return layer == EPathfindingLayer::SAIL ? maxMovePointsWater : maxMovePointsLand;
 }
 
+const MovementCosts & TurnInfo::getMovementCosts() const
+{
+	if(!movementCosts)
+		movementCosts = make_unique<MovementCosts>(hero, this);
+
+	return *movementCosts;
+}
+
 CPathfinderHelper::CPathfinderHelper(const CGHeroInstance * Hero, const CPathfinder::PathfinderOptions & Options)
 	: turn(-1), hero(Hero), options(Options)
 {
@@ -1053,24 +1117,13 @@ int CPathfinderHelper::getMovementCost(const CGHeroInstance * h, const int3 & sr
 	/// TODO: by the original game rules hero shouldn't be affected by terrain penalty while flying.
 	/// Also flying movement only has penalty when player moving over blocked tiles.
 	/// So if you only have base flying with 40% penalty you can still ignore terrain penalty while having zero flying penalty.
-	int ret = h->getTileCost(*dt, *ct, ti);
+	const MovementCosts & costs = ti->getMovementCosts();
+	int ret = costs.getTileCost(*dt, *ct);
 	/// Unfortunately this can't be implemented yet as server don't know when player flying and when he's not.
 	/// Difference in cost calculation on client and server is much worse than incorrect cost.
 	/// So this one is waiting till server going to use pathfinder rules for path validation.
 
-	if(dt->blocked && ti->hasBonusOfType(Bonus::FLYING_MOVEMENT))
-	{
-		ret *= (100.0 + ti->valOfBonuses(Bonus::FLYING_MOVEMENT)) / 100.0;
-	}
-	else if(dt->terType == ETerrainType::WATER)
-	{
-		if(h->boat && ct->hasFavorableWinds() && dt->hasFavorableWinds())
-			ret *= 0.666;
-		else if(!h->boat && ti->hasBonusOfType(Bonus::WATER_WALKING))
-		{
-			ret *= (100.0 + ti->valOfBonuses(Bonus::WATER_WALKING)) / 100.0;
-		}
-	}
+	ret = costs.applyDestinationModifiers(ret, *dt, *ct, h->boat != nullptr);
 
 	if(src.x != dst.x && src.y != dst.y) //it's diagonal move
 	{
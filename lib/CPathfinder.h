@@ -229,6 +229,27 @@ private:
 
 };
 
+struct TurnInfo;
+
+/// Movement costs of hero for every terrain and road type, computed once from hero bonuses.
+/// Lets pathfinder price each move with few table lookups instead of bonus system queries.
+struct DLL_LINKAGE MovementCosts
+{
+	MovementCosts(const CGHeroInstance * hero, const TurnInfo * ti);
+
+	/// Cost of move without diagonal, flying, water or last tile modifiers, same as CGHeroInstance::getTileCost
+	int getTileCost(const TerrainTile & dest, const TerrainTile & from) const;
+	/// Applies flying, water walking and favorable winds modifiers of destination tile to tile cost
+	int applyDestinationModifiers(int cost, const TerrainTile & dest, const TerrainTile & from, bool inBoat) const;
+
+	std::array<int, GameConstants::TERRAIN_TYPES> terrainCosts; //of leaving tile of given terrain
+	std::array<int, ERoadType::COBBLESTONE_ROAD + 1> roadCosts;
+	bool flyingMovement;
+	double flyingMovementFactor;
+	bool waterWalking;
+	double waterWalkingFactor;
+};
+
 struct DLL_LINKAGE TurnInfo
 {
 	/// This is certainly not the best design ever and certainly can be improved
@@ -256,6 +277,11 @@ struct DLL_LINKAGE TurnInfo
 	bool hasBonusOfType(const Bonus::BonusType type, const int subtype = -1) const;
 	int valOfBonuses(const Bonus::BonusType type, const int subtype = -1) const;
 	int getMaxMovePoints(const EPathfindingLayer layer) const;
+	/// Computed on first use, TurnInfo is also created by code which never asks for movement costs
+	const MovementCosts & getMovementCosts() const;
+
+private:
+	mutable std::unique_ptr<MovementCosts> movementCosts;
 };
 
 class DLL_LINKAGE CPathfinderHelper
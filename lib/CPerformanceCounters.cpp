@@ -0,0 +1,201 @@
+/*
+ * CPerformanceCounters.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPerformanceCounters.h"
+
+#include "filesystem/FileStream.h"
+
+#ifdef VCMI_WINDOWS
+	#include <windows.h>
+	#include <psapi.h>
+#ifndef __MINGW32__
+	#pragma comment(lib, "psapi.lib")
+#endif
+#else
+	#include <sys/resource.h>
+#endif
+
+CPerformanceCounters::Counter::Counter():
+	calls(0),
+	totalTime(0),
+	maxTime(0)
+{
+}
+
+CPerformanceCounters & CPerformanceCounters::get()
+{
+	static CPerformanceCounters instance;
+	return instance;
+}
+
+CPerformanceCounters::CPerformanceCounters():
+	enabled(false)
+{
+}
+
+void CPerformanceCounters::setEnabled(bool value)
+{
+	enabled = value;
+}
+
+bool CPerformanceCounters::isEnabled() const
+{
+	return enabled;
+}
+
+void CPerformanceCounters::record(const std::string & phase, ui64 microseconds)
+{
+	boost::mutex::scoped_lock lock(mx);
+	Counter & counter = counters[phase];
+	counter.calls++;
+	counter.totalTime += microseconds;
+	vstd::amax(counter.maxTime, microseconds);
+}
+
+void CPerformanceCounters::reset()
+{
+	boost::mutex::scoped_lock lock(mx);
+	counters.clear();
+}
+
+std::map<std::string, CPerformanceCounters::Counter> CPerformanceCounters::getCounters() const
+{
+	boost::mutex::scoped_lock lock(mx);
+	return counters;
+}
+
+ui64 CPerformanceCounters::getPeakMemoryUsage()
+{
+#ifdef VCMI_WINDOWS
+	PROCESS_MEMORY_COUNTERS info;
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)))
+		return info.PeakWorkingSetSize / 1024;
+	return 0;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef VCMI_APPLE
+	return usage.ru_maxrss / 1024; //in bytes on OS X
+#else
+	return usage.ru_maxrss; //in kilobytes
+#endif
+#endif
+}
+
+JsonNode CPerformanceCounters::toJson() const
+{
+	JsonNode report(JsonNode::JsonType::DATA_STRUCT);
+	JsonNode & phases = report["phases"];
+	phases.setType(JsonNode::JsonType::DATA_STRUCT);
+
+	for(auto & entry : getCounters())
+	{
+		const Counter & counter = entry.second;
+		JsonNode & phase = phases[entry.first];
+		phase["calls"].Integer() = counter.calls;
+		phase["totalMs"].Float() = counter.totalTime / 1000.0;
+		phase["averageMs"].Float() = counter.totalTime / 1000.0 / counter.calls;
+		phase["maxMs"].Float() = counter.maxTime / 1000.0;
+	}
+	report["peakMemoryKB"].Integer() = getPeakMemoryUsage();
+	return report;
+}
+
+std::vector<std::string> CPerformanceCounters::compare(const JsonNode & report, const JsonNode & baseline, double tolerance)
+{
+	//differences below one millisecond are measurement noise even for phases that are fast in baseline
+	static const double MIN_TIME_DIFFERENCE = 1.0;
+
+	std::vector<std::string> regressions;
+
+	auto check = [&](const std::string & name, double value, double base, double minDifference)
+	{
+		if(value > base * (1.0 + tolerance) && value - base >= minDifference)
+			regressions.push_back(boost::str(boost::format("%s: %.2f exceeds baseline %.2f by %.1f%%") % name % value % base % ((value / base - 1.0) * 100.0)));
+	};
+
+	for(auto & entry : baseline["phases"].Struct())
+	{
+		const JsonNode & phase = report["phases"][entry.first];
+		if(phase.isNull())
+		{
+			logGlobal->warn("Phase %s from baseline is missing in report", entry.first);
+			continue;
+		}
+		check(entry.first + " total time [ms]", phase["totalMs"].Float(), entry.second["totalMs"].Float(), MIN_TIME_DIFFERENCE);
+	}
+
+	if(!baseline["wallTimeMs"].isNull() && !report["wallTimeMs"].isNull())
+		check("wall time [ms]", report["wallTimeMs"].Float(), baseline["wallTimeMs"].Float(), MIN_TIME_DIFFERENCE);
+
+	if(!baseline["peakMemoryKB"].isNull() && report["peakMemoryKB"].Float() > 0)
+		check("peak memory [KB]", report["peakMemoryKB"].Float(), baseline["peakMemoryKB"].Float(), 0);
+
+	for(auto & entry : baseline.Struct())
+	{
+		if(entry.second.getType() != JsonNode::JsonType::DATA_STRUCT || entry.first == "phases")
+			continue;
+
+		const JsonNode & nested = report[entry.first];
+		if(nested.getType() != JsonNode::JsonType::DATA_STRUCT || nested["phases"].isNull())
+			continue;
+
+		for(auto & regression : compare(nested, entry.second, tolerance))
+			regressions.push_back(entry.first + "." + regression);
+	}
+
+	return regressions;
+}
+
+JsonNode CPerformanceCounters::loadReport(const boost::filesystem::path & path)
+{
+	if(!boost::filesystem::exists(path))
+		return JsonNode();
+
+	FileStream file(path, std::ios::in | std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return JsonNode(data.c_str(), data.size());
+}
+
+void CPerformanceCounters::saveReport(const boost::filesystem::path & path, const JsonNode & report)
+{
+	FileStream file(path, std::ofstream::out | std::ofstream::trunc);
+	file << report.toJson();
+}
+
+CPerformanceTimer::CPerformanceTimer(const char * phase):
+	active(CPerformanceCounters::get().isEnabled())
+{
+	if(active)
+	{
+		this->phase = phase;
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+CPerformanceTimer::CPerformanceTimer(const char * phase, const std::string & subphase):
+	active(CPerformanceCounters::get().isEnabled())
+{
+	if(active)
+	{
+		this->phase = std::string(phase) + "." + subphase;
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+CPerformanceTimer::~CPerformanceTimer()
+{
+	if(active)
+	{
+		auto duration = std::chrono::steady_clock::now() - start;
+		CPerformanceCounters::get().record(phase, std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	}
+}
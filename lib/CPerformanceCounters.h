@@ -0,0 +1,87 @@
+/*
+ * CPerformanceCounters.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "JsonNode.h"
+
+#include <chrono>
+
+/**
+ * Accumulates wall-clock time spent in named phases of the game (AI turns, pathfinding, pack application...).
+ *
+ * Counters are disabled by default and cost only one atomic load per measured scope then,
+ * as long as phase name is not composed by caller (see CPerformanceTimer).
+ * Used by benchmark mode of client and server to produce performance reports and compare them with baseline.
+ */
+class DLL_LINKAGE CPerformanceCounters
+{
+public:
+	struct Counter
+	{
+		Counter();
+
+		ui64 calls;
+		ui64 totalTime; //in microseconds
+		ui64 maxTime; //in microseconds
+	};
+
+	/// Counters shared by whole process
+	static CPerformanceCounters & get();
+
+	CPerformanceCounters();
+
+	void setEnabled(bool value);
+	bool isEnabled() const;
+
+	void record(const std::string & phase, ui64 microseconds);
+	void reset();
+	std::map<std::string, Counter> getCounters() const;
+
+	/// Returns peak resident memory of this process in kilobytes or 0 if it is not known on this platform
+	static ui64 getPeakMemoryUsage();
+
+	/**
+	 * Creates report in format
+	 * { "phases" : { "<phase>" : { "calls", "totalMs", "averageMs", "maxMs" } }, "peakMemoryKB" }
+	 */
+	JsonNode toJson() const;
+
+	/**
+	 * Compares total phase times and peak memory of report with baseline, nested reports (like "server") are compared recursively.
+	 *
+	 * @param tolerance Allowed relative increase, e.g. 0.1 for 10%
+	 * @return Descriptions of all values which exceed baseline by more than tolerance, empty if there is no regression
+	 */
+	static std::vector<std::string> compare(const JsonNode & report, const JsonNode & baseline, double tolerance);
+
+	/// Reads report from file, returns null node if file does not exist
+	static JsonNode loadReport(const boost::filesystem::path & path);
+	static void saveReport(const boost::filesystem::path & path, const JsonNode & report);
+
+private:
+	std::atomic<bool> enabled;
+	mutable boost::mutex mx;
+	std::map<std::string, Counter> counters;
+};
+
+/// Measures time from construction to destruction and records it as given phase if counters are enabled
+class DLL_LINKAGE CPerformanceTimer : public boost::noncopyable
+{
+public:
+	explicit CPerformanceTimer(const char * phase);
+	/// Records as "<phase>.<subphase>", name is composed only if counters are enabled
+	CPerformanceTimer(const char * phase, const std::string & subphase);
+	~CPerformanceTimer();
+
+private:
+	std::string phase;
+	bool active;
+	std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,179 @@
+/*
+ * CVictoryConditionTracker.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CVictoryConditionTracker.h"
+
+#include "NetPacks.h"
+#include "CCreatureHandler.h"
+#include "mapping/CMap.h"
+#include "mapObjects/CArmedInstance.h"
+
+CVictoryConditionTracker::CVictoryConditionTracker():
+	valid(false)
+{
+}
+
+void CVictoryConditionTracker::packApplied(const CMap * map, const CPack * pack)
+{
+	boost::mutex::scoped_lock lock(mx);
+	if(!valid)
+		return;
+
+	if(auto p = dynamic_cast<const ChangeStackCount *>(pack))
+		updateObject(map, p->sl.army->id);
+	else if(auto p = dynamic_cast<const SetStackType *>(pack))
+		updateObject(map, p->sl.army->id);
+	else if(auto p = dynamic_cast<const EraseStack *>(pack))
+		updateObject(map, p->sl.army->id);
+	else if(auto p = dynamic_cast<const InsertNewStack *>(pack))
+		updateObject(map, p->sl.army->id);
+	else if(auto p = dynamic_cast<const SwapStacks *>(pack))
+	{
+		updateObject(map, p->sl1.army->id);
+		updateObject(map, p->sl2.army->id);
+	}
+	else if(auto p = dynamic_cast<const RebalanceStacks *>(pack))
+	{
+		updateObject(map, p->src.army->id);
+		updateObject(map, p->dst.army->id);
+	}
+	else if(auto p = dynamic_cast<const SetObjectProperty *>(pack))
+	{
+		updateObject(map, p->id); //owner, type or army of monster may change
+	}
+	else if(auto p = dynamic_cast<const NewObject *>(pack))
+	{
+		updateObject(map, p->id);
+	}
+	else if(auto p = dynamic_cast<const RemoveObject *>(pack))
+	{
+		updateObject(map, p->id);
+		//boat of removed hero is deleted as well
+		std::vector<ObjectInstanceID> removed;
+		for(auto & entry : counted)
+		{
+			if(!map->objects[entry.first.getNum()])
+				removed.push_back(entry.first);
+		}
+		for(auto id : removed)
+			updateObject(map, id);
+	}
+	else if(auto p = dynamic_cast<const GiveHero *>(pack))
+	{
+		updateObject(map, p->id);
+	}
+	else if(dynamic_cast<const HeroRecruited *>(pack))
+	{
+		updateObject(map, map->heroesOnMap.back()->id);
+	}
+	else if(dynamic_cast<const BattleResult *>(pack))
+	{
+		valid = false;
+	}
+}
+
+void CVictoryConditionTracker::invalidate()
+{
+	boost::mutex::scoped_lock lock(mx);
+	valid = false;
+}
+
+si64 CVictoryConditionTracker::getCreatureCount(const CMap * map, PlayerColor owner, CreatureID creature)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	auto player = creatures.find(owner);
+	if(player == creatures.end())
+		return 0;
+	auto count = player->second.find(creature);
+	return count == player->second.end() ? 0 : count->second;
+}
+
+int CVictoryConditionTracker::getObjectCount(const CMap * map, Obj type)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	auto count = objects.find(type);
+	return count == objects.end() ? 0 : count->second;
+}
+
+int CVictoryConditionTracker::getObjectCount(const CMap * map, Obj type, PlayerColor owner)
+{
+	boost::mutex::scoped_lock lock(mx);
+	rebuild(map);
+	auto owners = ownedObjects.find(type);
+	if(owners == ownedObjects.end())
+		return 0;
+	auto count = owners->second.find(owner);
+	return count == owners->second.end() ? 0 : count->second;
+}
+
+void CVictoryConditionTracker::rebuild(const CMap * map)
+{
+	if(valid)
+		return;
+
+	counted.clear();
+	creatures.clear();
+	objects.clear();
+	ownedObjects.clear();
+
+	for(auto & obj : map->objects)
+	{
+		if(!obj)
+			continue;
+
+		ObjectCounts & counts = counted[obj->id];
+		counts = countObject(obj);
+		addObject(counts, 1);
+	}
+	valid = true;
+}
+
+void CVictoryConditionTracker::updateObject(const CMap * map, ObjectInstanceID id)
+{
+	auto counts = counted.find(id);
+	if(counts != counted.end())
+	{
+		addObject(counts->second, -1);
+		counted.erase(counts);
+	}
+
+	//armies which are not on map (e.g. heroes in pool) are not counted
+	if(id.getNum() >= 0 && id.getNum() < map->objects.size() && map->objects[id.getNum()])
+	{
+		ObjectCounts & added = counted[id];
+		added = countObject(map->objects[id.getNum()]);
+		addObject(added, 1);
+	}
+}
+
+void CVictoryConditionTracker::addObject(const ObjectCounts & counts, int sign)
+{
+	objects[counts.type] += sign;
+	ownedObjects[counts.type][counts.owner] += sign;
+
+	auto & playerCreatures = creatures[counts.owner];
+	for(auto & creature : counts.creatures)
+		playerCreatures[creature.first] += sign * creature.second;
+}
+
+CVictoryConditionTracker::ObjectCounts CVictoryConditionTracker::countObject(const CGObjectInstance * obj)
+{
+	ObjectCounts ret;
+	ret.type = obj->ID;
+	ret.owner = obj->tempOwner;
+	if(auto army = dynamic_cast<const CArmedInstance *>(obj))
+	{
+		for(auto & slot : army->Slots())
+			ret.creatures[slot.second->type->idNumber] += slot.second->count;
+	}
+	return ret;
+}
@@ -0,0 +1,64 @@
+/*
+ * CVictoryConditionTracker.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "GameConstants.h"
+
+class CMap;
+class CGObjectInstance;
+struct CPack;
+
+/**
+ * Counts map objects and creatures needed by victory conditions which otherwise scan all map objects
+ * (have creatures, destroy or flag all objects of given type).
+ *
+ * Counters are built on first query and then kept up to date after each applied pack: packs which change
+ * armies, add or remove objects or change their owner or type update counts of objects they touch,
+ * battle result (which may erase resurrected stacks of both armies) makes counters to be rebuilt on next query
+ * and all other packs are ignored.
+ */
+class DLL_LINKAGE CVictoryConditionTracker
+{
+public:
+	CVictoryConditionTracker();
+
+	/// Has to be called after pack was applied on game state, with game state still locked
+	void packApplied(const CMap * map, const CPack * pack);
+	/// Forgets all counters, e.g. when map was changed
+	void invalidate();
+
+	/// Total number of creatures of given type in all armies owned by player
+	si64 getCreatureCount(const CMap * map, PlayerColor owner, CreatureID creature);
+	/// Number of objects of given type on map
+	int getObjectCount(const CMap * map, Obj type);
+	/// Number of objects of given type owned by player
+	int getObjectCount(const CMap * map, Obj type, PlayerColor owner);
+
+private:
+	/// What object added to counters
+	struct ObjectCounts
+	{
+		Obj type;
+		PlayerColor owner;
+		std::map<CreatureID, si64> creatures; //empty if object is not an army
+	};
+
+	boost::mutex mx;
+	bool valid;
+	std::map<ObjectInstanceID, ObjectCounts> counted;
+	std::map<PlayerColor, std::map<CreatureID, si64>> creatures;
+	std::map<Obj, int> objects;
+	std::map<Obj, std::map<PlayerColor, int>> ownedObjects;
+
+	void rebuild(const CMap * map);
+	void updateObject(const CMap * map, ObjectInstanceID id);
+	void addObject(const ObjectCounts & counts, int sign);
+	static ObjectCounts countObject(const CGObjectInstance * obj);
+};
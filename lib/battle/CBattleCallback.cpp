@@ -0,0 +1,40 @@
+/*
+ * CBattleCallback.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CBattleCallback.h"
+
+#include "BattleInfo.h"
+#include "../CGameState.h"
+#include "../NetPacks.h"
+
+CBattleCallback::CBattleCallback(CGameState *GS, boost::optional<PlayerColor> Player)
+{
+	gs = GS;
+	player = Player;
+	waitTillRealize = false;
+	unlockGsWhenWaiting = false;
+}
+
+int CBattleCallback::battleMakeAction(BattleAction* action)
+{
+	assert(action->actionType == Battle::HERO_SPELL);
+	MakeCustomAction mca(*action);
+	sendRequest(&mca);
+	return 0;
+}
+
+bool CBattleCallback::battleMakeTacticAction( BattleAction * action )
+{
+	assert(gs->curB->tacticDistance);
+	MakeAction ma;
+	ma.ba = *action;
+	sendRequest(&ma);
+	return true;
+}
@@ -0,0 +1,39 @@
+/*
+ * CBattleCallback.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+#include "CPlayerBattleCallback.h"
+
+struct CPack;
+struct BattleAction;
+
+class DLL_LINKAGE IBattleCallback
+{
+public:
+	bool waitTillRealize; //if true, request functions will return after they are realized by server
+	bool unlockGsWhenWaiting;//if true after sending each request, gs mutex will be unlocked so the changes can be applied; NOTICE caller must have gs mx locked prior to any call to actiob callback!
+	//battle
+	virtual int battleMakeAction(BattleAction* action)=0;//for casting spells by hero - DO NOT use it for moving active stack
+	virtual bool battleMakeTacticAction(BattleAction * action) =0; // performs tactic phase actions
+};
+
+/// Callback given to battle interfaces. Requests are delivered by sendRequest -
+/// client sends them to server, server can handle them directly for battle AI it runs itself.
+class DLL_LINKAGE CBattleCallback : public IBattleCallback, public CPlayerBattleCallback
+{
+protected:
+	virtual int sendRequest(const CPack *request) = 0; //returns requestID (that'll be matched to requestID in PackageApplied)
+
+public:
+	CBattleCallback(CGameState *GS, boost::optional<PlayerColor> Player);
+	int battleMakeAction(BattleAction* action) override;//for casting spells by hero - DO NOT use it for moving active stack
+	bool battleMakeTacticAction(BattleAction * action) override; // performs tactic phase actions
+
+	friend class CClient;
+};
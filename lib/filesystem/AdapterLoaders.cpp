@@ -165,3 +165,17 @@ void CFilesystemList::addLoader(ISimpleResourceLoader * loader, bool writeable)
 	if (writeable)
 		writeableLoaders.insert(loader);
 }
+
+bool CFilesystemList::removeLoader(ISimpleResourceLoader * loader)
+{
+	for (auto it = loaders.begin(); it != loaders.end(); ++it)
+	{
+		if (it->get() == loader)
+		{
+			writeableLoaders.erase(loader);
+			loaders.erase(it);
+			return true;
+		}
+	}
+	return false;
+}
@@ -84,4 +84,12 @@ public:
 	 * @param writeable - resource shall be treated as writeable
 	 */
 	void addLoader(ISimpleResourceLoader * loader, bool writeable);
+
+	/**
+	 * Removes loader from the loaders list and destroys it
+	 *
+	 * @param loader The loader previously passed to addLoader
+	 * @return true if loader was found and removed
+	 */
+	bool removeLoader(ISimpleResourceLoader * loader);
 };
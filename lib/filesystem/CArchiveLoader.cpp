@@ -12,6 +12,7 @@
 
 #include "CFileInputStream.h"
 #include "CCompressedStream.h"
+#include "CMappedFile.h"
 
 #include "CBinaryReader.h"
 
@@ -21,7 +22,7 @@ ArchiveEntry::ArchiveEntry()
 
 }
 
-CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path _archive) :
+CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path _archive, bool memoryMapped) :
     archive(std::move(_archive)),
     mountPoint(std::move(_mountPoint))
 {
@@ -45,6 +46,18 @@ CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path
 	else
 		throw std::runtime_error("LOD archive format unknown. Cannot deal with " + archive.string());
 
+	if(memoryMapped)
+	{
+		try
+		{
+			mappedArchive = std::make_shared<CMappedFile>(archive);
+		}
+		catch(std::runtime_error & e)
+		{
+			logGlobal->warn("%s. Archive will be read without memory mapping", e.what());
+		}
+	}
+
 	logGlobal->trace("%sArchive \"%s\" loaded (%d files found).", ext, archive.filename(), entries.size());
 }
 
@@ -146,6 +159,14 @@ std::unique_ptr<CInputStream> CArchiveLoader::load(const ResourceID & resourceNa
 
 	const ArchiveEntry & entry = entries.at(resourceName);
 
+	if(mappedArchive)
+	{
+		if(entry.compressedSize != 0)
+			return make_unique<CMappedCompressedStream>(mappedArchive, entry.offset, entry.compressedSize, entry.fullSize);
+		else
+			return make_unique<CMappedFileStream>(mappedArchive, entry.offset, entry.fullSize);
+	}
+
 	if (entry.compressedSize != 0) //compressed data
 	{
 		auto fileStream = make_unique<CFileInputStream>(archive, entry.offset, entry.compressedSize);
@@ -13,6 +13,7 @@
 #include "ResourceID.h"
 
 class CFileInputStream;
+class CMappedFile;
 
 /**
  * A struct which holds information about the archive entry e.g. where it is located in space of the archive container.
@@ -50,10 +51,12 @@ public:
 	 * These are valid extensions: .LOD, .SND, .VID
 	 *
 	 * @param archive Specifies the file path to the archive which should be indexed and loaded.
+	 * @param memoryMapped If true, archive will be mapped into memory once and entries will be served from mapping.
+	 * Falls back to regular file reading if archive can't be mapped.
 	 *
 	 * @throws std::runtime_error if the archive wasn't found or if the archive isn't supported
 	 */
-	CArchiveLoader(std::string mountPoint, boost::filesystem::path archive);
+	CArchiveLoader(std::string mountPoint, boost::filesystem::path archive, bool memoryMapped = false);
 
 	/// Interface implementation
 	/// @see ISimpleResourceLoader
@@ -90,6 +93,9 @@ private:
 
 	std::string mountPoint;
 
+	/** Memory mapping of the whole archive or nullptr if archive is read via file streams */
+	std::shared_ptr<const CMappedFile> mappedArchive;
+
 	/** Holds all entries of the archive file. An entry can be accessed via the entry name. **/
 	std::unordered_map<ResourceID, ArchiveEntry> entries;
 };
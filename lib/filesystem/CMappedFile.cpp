@@ -0,0 +1,184 @@
+/*
+ * CMappedFile.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CMappedFile.h"
+
+#include "CCompressedStream.h"
+#include "CMemoryStream.h"
+
+#include <zlib.h>
+
+namespace bip = boost::interprocess;
+
+CMappedFile::CMappedFile(const boost::filesystem::path & file)
+{
+	try
+	{
+		mapping = bip::file_mapping(file.string().c_str(), bip::read_only);
+		region = bip::mapped_region(mapping, bip::read_only);
+	}
+	catch(bip::interprocess_exception & e)
+	{
+		throw std::runtime_error("Failed to map file " + file.string() + ": " + e.what());
+	}
+}
+
+const ui8 * CMappedFile::getData() const
+{
+	return static_cast<const ui8 *>(region.get_address());
+}
+
+si64 CMappedFile::getSize() const
+{
+	return region.get_size();
+}
+
+CMappedFileStream::CMappedFileStream(std::shared_ptr<const CMappedFile> file, si64 start, si64 size):
+	file(std::move(file)),
+	data(nullptr),
+	size(size),
+	position(0)
+{
+	if(start < 0 || size < 0 || start + size > this->file->getSize())
+		throw std::runtime_error("Stream is out of bounds of mapped file!");
+
+	data = this->file->getData() + start;
+}
+
+si64 CMappedFileStream::read(ui8 * data, si64 size)
+{
+	si64 toRead = std::min(this->size - position, size);
+	std::copy(this->data + position, this->data + position + toRead, data);
+	position += toRead;
+	return toRead;
+}
+
+si64 CMappedFileStream::seek(si64 position)
+{
+	this->position = position;
+	vstd::abetween(this->position, 0, size);
+	return this->position;
+}
+
+si64 CMappedFileStream::tell()
+{
+	return position;
+}
+
+si64 CMappedFileStream::skip(si64 delta)
+{
+	si64 origin = position;
+	seek(position + delta);
+	return position - origin;
+}
+
+si64 CMappedFileStream::getSize()
+{
+	return size;
+}
+
+const ui8 * CMappedFileStream::getData() const
+{
+	return data;
+}
+
+CMappedCompressedStream::CMappedCompressedStream(std::shared_ptr<const CMappedFile> file, si64 start, si64 compressedSize, si64 decompressedSize):
+	file(std::move(file)),
+	compressedData(nullptr),
+	compressedSize(compressedSize),
+	decompressedSize(decompressedSize),
+	position(0)
+{
+	if(start < 0 || compressedSize < 0 || start + compressedSize > this->file->getSize())
+		throw std::runtime_error("Compressed stream is out of bounds of mapped file!");
+
+	compressedData = this->file->getData() + start;
+}
+
+CMappedCompressedStream::~CMappedCompressedStream() = default;
+
+si64 CMappedCompressedStream::read(ui8 * data, si64 size)
+{
+	// fast path - whole entry is requested, inflate directly into destination
+	if(position == 0 && size >= decompressedSize && !fallback)
+	{
+		inflateInto(data);
+		position = decompressedSize;
+		return decompressedSize;
+	}
+
+	si64 readSize = getFallback().read(data, std::min(size, decompressedSize - position));
+	position += readSize;
+	return readSize;
+}
+
+si64 CMappedCompressedStream::seek(si64 position)
+{
+	this->position = position;
+	vstd::abetween(this->position, 0, decompressedSize);
+	if(fallback)
+		fallback->seek(this->position);
+	return this->position;
+}
+
+si64 CMappedCompressedStream::tell()
+{
+	return position;
+}
+
+si64 CMappedCompressedStream::skip(si64 delta)
+{
+	si64 origin = position;
+	seek(position + delta);
+	return position - origin;
+}
+
+si64 CMappedCompressedStream::getSize()
+{
+	return decompressedSize;
+}
+
+void CMappedCompressedStream::inflateInto(ui8 * dest)
+{
+	z_stream state;
+	state.zalloc = Z_NULL;
+	state.zfree = Z_NULL;
+	state.opaque = Z_NULL;
+	state.next_in = const_cast<Bytef *>(compressedData);
+	state.avail_in = compressedSize;
+	state.next_out = dest;
+	state.avail_out = decompressedSize;
+
+	if(inflateInit(&state) != Z_OK)
+		throw std::runtime_error("Failed to initialize inflate!\n");
+
+	int ret = inflate(&state, Z_FINISH);
+	std::string message = state.msg ? state.msg : "";
+	inflateEnd(&state);
+
+	if(ret != Z_STREAM_END || static_cast<si64>(state.total_out) != decompressedSize)
+	{
+		if(message.empty())
+			throw std::runtime_error("Decompression error. Return code was " + boost::lexical_cast<std::string>(ret));
+		else
+			throw std::runtime_error("Decompression error: " + message);
+	}
+}
+
+CCompressedStream & CMappedCompressedStream::getFallback()
+{
+	if(!fallback)
+	{
+		auto compressed = make_unique<CMemoryStream>(compressedData, compressedSize);
+		fallback = make_unique<CCompressedStream>(std::move(compressed), false, decompressedSize);
+		fallback->seek(position);
+	}
+	return *fallback;
+}
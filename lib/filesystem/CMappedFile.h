@@ -0,0 +1,122 @@
+/*
+ * CMappedFile.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "CInputStream.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+class CCompressedStream;
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Shared between all streams created out of it, mapping is released once last stream is destroyed.
+ */
+class DLL_LINKAGE CMappedFile : public boost::noncopyable
+{
+public:
+	/**
+	 * C-tor. Maps whole file into address space of the process.
+	 *
+	 * @param file Path to the file to map.
+	 *
+	 * @throws std::runtime_error if the file can't be mapped
+	 */
+	CMappedFile(const boost::filesystem::path & file);
+
+	/** Pointer to the first byte of the mapped file */
+	const ui8 * getData() const;
+
+	/** Size of the mapped file in bytes */
+	si64 getSize() const;
+
+private:
+	boost::interprocess::file_mapping mapping;
+	boost::interprocess::mapped_region region;
+};
+
+/**
+ * Zero-copy stream over a part of memory-mapped file.
+ */
+class DLL_LINKAGE CMappedFileStream : public CInputStream
+{
+public:
+	/**
+	 * C-tor.
+	 *
+	 * @param file Mapped file. Will be kept alive as long as this stream exists.
+	 * @param start Offset of the first byte of the stream in the file.
+	 * @param size Size of the stream in bytes.
+	 */
+	CMappedFileStream(std::shared_ptr<const CMappedFile> file, si64 start, si64 size);
+
+	si64 read(ui8 * data, si64 size) override;
+	si64 seek(si64 position) override;
+	si64 tell() override;
+	si64 skip(si64 delta) override;
+	si64 getSize() override;
+
+	/** Pointer to the beginning of stream data. Valid as long as this stream exists */
+	const ui8 * getData() const;
+
+private:
+	std::shared_ptr<const CMappedFile> file;
+	const ui8 * data;
+	si64 size;
+	si64 position;
+};
+
+/**
+ * Stream over zlib-compressed part of memory-mapped file (e.g. compressed .lod entry).
+ *
+ * Reading whole stream at once (e.g. via readAll) inflates data straight into caller-provided buffer
+ * without any intermediate copies. Partial reads and seeks fall back to CCompressedStream.
+ */
+class DLL_LINKAGE CMappedCompressedStream : public CInputStream
+{
+public:
+	/**
+	 * C-tor.
+	 *
+	 * @param file Mapped file. Will be kept alive as long as this stream exists.
+	 * @param start Offset of compressed data in the file.
+	 * @param compressedSize Size of compressed data in bytes.
+	 * @param decompressedSize Size of data after decompression in bytes.
+	 */
+	CMappedCompressedStream(std::shared_ptr<const CMappedFile> file, si64 start, si64 compressedSize, si64 decompressedSize);
+	~CMappedCompressedStream();
+
+	/**
+	 * Reads n bytes from the stream into the data buffer.
+	 *
+	 * @throws std::runtime_error if the decompression was not successful
+	 */
+	si64 read(ui8 * data, si64 size) override;
+	si64 seek(si64 position) override;
+	si64 tell() override;
+	si64 skip(si64 delta) override;
+	si64 getSize() override;
+
+private:
+	/// Inflates whole compressed data into dest which must have space for at least decompressedSize bytes
+	void inflateInto(ui8 * dest);
+
+	/// Creates fallback stream for partial reads, positioned at current position
+	CCompressedStream & getFallback();
+
+	std::shared_ptr<const CMappedFile> file;
+	const ui8 * compressedData;
+	si64 compressedSize;
+	si64 decompressedSize;
+	si64 position;
+
+	std::unique_ptr<CCompressedStream> fallback;
+};
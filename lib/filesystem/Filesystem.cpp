@@ -101,8 +101,9 @@ void CFilesystemGenerator::loadArchive(const std::string &mountPoint, const Json
 {
 	std::string URI = prefix + config["path"].String();
 	auto filename = CResourceHandler::get("initial")->getResourceName(ResourceID(URI, archiveType));
+	bool memoryMapped = config["mmap"].isNull() || config["mmap"].Bool();
 	if (filename)
-		filesystem->addLoader(new CArchiveLoader(mountPoint, *filename), false);
+		filesystem->addLoader(new CArchiveLoader(mountPoint, *filename, memoryMapped), false);
 }
 
 void CFilesystemGenerator::loadJsonMap(const std::string &mountPoint, const JsonNode & config)
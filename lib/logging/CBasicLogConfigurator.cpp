@@ -31,6 +31,9 @@ void CBasicLogConfigurator::configure()
 		if(loggingNode.isNull())
 			throw std::runtime_error("Settings haven't been loaded.");
 
+		// Targets are replaced below, write pending records with old ones first
+		CLogManager::get().setAsynchronous(false);
+
 		// Configure loggers
 		const JsonNode & loggers = loggingNode["loggers"];
 		if(!loggers.isNull())
@@ -87,6 +90,8 @@ void CBasicLogConfigurator::configure()
 		}
 		CLogger::getGlobalLogger()->addTarget(std::move(fileTarget));
 		appendToLogFile = true;
+
+		CLogManager::get().setAsynchronous(loggingNode["asynchronous"].Bool());
 	}
 	catch(const std::exception & e)
 	{
@@ -10,6 +10,10 @@
 #include "StdInc.h"
 #include "CLogger.h"
 
+#include "../CThreadHelper.h"
+
+#include <boost/lockfree/queue.hpp>
+
 #ifdef VCMI_ANDROID
 #include <android/log.h>
 
@@ -35,6 +39,8 @@ namespace ELogLevel
 namespace vstd
 {
 
+CLogMessage::~CLogMessage() = default;
+
 CLoggerBase::~CLoggerBase() = default;
 
 
@@ -51,6 +57,191 @@ CTraceLogger::~CTraceLogger()
 
 }//namespace vstd
 
+namespace
+{
+/// Message which is already rendered
+class CPlainLogMessage : public vstd::CLogMessage
+{
+public:
+	explicit CPlainLogMessage(std::string message) : message(std::move(message)) { }
+
+	std::string str() const override
+	{
+		return message;
+	}
+
+private:
+	std::string message;
+};
+}
+
+/// Renders and writes log records on a separate thread.
+/// Records are passed through bounded lock-free queue, if it is full the record is dropped and counted.
+class CLogWriter : public boost::noncopyable
+{
+public:
+	CLogWriter();
+	~CLogWriter();
+
+	void start();
+	/// Stops logging thread and writes all records which are still pending
+	void stop();
+
+	void push(const CLogger * logger, ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message);
+	/// Waits until all records pushed so far are written
+	void flush();
+
+	ui64 getDropped() const;
+
+private:
+	static const size_t QUEUE_CAPACITY = 4096;
+
+	struct Entry
+	{
+		const CLogger * logger;
+		ELogLevel::ELogLevel level;
+		boost::posix_time::ptime timeStamp;
+		boost::thread::id threadId;
+		std::unique_ptr<vstd::CLogMessage> message;
+	};
+
+	void run();
+	void writePending();
+	void reportDropped();
+
+	boost::lockfree::queue<Entry *, boost::lockfree::capacity<QUEUE_CAPACITY>> queue;
+	std::atomic<bool> terminating;
+	std::atomic<bool> sleeping;
+	std::atomic<ui64> pushed;
+	std::atomic<ui64> written;
+	std::atomic<ui64> dropped;
+	ui64 reportedDropped;
+
+	boost::mutex mx;
+	boost::condition_variable wakeUp;
+	boost::condition_variable recordsWritten;
+	boost::thread thread;
+	boost::thread::id threadId;
+};
+
+CLogWriter::CLogWriter()
+	: terminating(true), sleeping(false), pushed(0), written(0), dropped(0), reportedDropped(0)
+{
+}
+
+CLogWriter::~CLogWriter()
+{
+	stop();
+}
+
+void CLogWriter::start()
+{
+	if(thread.joinable())
+		return;
+
+	terminating = false;
+	thread = boost::thread(&CLogWriter::run, this);
+	threadId = thread.get_id();
+}
+
+void CLogWriter::stop()
+{
+	if(thread.joinable())
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			terminating = true;
+		}
+		wakeUp.notify_one();
+		recordsWritten.notify_all();
+		thread.join();
+	}
+	writePending();
+	reportDropped();
+}
+
+void CLogWriter::push(const CLogger * logger, ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message)
+{
+	auto entry = new Entry{logger, level, boost::posix_time::microsec_clock::local_time(), boost::this_thread::get_id(), std::move(message)};
+	if(!queue.bounded_push(entry))
+	{
+		delete entry;
+		dropped++;
+		return;
+	}
+
+	// logging thread announces that it is going to sleep before it checks for pending records for the last time,
+	// so either it sees this record or we see that it sleeps; busy thread is not notified at all
+	++pushed;
+	if(sleeping)
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		wakeUp.notify_one();
+	}
+}
+
+void CLogWriter::flush()
+{
+	if(terminating || boost::this_thread::get_id() == threadId)
+		return;
+
+	const ui64 target = pushed;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	while(written < target && !terminating)
+		recordsWritten.wait(lock);
+}
+
+ui64 CLogWriter::getDropped() const
+{
+	return dropped;
+}
+
+void CLogWriter::run()
+{
+	setThreadName("CLogWriter::run");
+
+	while(true)
+	{
+		writePending();
+		reportDropped();
+
+		boost::unique_lock<boost::mutex> lock(mx);
+		recordsWritten.notify_all();
+
+		sleeping = true;
+		while(written >= pushed && !terminating) //records popped before they are counted are written already
+			wakeUp.wait(lock);
+		sleeping = false;
+
+		if(terminating)
+			break;
+	}
+}
+
+void CLogWriter::writePending()
+{
+	Entry * entry;
+	while(queue.pop(entry))
+	{
+		std::unique_ptr<Entry> holder(entry);
+		entry->logger->callTargets(LogRecord(entry->logger->getDomain(), entry->level, entry->message->str(),
+			entry->timeStamp, boost::lexical_cast<std::string>(entry->threadId)));
+		written++;
+	}
+}
+
+void CLogWriter::reportDropped()
+{
+	const ui64 currentDropped = dropped;
+	if(currentDropped == reportedDropped)
+		return;
+
+	const std::string message = boost::str(boost::format("Logging queue was full, %d log records were dropped") % (currentDropped - reportedDropped));
+	reportedDropped = currentDropped;
+	CLogger::getGlobalLogger()->callTargets(LogRecord(CLoggerDomain(CLoggerDomain::DOMAIN_GLOBAL), ELogLevel::WARN, message));
+}
+
 const std::string CLoggerDomain::DOMAIN_GLOBAL = "global";
 
 CLoggerDomain::CLoggerDomain(std::string name) : name(std::move(name))
@@ -123,16 +314,26 @@ CLogger::CLogger(const CLoggerDomain & domain) : domain(domain)
 		level = ELogLevel::NOT_SET;
 		parent = getLogger(domain.getParent());
 	}
+	updateEffectiveLevel();
 }
 
 void CLogger::log(ELogLevel::ELogLevel level, const std::string & message) const
 {
-	if(getEffectiveLevel() <= level)
+	if(!isLevelEnabled(level))
+		return;
+
+	CLogManager & manager = CLogManager::get();
+	if(manager.isAsynchronous())
+		manager.write(this, level, make_unique<CPlainLogMessage>(message));
+	else
 		callTargets(LogRecord(domain, level, message));
 }
 
 void CLogger::log(ELogLevel::ELogLevel level, const boost::format & fmt) const
 {
+	if(!isLevelEnabled(level))
+		return;
+
 	try
 	{
 		log(level, fmt.str());
@@ -143,17 +344,25 @@ void CLogger::log(ELogLevel::ELogLevel level, const boost::format & fmt) const
 	}
 }
 
+void CLogger::log(ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message) const
+{
+	if(isLevelEnabled(level))
+		CLogManager::get().write(this, level, std::move(message));
+}
+
 ELogLevel::ELogLevel CLogger::getLevel() const
 {
-	TLockGuard _(mx);
 	return level;
 }
 
 void CLogger::setLevel(ELogLevel::ELogLevel level)
 {
-	TLockGuard _(mx);
-	if (!domain.isGlobalDomain() || level != ELogLevel::NOT_SET)
-		this->level = level;
+	if (domain.isGlobalDomain() && level == ELogLevel::NOT_SET)
+		return;
+
+	this->level = level;
+	updateEffectiveLevel();
+	CLogManager::get().updateEffectiveLevels(); // levels of child loggers may depend on this one
 }
 
 const CLoggerDomain & CLogger::getDomain() const { return domain; }
@@ -165,13 +374,23 @@ void CLogger::addTarget(std::unique_ptr<ILogTarget> && target)
 }
 
 ELogLevel::ELogLevel CLogger::getEffectiveLevel() const
+{
+	return effectiveLevel;
+}
+
+void CLogger::updateEffectiveLevel()
 {
 	for(const CLogger * logger = this; logger != nullptr; logger = logger->parent)
+	{
 		if(logger->getLevel() != ELogLevel::NOT_SET)
-			return logger->getLevel();
+		{
+			effectiveLevel = logger->getLevel();
+			return;
+		}
+	}
 
 	// This shouldn't be reached, as the root logger must have set a log level
-	return ELogLevel::INFO;
+	effectiveLevel = ELogLevel::INFO;
 }
 
 void CLogger::callTargets(const LogRecord & record) const
@@ -188,8 +407,9 @@ void CLogger::clearTargets()
 	targets.clear();
 }
 
-bool CLogger::isDebugEnabled() const { return getEffectiveLevel() <= ELogLevel::DEBUG; }
-bool CLogger::isTraceEnabled() const { return getEffectiveLevel() <= ELogLevel::TRACE; }
+bool CLogger::isLevelEnabled(ELogLevel::ELogLevel level) const { return getEffectiveLevel() <= level; }
+bool CLogger::isDebugEnabled() const { return isLevelEnabled(ELogLevel::DEBUG); }
+bool CLogger::isTraceEnabled() const { return isLevelEnabled(ELogLevel::TRACE); }
 
 CLogManager & CLogManager::get()
 {
@@ -198,9 +418,11 @@ CLogManager & CLogManager::get()
 	return instance;
 }
 
-CLogManager::CLogManager() = default;
+CLogManager::CLogManager() : asynchronous(false), activeWrites(0) { }
 CLogManager::~CLogManager()
 {
+	setAsynchronous(false);
+	writer.reset();
 	for(auto & i : loggers)
 		delete i.second;
 }
@@ -231,6 +453,76 @@ std::vector<std::string> CLogManager::getRegisteredDomains() const
 	return std::move(domains);
 }
 
+void CLogManager::updateEffectiveLevels()
+{
+	TLockGuard _(mx);
+	for(auto & i : loggers)
+		i.second->updateEffectiveLevel();
+}
+
+void CLogManager::setAsynchronous(bool asynchronous)
+{
+	TLockGuard _(writerMx);
+	if(asynchronous)
+	{
+		if(!writer)
+			writer = make_unique<CLogWriter>();
+		writer->start();
+		this->asynchronous = true;
+	}
+	else if(writer)
+	{
+		this->asynchronous = false;
+		// records pushed after final write of pending records would be lost, wait for threads which may still push
+		while(activeWrites != 0)
+			boost::this_thread::yield();
+		writer->stop();
+	}
+}
+
+bool CLogManager::isAsynchronous() const
+{
+	return asynchronous;
+}
+
+void CLogManager::flush()
+{
+	++activeWrites;
+	if(asynchronous)
+		writer->flush();
+	--activeWrites;
+}
+
+ui64 CLogManager::getDroppedRecords() const
+{
+	return writer ? writer->getDropped() : 0;
+}
+
+void CLogManager::write(const CLogger * logger, ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message)
+{
+	// asynchronous mode is checked only after announcing the write, so switch to synchronous mode either
+	// is seen here or waits until the record is pushed and then writes it along with other pending records
+	++activeWrites;
+	bool pushed = false;
+	if(asynchronous)
+	{
+		// errors are often followed by crash or exit, write them right away (after all pending records) and never drop them
+		if(level < ELogLevel::ERROR)
+		{
+			writer->push(logger, level, std::move(message));
+			pushed = true;
+		}
+		else
+		{
+			writer->flush();
+		}
+	}
+	--activeWrites;
+
+	if(!pushed)
+		logger->callTargets(LogRecord(logger->getDomain(), level, message->str()));
+}
+
 CLogFormatter::CLogFormatter() : CLogFormatter("%m") { }
 
 CLogFormatter::CLogFormatter(const std::string & pattern) : pattern(pattern)
@@ -15,6 +15,7 @@
 class CLogger;
 struct LogRecord;
 class ILogTarget;
+class CLogWriter;
 
 
 namespace ELogLevel
@@ -58,23 +59,31 @@ public:
 
 	void log(ELogLevel::ELogLevel level, const std::string & message) const override;
 	void log(ELogLevel::ELogLevel level, const boost::format & fmt) const override;
+	void log(ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message) const override;
 
 	void addTarget(std::unique_ptr<ILogTarget> && target);
 	void clearTargets();
 
+	bool isLevelEnabled(ELogLevel::ELogLevel level) const override;
+
 	/// Returns true if a debug/trace log message will be logged, false if not.
 	/// Useful if performance is important and concatenating the log message is a expensive task.
 	bool isDebugEnabled() const override;
 	bool isTraceEnabled() const override;
 
 private:
+	friend class CLogManager;
+	friend class CLogWriter;
+
 	explicit CLogger(const CLoggerDomain & domain);
-	inline ELogLevel::ELogLevel getEffectiveLevel() const; /// Returns the log level applied on this logger whether directly or indirectly.
-	inline void callTargets(const LogRecord & record) const;
+	ELogLevel::ELogLevel getEffectiveLevel() const; /// Returns the log level applied on this logger whether directly or indirectly.
+	void updateEffectiveLevel(); /// Recalculates cached effective level, has to be called whenever level of this logger or of its parents changes.
+	void callTargets(const LogRecord & record) const;
 
 	CLoggerDomain domain;
 	CLogger * parent;
-	ELogLevel::ELogLevel level;
+	std::atomic<ELogLevel::ELogLevel> level;
+	std::atomic<ELogLevel::ELogLevel> effectiveLevel;
 	std::vector<std::unique_ptr<ILogTarget> > targets;
 	mutable boost::mutex mx;
 	static boost::recursive_mutex smx;
@@ -94,11 +103,31 @@ public:
 	CLogger * getLogger(const CLoggerDomain & domain); /// Returns a logger or nullptr if no one is registered for the given domain.
 	std::vector<std::string> getRegisteredDomains() const;
 
+	/// Recalculates cached effective levels of all loggers.
+	void updateEffectiveLevels();
+
+	/// Enables or disables writing of log records on a separate thread. Disabling waits until all pending records are written.
+	void setAsynchronous(bool asynchronous);
+	bool isAsynchronous() const;
+	/// Waits until all pending records are written. Does nothing in synchronous mode.
+	void flush();
+	/// Returns the number of records that were dropped because the queue of pending records was full.
+	ui64 getDroppedRecords() const;
+
 private:
+	friend class CLogger;
+
 	CLogManager();
 	virtual ~CLogManager();
 
+	/// Writes the message with targets of the given logger, directly or via logging thread.
+	void write(const CLogger * logger, ELogLevel::ELogLevel level, std::unique_ptr<vstd::CLogMessage> message);
+
 	std::map<std::string, CLogger *> loggers;
+	std::unique_ptr<CLogWriter> writer; /// Created on first switch to asynchronous mode, lives until shutdown.
+	std::atomic<bool> asynchronous;
+	std::atomic<int> activeWrites; /// Number of threads that are passing records to writer, switch to synchronous mode waits for them.
+	boost::mutex writerMx;
 	mutable boost::mutex mx;
 	static boost::recursive_mutex smx;
 };
@@ -113,6 +142,14 @@ struct DLL_LINKAGE LogRecord
 		timeStamp(boost::posix_time::microsec_clock::local_time()),
 		threadId(boost::lexical_cast<std::string>(boost::this_thread::get_id())) { }
 
+	LogRecord(const CLoggerDomain & domain, ELogLevel::ELogLevel level, std::string && message,
+		const boost::posix_time::ptime & timeStamp, std::string && threadId)
+		: domain(domain),
+		level(level),
+		message(std::move(message)),
+		timeStamp(timeStamp),
+		threadId(std::move(threadId)) { }
+
 	CLoggerDomain domain;
 	ELogLevel::ELogLevel level;
 	std::string message;
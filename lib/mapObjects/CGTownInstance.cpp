@@ -513,36 +513,50 @@ int CGTownInstance::getHordeLevel(const int & HID)  const//HID - 0 or 1; returns
 
 int CGTownInstance::creatureGrowth(const int & level) const
 {
-	return getGrowthInfo(level).totalGrowth();
+	return calculateGrowth(level, nullptr);
 }
 
 GrowthInfo CGTownInstance::getGrowthInfo(int level) const
 {
 	GrowthInfo ret;
+	calculateGrowth(level, &ret);
+	return ret;
+}
 
+int CGTownInstance::calculateGrowth(int level, GrowthInfo * details) const
+{
 	if (level<0 || level >=GameConstants::CREATURES_PER_TOWN)
-		return ret;
+		return 0;
 	if (creatures[level].second.empty())
-		return ret; //no dwelling
+		return 0; //no dwelling
 
 	const CCreature *creature = VLC->creh->creatures[creatures[level].second.back()];
 	const int base = creature->growth;
 	int castleBonus = 0;
+	int total = base;
 
-	ret.entries.push_back(GrowthInfo::Entry(VLC->generaltexth->allTexts[590], base));// \n\nBasic growth %d"
+	if(details)
+		details->entries.push_back(GrowthInfo::Entry(VLC->generaltexth->allTexts[590], base));// \n\nBasic growth %d"
+
+	auto addBuilding = [&](BuildingID building, int count)
+	{
+		total += count;
+		if(details)
+			details->entries.push_back(GrowthInfo::Entry(subID, building, count));
+	};
 
 	if (hasBuilt(BuildingID::CASTLE))
-		ret.entries.push_back(GrowthInfo::Entry(subID, BuildingID::CASTLE, castleBonus = base));
+		addBuilding(BuildingID::CASTLE, castleBonus = base);
 	else if (hasBuilt(BuildingID::CITADEL))
-		ret.entries.push_back(GrowthInfo::Entry(subID, BuildingID::CITADEL, castleBonus = base / 2));
+		addBuilding(BuildingID::CITADEL, castleBonus = base / 2);
 
 	if(town->hordeLvl.at(0) == level)//horde 1
 		if(hasBuilt(BuildingID::HORDE_1))
-			ret.entries.push_back(GrowthInfo::Entry(subID, BuildingID::HORDE_1, creature->hordeGrowth));
+			addBuilding(BuildingID::HORDE_1, creature->hordeGrowth);
 
 	if(town->hordeLvl.at(1) == level)//horde 2
 		if(hasBuilt(BuildingID::HORDE_2))
-			ret.entries.push_back(GrowthInfo::Entry(subID, BuildingID::HORDE_2, creature->hordeGrowth));
+			addBuilding(BuildingID::HORDE_2, creature->hordeGrowth);
 
 	int dwellingBonus = 0;
 	if(const PlayerState *p = cb->getPlayer(tempOwner, false))
@@ -551,22 +565,39 @@ GrowthInfo CGTownInstance::getGrowthInfo(int level) const
 	}
 
 	if(dwellingBonus)
-		ret.entries.push_back(GrowthInfo::Entry(VLC->generaltexth->allTexts[591], dwellingBonus));// \nExternal dwellings %+d
+	{
+		total += dwellingBonus;
+		if(details)
+			details->entries.push_back(GrowthInfo::Entry(VLC->generaltexth->allTexts[591], dwellingBonus));// \nExternal dwellings %+d
+	}
 
 	//other *-of-legion-like bonuses (%d to growth cumulative with grail)
-	TBonusListPtr bonuses = getBonuses(Selector::type(Bonus::CREATURE_GROWTH).And(Selector::subtype(level)));
+	std::stringstream growthCachingStr;
+	growthCachingStr << "type_" << Bonus::CREATURE_GROWTH << "s_" << level;
+	TBonusListPtr bonuses = getBonuses(Selector::typeSubtype(Bonus::CREATURE_GROWTH, level), growthCachingStr.str());
 	for(const std::shared_ptr<Bonus> b : *bonuses)
-		ret.entries.push_back(GrowthInfo::Entry(b->val, b->Description()));
+	{
+		total += b->val;
+		if(details)
+			details->entries.push_back(GrowthInfo::Entry(b->val, b->Description()));
+	}
 
 	//statue-of-legion-like bonus: % to base+castle
-	TBonusListPtr bonuses2 = getBonuses(Selector::type(Bonus::CREATURE_GROWTH_PERCENT));
+	std::stringstream percentCachingStr;
+	percentCachingStr << "type_" << Bonus::CREATURE_GROWTH_PERCENT << "s_" << -1;
+	TBonusListPtr bonuses2 = getBonuses(Selector::type(Bonus::CREATURE_GROWTH_PERCENT), percentCachingStr.str());
 	for(const std::shared_ptr<Bonus> b : *bonuses2)
-		ret.entries.push_back(GrowthInfo::Entry(b->val * (base + castleBonus) / 100, b->Description()));
+	{
+		const int count = b->val * (base + castleBonus) / 100;
+		total += count;
+		if(details)
+			details->entries.push_back(GrowthInfo::Entry(count, b->Description()));
+	}
 
 	if(hasBuilt(BuildingID::GRAIL)) //grail - +50% to ALL (so far added) growth
-		ret.entries.push_back(GrowthInfo::Entry(subID, BuildingID::GRAIL, ret.totalGrowth() / 2));
+		addBuilding(BuildingID::GRAIL, total / 2);
 
-	return ret;
+	return total;
 }
 
 int CGTownInstance::getDwellingBonus(const std::vector<CreatureID>& creatureIds, const std::vector<ConstTransitivePtr<CGDwelling> >& dwellings) const
@@ -586,23 +617,26 @@ TResources CGTownInstance::dailyIncome() const
 {
 	TResources ret;
 
-	for (auto & p : town->buildings)
+	//only built buildings can produce, and only if their upgrade (which produces instead) is not built
+	for (const BuildingID & id : builtBuildings)
 	{
-		BuildingID buildingUpgrade;
+		auto building = town->buildings.find(id);
+		if (building == town->buildings.end() || !building->second->produce.nonZero())
+			continue;
 
-		for (auto & p2 : town->buildings)
+		bool upgraded = false;
+		for (const BuildingID & other : builtBuildings)
 		{
-			if (p2.second->upgrade == p.first)
+			auto otherBuilding = town->buildings.find(other);
+			if (otherBuilding != town->buildings.end() && otherBuilding->second->upgrade == id)
 			{
-				buildingUpgrade = p2.first;
+				upgraded = true;
+				break;
 			}
 		}
 
-		if (!hasBuilt(buildingUpgrade)&&(hasBuilt(p.first)))
-		{
-			ret += p.second->produce;
-		}
-
+		if (!upgraded)
+			ret += building->second->produce;
 	}
 
 	return ret;
@@ -258,8 +258,8 @@ public:
 	int hallLevel() const; // -1 - none, 0 - village, 1 - town, 2 - city, 3 - capitol
 	int mageGuildLevel() const; // -1 - none, 0 - village, 1 - town, 2 - city, 3 - capitol
 	int getHordeLevel(const int & HID) const; //HID - 0 or 1; returns creature level or -1 if that horde structure is not present
-	int creatureGrowth(const int & level) const;
-	GrowthInfo getGrowthInfo(int level) const;
+	int creatureGrowth(const int & level) const; //weekly growth without building its description
+	GrowthInfo getGrowthInfo(int level) const; //weekly growth with description of each component, for UI
 	bool hasFort() const;
 	bool hasCapitol() const;
 	//checks if building is constructed and town has same subID
@@ -295,5 +295,6 @@ protected:
 	void setPropertyDer(ui8 what, ui32 val) override;
 	void serializeJsonOptions(JsonSerializeFormat & handler) override;
 private:
+	int calculateGrowth(int level, GrowthInfo * details) const; //fills details only if not null
 	int getDwellingBonus(const std::vector<CreatureID>& creatureIds, const std::vector<ConstTransitivePtr<CGDwelling> >& dwellings) const;
 };
@@ -351,6 +351,53 @@ void TerrainViewPattern::WeightedRule::setNative()
 	dirtRule = sandRule = transitionRule = nativeStrongRule = anyRule = false; //no idea what they mean, but look mutually exclusive
 }
 
+bool TerrainViewPattern::WeightedRule::validate(ETerrainGroup::ETerrainGroup centerTerGroup, bool isAlien, bool isSand, std::string & transitionReplacement) const
+{
+	bool nativeTestOk, nativeTestStrongOk;
+	nativeTestOk = nativeTestStrongOk = (isNativeStrong() || isNativeRule()) && !isAlien;
+	if(centerTerGroup == ETerrainGroup::NORMAL)
+	{
+		bool dirtTestOk = (isDirtRule() || isTransition()) && isAlien && !isSand;
+		bool sandTestOk = (isSandRule() || isTransition()) && isSand;
+
+		if (transitionReplacement.empty() && isTransition() && (dirtTestOk || sandTestOk))
+		{
+			transitionReplacement = dirtTestOk ? TerrainViewPattern::RULE_DIRT : TerrainViewPattern::RULE_SAND;
+		}
+		if (isTransition())
+		{
+			return (dirtTestOk && transitionReplacement != TerrainViewPattern::RULE_SAND) ||
+					(sandTestOk && transitionReplacement != TerrainViewPattern::RULE_DIRT);
+		}
+		else
+		{
+			return isAnyRule() || dirtTestOk || sandTestOk || nativeTestOk;
+		}
+	}
+	else if(centerTerGroup == ETerrainGroup::DIRT)
+	{
+		nativeTestOk = isNativeRule() && !isSand;
+		bool sandTestOk = (isSandRule() || isTransition()) && isSand;
+		return isAnyRule() || sandTestOk || nativeTestOk || nativeTestStrongOk;
+	}
+	else if(centerTerGroup == ETerrainGroup::SAND)
+	{
+		return true;
+	}
+	else if(centerTerGroup == ETerrainGroup::WATER || centerTerGroup == ETerrainGroup::ROCK)
+	{
+		bool sandTestOk = (isSandRule() || isTransition()) && isAlien;
+		return isAnyRule() || sandTestOk || nativeTestOk;
+	}
+	return false;
+}
+
+CTerrainViewPatternConfig::PatternMatch::PatternMatch(EResult result)
+	: result(result), pattern(-1), flip(0)
+{
+
+}
+
 CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 {
 	const JsonNode config(ResourceID("config/terrainViewPatterns.json"));
@@ -533,6 +580,120 @@ void CTerrainViewPatternConfig::flipPattern(TerrainViewPattern & pattern, int fl
 	}
 }
 
+CTerrainViewPatternConfig::PatternMatch CTerrainViewPatternConfig::findTerrainViewPattern(ETerrainGroup::ETerrainGroup terGroup, TNeighbourhoodKey key) const
+{
+	const auto & patterns = getTerrainViewPatternsForGroup(terGroup);
+	return lookupPatterns(patterns.data(), patterns.size(), terGroup, "", key);
+}
+
+CTerrainViewPatternConfig::PatternMatch CTerrainViewPatternConfig::findTerrainTypePattern(ETerrainGroup::ETerrainGroup terGroup, const std::string & id, TNeighbourhoodKey key) const
+{
+	return lookupPatterns(getTerrainTypePatternById(id), 1, terGroup, id, key);
+}
+
+CTerrainViewPatternConfig::PatternMatch CTerrainViewPatternConfig::lookupPatterns(const TVPVector * patterns, size_t count, ETerrainGroup::ETerrainGroup terGroup, const std::string & id, TNeighbourhoodKey key) const
+{
+	boost::mutex::scoped_lock lock(matchTablesMutex);
+
+	auto & table = matchTables[std::make_pair(terGroup, id)];
+	auto it = table.find(key);
+	if(it == table.end())
+		it = table.insert(std::make_pair(key, matchPatterns(patterns, count, terGroup, key))).first;
+	return it->second;
+}
+
+CTerrainViewPatternConfig::PatternMatch CTerrainViewPatternConfig::matchPatterns(const TVPVector * patterns, size_t count, ETerrainGroup::ETerrainGroup terGroup, TNeighbourhoodKey key) const
+{
+	std::array<ETerrainViewCell::ETerrainViewCell, 9> cells;
+	cells[4] = ETerrainViewCell::NATIVE;
+	for(int i = 0; i < 9; ++i)
+	{
+		if(i == 4)
+			continue;
+		cells[i] = static_cast<ETerrainViewCell::ETerrainViewCell>(key % ETerrainViewCell::COUNT);
+		key /= ETerrainViewCell::COUNT;
+	}
+
+	for(size_t k = 0; k < count; ++k)
+	{
+		for(int flip = 0; flip < 4; ++flip)
+		{
+			auto match = matchPattern(patterns[k].at(flip), terGroup, cells);
+			if(match.result == PatternMatch::MATCH)
+			{
+				match.pattern = k;
+				match.flip = flip;
+			}
+			if(match.result != PatternMatch::NO_MATCH)
+				return match;
+		}
+	}
+	return PatternMatch(PatternMatch::NO_MATCH);
+}
+
+CTerrainViewPatternConfig::PatternMatch CTerrainViewPatternConfig::matchPattern(const TerrainViewPattern & pattern, ETerrainGroup::ETerrainGroup terGroup, const std::array<ETerrainViewCell::ETerrainViewCell, 9> & cells) const
+{
+	// Mirrors CDrawTerrainOperation::validateTerrainViewInner, but works only with classified neighbour cells
+	const bool centerIsSand = terGroup == ETerrainGroup::SAND || terGroup == ETerrainGroup::WATER || terGroup == ETerrainGroup::ROCK;
+	int totalPoints = 0;
+	std::string transitionReplacement;
+
+	for(int i = 0; i < 9; ++i)
+	{
+		if(i == 4)
+		{
+			continue;
+		}
+
+		const auto cell = cells[i];
+		const bool isInTheMap = cell == ETerrainViewCell::NATIVE || cell == ETerrainViewCell::ALIEN || cell == ETerrainViewCell::ALIEN_SAND;
+		const bool isAlien = cell == ETerrainViewCell::ALIEN || cell == ETerrainViewCell::ALIEN_SAND;
+		const bool isSand = cell == ETerrainViewCell::NATIVE ? centerIsSand : (cell == ETerrainViewCell::ALIEN_SAND || cell == ETerrainViewCell::OUTSIDE_SAND);
+
+		int topPoints = -1;
+		for(const auto & rule : pattern.data[i])
+		{
+			bool valid;
+			if(!rule.isStandardRule())
+			{
+				if(isInTheMap)
+				{
+					// result of referenced pattern depends on tiles beyond this neighbourhood
+					if(cell == ETerrainViewCell::NATIVE)
+						return PatternMatch(PatternMatch::NEEDS_VALIDATION);
+					continue;
+				}
+				TerrainViewPattern::WeightedRule nativeRule = rule;
+				nativeRule.setNative();
+				valid = nativeRule.validate(terGroup, isAlien, isSand, transitionReplacement);
+			}
+			else
+			{
+				valid = rule.validate(terGroup, isAlien, isSand, transitionReplacement);
+			}
+
+			if(valid)
+			{
+				topPoints = std::max(topPoints, rule.points);
+			}
+		}
+
+		if(topPoints == -1)
+		{
+			return PatternMatch(PatternMatch::NO_MATCH);
+		}
+		totalPoints += topPoints;
+	}
+
+	if(totalPoints >= pattern.minPoints && totalPoints <= pattern.maxPoints)
+	{
+		PatternMatch match(PatternMatch::MATCH);
+		match.transitionReplacement = transitionReplacement;
+		return match;
+	}
+	return PatternMatch(PatternMatch::NO_MATCH);
+}
+
 
 CDrawTerrainOperation::CDrawTerrainOperation(CMap * map, const CTerrainSelection & terrainSel, ETerrainType terType, CRandomGenerator * gen)
 	: CMapOperation(map), terrainSel(terrainSel), terType(terType), gen(gen)
@@ -705,20 +866,29 @@ void CDrawTerrainOperation::updateTerrainViews()
 {
 	for(const auto & pos : invalidatedTerViews)
 	{
-		const auto & patterns = VLC->terviewh->getTerrainViewPatternsForGroup(getTerrainGroup(map->getTile(pos).terType));
+		const auto terGroup = getTerrainGroup(map->getTile(pos).terType);
+		const auto & patterns = VLC->terviewh->getTerrainViewPatternsForGroup(terGroup);
 
 		// Detect a pattern which fits best
 		int bestPattern = -1;
 		ValidationResult valRslt(false);
-		for(int k = 0; k < patterns.size(); ++k)
+		const auto match = VLC->terviewh->findTerrainViewPattern(terGroup, getNeighbourhoodKey(pos));
+		if(match.result == CTerrainViewPatternConfig::PatternMatch::MATCH)
 		{
-			const auto & pattern = patterns[k];
-			//(ETerrainGroup::ETerrainGroup terGroup, const std::string & id)
-			valRslt = validateTerrainView(pos, &pattern);
-			if(valRslt.result)
+			bestPattern = match.pattern;
+			valRslt = ValidationResult(true, match.transitionReplacement);
+			valRslt.flip = match.flip;
+		}
+		else if(match.result == CTerrainViewPatternConfig::PatternMatch::NEEDS_VALIDATION)
+		{
+			for(int k = 0; k < patterns.size(); ++k)
 			{
-				bestPattern = k;
-				break;
+				valRslt = validateTerrainView(pos, &patterns[k]);
+				if(valRslt.result)
+				{
+					bestPattern = k;
+					break;
+				}
 			}
 		}
 		//assert(bestPattern != -1);
@@ -811,44 +981,7 @@ CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainVi
 		int cy = pos.y + (i / 3) - 1;
 		int3 currentPos(cx, cy, pos.z);
 		bool isAlien = false;
-		ETerrainType terType;
-		if(!map->isInTheMap(currentPos))
-		{
-			// position is not in the map, so take the ter type from the neighbor tile
-			bool widthTooHigh = currentPos.x >= map->width;
-			bool widthTooLess = currentPos.x < 0;
-			bool heightTooHigh = currentPos.y >= map->height;
-			bool heightTooLess = currentPos.y < 0;
-
-			if ((widthTooHigh && heightTooHigh) || (widthTooHigh && heightTooLess) || (widthTooLess && heightTooHigh) || (widthTooLess && heightTooLess))
-			{
-				terType = centerTerType;
-			}
-			else if(widthTooHigh)
-			{
-				terType = map->getTile(int3(currentPos.x - 1, currentPos.y, currentPos.z)).terType;
-			}
-			else if(heightTooHigh)
-			{
-				terType = map->getTile(int3(currentPos.x, currentPos.y - 1, currentPos.z)).terType;
-			}
-			else if (widthTooLess)
-			{
-				terType = map->getTile(int3(currentPos.x + 1, currentPos.y, currentPos.z)).terType;
-			}
-			else if (heightTooLess)
-			{
-				terType = map->getTile(int3(currentPos.x, currentPos.y + 1, currentPos.z)).terType;
-			}
-		}
-		else
-		{
-			terType = map->getTile(currentPos).terType;
-			if(terType != centerTerType)
-			{
-				isAlien = true;
-			}
-		}
+		ETerrainType terType = getNeighbourTerrainType(currentPos, centerTerType, isAlien);
 
 		// Validate all rules per cell
 		int topPoints = -1;
@@ -877,55 +1010,10 @@ CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainVi
 				}
 			}
 
-			auto applyValidationRslt = [&](bool rslt)
-			{
-				if(rslt)
-				{
-					topPoints = std::max(topPoints, rule.points);
-				}
-			};
-
 			// Validate cell with the ruleset of the pattern
-			bool nativeTestOk, nativeTestStrongOk;
-			nativeTestOk = nativeTestStrongOk = (rule.isNativeStrong() || rule.isNativeRule()) && !isAlien;
-			if(centerTerGroup == ETerrainGroup::NORMAL)
-			{
-				bool dirtTestOk = (rule.isDirtRule() || rule.isTransition())
-						&& isAlien && !isSandType(terType);
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isSandType(terType);
-
-				if (transitionReplacement.empty() && rule.isTransition()
-						&& (dirtTestOk || sandTestOk))
-				{
-					transitionReplacement = dirtTestOk ? TerrainViewPattern::RULE_DIRT : TerrainViewPattern::RULE_SAND;
-				}
-				if (rule.isTransition())
-				{
-					applyValidationRslt((dirtTestOk && transitionReplacement != TerrainViewPattern::RULE_SAND) ||
-							(sandTestOk && transitionReplacement != TerrainViewPattern::RULE_DIRT));
-				}
-				else
-				{
-					applyValidationRslt(rule.isAnyRule() || dirtTestOk || sandTestOk || nativeTestOk);
-				}
-			}
-			else if(centerTerGroup == ETerrainGroup::DIRT)
-			{
-				nativeTestOk = rule.isNativeRule() && !isSandType(terType);
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isSandType(terType);
-				applyValidationRslt(rule.isAnyRule() || sandTestOk || nativeTestOk || nativeTestStrongOk);
-			}
-			else if(centerTerGroup == ETerrainGroup::SAND)
+			if(rule.validate(centerTerGroup, isAlien, isSandType(terType), transitionReplacement))
 			{
-				applyValidationRslt(true);
-			}
-			else if(centerTerGroup == ETerrainGroup::WATER || centerTerGroup == ETerrainGroup::ROCK)
-			{
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isAlien;
-				applyValidationRslt(rule.isAnyRule() || sandTestOk || nativeTestOk);
+				topPoints = std::max(topPoints, rule.points);
 			}
 		}
 
@@ -949,6 +1037,85 @@ CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainVi
 	}
 }
 
+ETerrainType CDrawTerrainOperation::getNeighbourTerrainType(const int3 & currentPos, ETerrainType centerTerType, bool & isAlien) const
+{
+	isAlien = false;
+	if(!map->isInTheMap(currentPos))
+	{
+		// position is not in the map, so take the ter type from the neighbor tile
+		bool widthTooHigh = currentPos.x >= map->width;
+		bool widthTooLess = currentPos.x < 0;
+		bool heightTooHigh = currentPos.y >= map->height;
+		bool heightTooLess = currentPos.y < 0;
+
+		if ((widthTooHigh && heightTooHigh) || (widthTooHigh && heightTooLess) || (widthTooLess && heightTooHigh) || (widthTooLess && heightTooLess))
+		{
+			return centerTerType;
+		}
+		else if(widthTooHigh)
+		{
+			return map->getTile(int3(currentPos.x - 1, currentPos.y, currentPos.z)).terType;
+		}
+		else if(heightTooHigh)
+		{
+			return map->getTile(int3(currentPos.x, currentPos.y - 1, currentPos.z)).terType;
+		}
+		else if (widthTooLess)
+		{
+			return map->getTile(int3(currentPos.x + 1, currentPos.y, currentPos.z)).terType;
+		}
+		else
+		{
+			return map->getTile(int3(currentPos.x, currentPos.y + 1, currentPos.z)).terType;
+		}
+	}
+	else
+	{
+		auto terType = map->getTile(currentPos).terType;
+		isAlien = terType != centerTerType;
+		return terType;
+	}
+}
+
+CTerrainViewPatternConfig::TNeighbourhoodKey CDrawTerrainOperation::getNeighbourhoodKey(const int3 & pos) const
+{
+	auto centerTerType = map->getTile(pos).terType;
+	CTerrainViewPatternConfig::TNeighbourhoodKey key = 0;
+
+	// last cell goes to the most significant digit, so that decoding starts with the first one
+	for(int i = 8; i >= 0; --i)
+	{
+		if(i == 4)
+		{
+			continue;
+		}
+
+		int3 currentPos(pos.x + (i % 3) - 1, pos.y + (i / 3) - 1, pos.z);
+		bool isAlien = false;
+		ETerrainType terType = getNeighbourTerrainType(currentPos, centerTerType, isAlien);
+
+		ETerrainViewCell::ETerrainViewCell cell;
+		if(!map->isInTheMap(currentPos))
+			cell = isSandType(terType) ? ETerrainViewCell::OUTSIDE_SAND : ETerrainViewCell::OUTSIDE;
+		else if(!isAlien)
+			cell = ETerrainViewCell::NATIVE;
+		else
+			cell = isSandType(terType) ? ETerrainViewCell::ALIEN_SAND : ETerrainViewCell::ALIEN;
+
+		key = key * ETerrainViewCell::COUNT + cell;
+	}
+	return key;
+}
+
+bool CDrawTerrainOperation::validateTerrainType(const int3 & pos, CTerrainViewPatternConfig::TNeighbourhoodKey key, const std::string & id) const
+{
+	auto terGroup = getTerrainGroup(map->getTile(pos).terType);
+	auto match = VLC->terviewh->findTerrainTypePattern(terGroup, id, key);
+	if(match.result == CTerrainViewPatternConfig::PatternMatch::NEEDS_VALIDATION)
+		return validateTerrainView(pos, VLC->terviewh->getTerrainTypePatternById(id)).result;
+	return match.result == CTerrainViewPatternConfig::PatternMatch::MATCH;
+}
+
 bool CDrawTerrainOperation::isSandType(ETerrainType terType) const
 {
 	switch(terType)
@@ -981,9 +1148,9 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 	{
 		if(map->isInTheMap(pos))
 		{
-			auto ptrConfig = VLC->terviewh;
 			auto terType = map->getTile(pos).terType;
-			auto valid = validateTerrainView(pos, ptrConfig->getTerrainTypePatternById("n1")).result;
+			auto key = getNeighbourhoodKey(pos);
+			auto valid = validateTerrainType(pos, key, "n1");
 
 			// Special validity check for rock & water
 			if(valid && (terType == ETerrainType::WATER || terType == ETerrainType::ROCK))
@@ -991,7 +1158,7 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 				static const std::string patternIds[] = { "s1", "s2" };
 				for(auto & patternId : patternIds)
 				{
-					valid = !validateTerrainView(pos, ptrConfig->getTerrainTypePatternById(patternId)).result;
+					valid = !validateTerrainType(pos, key, patternId);
 					if(!valid) break;
 				}
 			}
@@ -1001,7 +1168,7 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 				static const std::string patternIds[] = { "n2", "n3" };
 				for(auto & patternId : patternIds)
 				{
-					valid = validateTerrainView(pos, ptrConfig->getTerrainTypePatternById(patternId)).result;
+					valid = validateTerrainType(pos, key, patternId);
 					if(valid) break;
 				}
 			}
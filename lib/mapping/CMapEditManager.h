@@ -222,6 +222,20 @@ namespace ETerrainGroup
 	};
 }
 
+namespace ETerrainViewCell
+{
+	/// Classification of a tile neighbouring the validated tile, which is enough to check standard pattern rules.
+	enum ETerrainViewCell
+	{
+		NATIVE, //inside the map, same terrain type as center
+		ALIEN, //inside the map, different terrain type which is not a sand type
+		ALIEN_SAND, //inside the map, different sand terrain type
+		OUTSIDE, //outside of the map, nearest map tile is not of a sand type
+		OUTSIDE_SAND, //outside of the map, nearest map tile is of a sand type
+		COUNT
+	};
+}
+
 /// The terrain view pattern describes a specific composition of terrain tiles
 /// in a 3x3 matrix and notes which terrain view frame numbers can be used.
 struct DLL_LINKAGE TerrainViewPattern
@@ -259,6 +273,9 @@ struct DLL_LINKAGE TerrainViewPattern
 			return nativeRule;
 		}
 		void setNative();
+		/// Validates this standard rule against a neighbour cell. Transition rules may set transitionReplacement
+		/// which then applies to all remaining rules of the pattern.
+		bool validate(ETerrainGroup::ETerrainGroup centerTerGroup, bool isAlien, bool isSand, std::string & transitionReplacement) const;
 
 		/// The name of the rule. Can be any value of the RULE_* constants or a ID of a another pattern.
 		//FIXME: remove string variable altogether, use only in constructor
@@ -334,6 +351,29 @@ class DLL_LINKAGE CTerrainViewPatternConfig : public boost::noncopyable
 public:
 	typedef std::vector<TerrainViewPattern> TVPVector;
 
+	/// Neighbourhood of a tile encoded as base-5 number of ETerrainViewCell values of its 8 surrounding cells,
+	/// in the same order as pattern data (center cell is skipped)
+	typedef ui32 TNeighbourhoodKey;
+
+	/// Result of matching patterns against encoded neighbourhood
+	struct PatternMatch
+	{
+		enum EResult
+		{
+			NO_MATCH,
+			MATCH,
+			NEEDS_VALIDATION //pattern refers to another pattern on native cell, neighbourhood of that cell is needed
+		};
+
+		PatternMatch(EResult result = NO_MATCH);
+
+		EResult result;
+		/// Index of the matching pattern and its flip
+		int pattern, flip;
+		/// The replacement of a T rule, either D or S.
+		std::string transitionReplacement;
+	};
+
 	CTerrainViewPatternConfig();
 	~CTerrainViewPatternConfig();
 
@@ -344,9 +384,25 @@ public:
 	ETerrainGroup::ETerrainGroup getTerrainGroup(const std::string & terGroup) const;
 	void flipPattern(TerrainViewPattern & pattern, int flip) const;
 
+	/// Finds first terrain view pattern of the group (and its flip) which fits given neighbourhood.
+	/// Results are computed once per neighbourhood and then looked up.
+	PatternMatch findTerrainViewPattern(ETerrainGroup::ETerrainGroup terGroup, TNeighbourhoodKey key) const;
+	/// Checks whether terrain type pattern fits given neighbourhood of a tile from the terrain group.
+	PatternMatch findTerrainTypePattern(ETerrainGroup::ETerrainGroup terGroup, const std::string & id, TNeighbourhoodKey key) const;
+
 private:
+	typedef std::unordered_map<TNeighbourhoodKey, PatternMatch> TMatchTable;
+
+	PatternMatch lookupPatterns(const TVPVector * patterns, size_t count, ETerrainGroup::ETerrainGroup terGroup, const std::string & id, TNeighbourhoodKey key) const;
+	PatternMatch matchPatterns(const TVPVector * patterns, size_t count, ETerrainGroup::ETerrainGroup terGroup, TNeighbourhoodKey key) const;
+	PatternMatch matchPattern(const TerrainViewPattern & pattern, ETerrainGroup::ETerrainGroup terGroup, const std::array<ETerrainViewCell::ETerrainViewCell, 9> & cells) const;
+
 	std::map<ETerrainGroup::ETerrainGroup, std::vector<TVPVector> > terrainViewPatterns;
 	std::map<std::string, TVPVector> terrainTypePatterns;
+
+	/// Lookup tables per terrain group and terrain type pattern id (empty for terrain view patterns), filled on demand
+	mutable std::map<std::pair<ETerrainGroup::ETerrainGroup, std::string>, TMatchTable> matchTables;
+	mutable boost::mutex matchTablesMutex;
 };
 
 /// The CDrawTerrainOperation class draws a terrain area on the map.
@@ -389,6 +445,12 @@ private:
 	/// second method to validate the terrain view with the given pattern in all four flip directions(horizontal, vertical).
 	ValidationResult validateTerrainView(const int3 & pos, const std::vector<TerrainViewPattern> * pattern, int recDepth = 0) const;
 	ValidationResult validateTerrainViewInner(const int3 & pos, const TerrainViewPattern & pattern, int recDepth = 0) const;
+	/// Validates terrain type pattern with given id, using compiled lookup tables whenever possible.
+	bool validateTerrainType(const int3 & pos, CTerrainViewPatternConfig::TNeighbourhoodKey key, const std::string & id) const;
+	/// Gets terrain type of the neighbour cell at currentPos. Positions outside of the map take terrain type of the nearest map tile.
+	ETerrainType getNeighbourTerrainType(const int3 & currentPos, ETerrainType centerTerType, bool & isAlien) const;
+	/// Encodes 3x3 neighbourhood of the tile for lookup in compiled pattern tables
+	CTerrainViewPatternConfig::TNeighbourhoodKey getNeighbourhoodKey(const int3 & pos) const;
 	/// Tests whether the given terrain type is a sand type. Sand types are: Water, Sand and Rock
 	bool isSandType(ETerrainType terType) const;
 
@@ -0,0 +1,200 @@
+/*
+ * CMapHeaderIndex.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CMapHeaderIndex.h"
+
+#include "CMapService.h"
+#include "../CModHandler.h"
+#include "../CThreadHelper.h"
+#include "../VCMI_Lib.h"
+#include "../filesystem/CMemoryStream.h"
+#include "../filesystem/Filesystem.h"
+#include "../serializer/BinaryDeserializer.h"
+#include "../serializer/BinarySerializer.h"
+
+static const std::string MAP_INDEX_MAGIC = "VCMIMAPIDX";
+
+/// Map loaders read global library state (texts, handlers, identifiers), only one map is parsed at a time
+static boost::mutex parseMutex;
+
+CMapHeaderIndex::Entry::Entry():
+	size(0),
+	modified(0),
+	valid(false)
+{
+}
+
+CMapHeaderIndex::CMapHeaderIndex(const boost::filesystem::path & indexFile):
+	indexFile(indexFile),
+	parsedCount(0),
+	changed(false)
+{
+	if(VLC && VLC->modh)
+		mods = VLC->modh->getActiveMods();
+
+	if(!boost::filesystem::exists(indexFile))
+		return;
+
+	try
+	{
+		CLoadFile file(indexFile);
+		file.checkMagicBytes(MAP_INDEX_MAGIC);
+
+		std::vector<std::string> indexedMods;
+		file >> indexedMods;
+		if(indexedMods != mods)
+		{
+			logGlobal->debug("Map index %s was created with other mods, ignoring it", indexFile.string());
+			changed = true;
+			return;
+		}
+		file >> entries;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to read map index %s: %s", indexFile.string(), e.what());
+		entries.clear();
+		changed = true;
+	}
+}
+
+bool CMapHeaderIndex::getFileStamp(const ResourceID & resource, si64 & size, si64 & modified)
+{
+	auto path = CResourceHandler::get()->getResourceName(resource);
+	if(!path)
+		return false;
+
+	boost::system::error_code ec;
+	size = boost::filesystem::file_size(*path, ec);
+	if(ec)
+		return false;
+	modified = boost::filesystem::last_write_time(*path, ec);
+	return !ec;
+}
+
+std::map<std::string, const CMapHeader *> CMapHeaderIndex::getHeaders(const std::unordered_set<ResourceID> & files)
+{
+	struct ParseTask
+	{
+		const ResourceID * resource;
+		bool hasStamp;
+		Entry entry;
+		bool loaded;
+	};
+
+	std::map<std::string, Entry> current;
+	std::vector<ParseTask> toParse;
+
+	for(auto & file : files)
+	{
+		si64 size = 0, modified = 0;
+		bool hasStamp = getFileStamp(file, size, modified);
+
+		auto iter = entries.find(file.getName());
+		if(hasStamp && iter != entries.end() && iter->second.size == size && iter->second.modified == modified)
+		{
+			current[file.getName()] = std::move(iter->second);
+			continue;
+		}
+
+		ParseTask task;
+		task.resource = &file;
+		task.hasStamp = hasStamp;
+		task.entry.size = size;
+		task.entry.modified = modified;
+		task.loaded = false;
+		toParse.push_back(std::move(task));
+	}
+
+	//every task writes only to its own element, vector is not resized while threads run
+	//files are read concurrently (filesystem is only queried while tasks run), parsing itself is serialized
+	std::vector<Task> tasks;
+	for(auto & task : toParse)
+	{
+		ParseTask * target = &task;
+		tasks.push_back([target]()
+		{
+			try
+			{
+				auto data = CResourceHandler::get()->load(*target->resource)->readAll();
+				std::unique_ptr<CInputStream> stream(new CMemoryStream(data.first.get(), data.second));
+
+				boost::unique_lock<boost::mutex> lock(parseMutex);
+				target->entry.header = *CMapService::loadMapHeader(std::move(stream));
+				target->loaded = true;
+			}
+			catch(const std::exception & e)
+			{
+				logGlobal->error("Map %s is invalid. Message: %s", target->resource->getName(), e.what());
+			}
+		});
+	}
+
+	if(!tasks.empty())
+	{
+		logGlobal->debug("Parsing %d of %d maps", tasks.size(), files.size());
+		CThreadHelper helper(&tasks, std::max<int>(1, boost::thread::hardware_concurrency()));
+		helper.run();
+	}
+
+	parsedCount = toParse.size();
+	changed = changed || current.size() != entries.size();
+
+	std::vector<std::pair<std::string, Entry>> unindexed; //files without stamp are parsed every time
+	for(auto & task : toParse)
+	{
+		task.entry.valid = task.loaded;
+		if(task.hasStamp)
+		{
+			current[task.resource->getName()] = std::move(task.entry);
+			changed = true;
+		}
+		else if(task.loaded)
+			unindexed.push_back(std::make_pair(task.resource->getName(), std::move(task.entry)));
+	}
+
+	entries = std::move(current);
+	transient.clear();
+	for(auto & entry : unindexed)
+		transient.insert(std::move(entry));
+
+	std::map<std::string, const CMapHeader *> ret;
+	for(auto & entry : entries)
+	{
+		if(entry.second.valid)
+			ret[entry.first] = &entry.second.header;
+	}
+	for(auto & entry : transient)
+		ret[entry.first] = &entry.second.header;
+	return ret;
+}
+
+void CMapHeaderIndex::save()
+{
+	if(!changed)
+		return;
+
+	try
+	{
+		CSaveFile file(indexFile);
+		file.putMagicBytes(MAP_INDEX_MAGIC);
+		file << mods << entries;
+		changed = false;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to write map index %s: %s", indexFile.string(), e.what());
+	}
+}
+
+size_t CMapHeaderIndex::getParsedCount() const
+{
+	return parsedCount;
+}
@@ -0,0 +1,71 @@
+/*
+ * CMapHeaderIndex.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "CMap.h"
+#include "../filesystem/ResourceID.h"
+
+/**
+ * Persistent index of map headers, allows listing of maps without parsing of every map file.
+ *
+ * Entries are keyed by resource name and stay valid while size and modification time of the file
+ * providing the resource are the same. Whole index is dropped if it was written by another version or with other mods.
+ */
+class DLL_LINKAGE CMapHeaderIndex
+{
+public:
+	struct Entry
+	{
+		Entry();
+
+		si64 size;
+		si64 modified;
+		bool valid; //false if map can't be loaded, it is not parsed again until file changes
+		CMapHeader header;
+
+		template <typename Handler> void serialize(Handler & h, const int version)
+		{
+			h & size;
+			h & modified;
+			h & valid;
+			h & header;
+		}
+	};
+
+	/// Loads index from file, index is empty if file is missing, damaged or outdated
+	explicit CMapHeaderIndex(const boost::filesystem::path & indexFile);
+
+	/**
+	 * Returns headers of given maps. Maps which are new or changed since they were indexed are read on several threads and parsed one by one.
+	 * Maps which can't be loaded are logged and left out, they are remembered and not parsed again until they change.
+	 * Entries of maps that are not among files are dropped.
+	 *
+	 * @return headers by resource name, valid while index exists and until next call
+	 */
+	std::map<std::string, const CMapHeader *> getHeaders(const std::unordered_set<ResourceID> & files);
+
+	/// Writes index to file if it was changed since loading
+	void save();
+
+	/// Returns number of maps parsed by last call to getHeaders
+	size_t getParsedCount() const;
+
+private:
+	/// Gets size and modification time of file providing resource, returns false if there is no such file
+	static bool getFileStamp(const ResourceID & resource, si64 & size, si64 & modified);
+
+	boost::filesystem::path indexFile;
+	std::vector<std::string> mods;
+	std::map<std::string, Entry> entries;
+	std::map<std::string, Entry> transient; //maps that are not stored in files on disk, never saved
+	size_t parsedCount;
+	bool changed;
+};
@@ -30,7 +30,11 @@ std::unique_ptr<CMap> CMapService::loadMap(const ResourceID & name)
 
 std::unique_ptr<CMapHeader> CMapService::loadMapHeader(const ResourceID & name)
 {
-	auto stream = getStreamFromFS(name);
+	return loadMapHeader(getStreamFromFS(name));
+}
+
+std::unique_ptr<CMapHeader> CMapService::loadMapHeader(std::unique_ptr<CInputStream> stream)
+{
 	return getMapLoader(stream)->loadMapHeader();
 }
 
@@ -42,6 +42,15 @@ public:
 	 */
 	static std::unique_ptr<CMapHeader> loadMapHeader(const ResourceID & name);
 
+	/**
+	 * Loads the VCMI/H3 map header from a stream, e.g. a map file which was read into memory.
+	 * Map loaders read global library data, so they should not run concurrently.
+	 *
+	 * @param stream the stream with map data
+	 * @return a unique ptr to the loaded map header class
+	 */
+	static std::unique_ptr<CMapHeader> loadMapHeader(std::unique_ptr<CInputStream> stream);
+
 	/**
 	 * Loads the VCMI/H3 map file from a buffer. This method is temporarily
 	 * in use to ease the transition to use the new map service.
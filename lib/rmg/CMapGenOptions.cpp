@@ -207,8 +207,41 @@ const CRmgTemplate * CMapGenOptions::getMapTemplate() const
 void CMapGenOptions::setMapTemplate(const CRmgTemplate * value)
 {
 	mapTemplate = value;
-	//TODO validate & adapt options according to template
-	assert(0);
+	//TODO validate & adapt other options according to template
+	if(mapTemplate)
+	{
+		CRmgTemplate::CSize size(width, height, hasTwoLevels);
+		if(!(size >= mapTemplate->getMinSize() && size <= mapTemplate->getMaxSize()))
+		{
+			const auto & minSize = mapTemplate->getMinSize();
+			width = minSize.getWidth();
+			height = minSize.getHeight();
+			hasTwoLevels = minSize.getUnder();
+		}
+	}
+}
+
+void CMapGenOptions::setMapTemplate(const std::string & name)
+{
+	setMapTemplate(findMapTemplate(name));
+}
+
+const CRmgTemplate * CMapGenOptions::findMapTemplate(const std::string & name) const
+{
+	const auto & templates = getAvailableTemplates();
+	auto it = templates.find(name);
+	if(it == templates.end())
+	{
+		if(!name.empty())
+			logGlobal->warn("Random map template %s is not available, template will be chosen randomly", name);
+		return nullptr;
+	}
+	return it->second;
+}
+
+std::string CMapGenOptions::getMapTemplateName() const
+{
+	return mapTemplate ? mapTemplate->getName() : "";
 }
 
 const std::map<std::string, CRmgTemplate *> & CMapGenOptions::getAvailableTemplates() const
@@ -142,6 +142,8 @@ public:
 	/// Default: Not set/random.
 	const CRmgTemplate * getMapTemplate() const;
 	void setMapTemplate(const CRmgTemplate * value);
+	/// Selects available template with given name, unknown or empty name means random template.
+	void setMapTemplate(const std::string & name);
 
 	const std::map<std::string, CRmgTemplate *> & getAvailableTemplates() const;
 
@@ -163,6 +165,9 @@ private:
 	void updateCompOnlyPlayers();
 	void updatePlayers();
 	const CRmgTemplate * getPossibleTemplate(CRandomGenerator & rand) const;
+	std::string getMapTemplateName() const;
+	/// Returns available template with given name or nullptr, unknown name is logged
+	const CRmgTemplate * findMapTemplate(const std::string & name) const;
 
 	si32 width, height;
 	bool hasTwoLevels;
@@ -187,6 +192,14 @@ public:
 		h & monsterStrength;
 		h & players;
 		h & humanPlayersCount;
-		//TODO add name of template to class, enables selection of a template by a user
+		if(version >= 778)
+		{
+			std::string templateName;
+			if(h.saving)
+				templateName = getMapTemplateName();
+			h & templateName;
+			if(!h.saving)
+				mapTemplate = findMapTemplate(templateName); //map size was serialized already, don't adapt it to template
+		}
 	}
 };
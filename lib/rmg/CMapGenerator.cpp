@@ -496,12 +496,12 @@ void CMapGenerator::createDirectConnections()
 		auto zoneB = connection.getZoneB();
 
 		//rearrange tiles in random order
-		auto tilesCopy = zoneA->getTileInfo();
+		const auto & tilesCopy = zoneA->getTileInfo();
 		std::vector<int3> tiles(tilesCopy.begin(), tilesCopy.end());
 
 		int3 guardPos(-1,-1,-1);
 
-		auto otherZoneTiles = zoneB->getTileInfo();
+		const auto & otherZoneTiles = zoneB->getTileInfo();
 
 		int3 posA = zoneA->getPos();
 		int3 posB = zoneB->getPos();
@@ -595,8 +595,8 @@ void CMapGenerator::createConnections2()
 			{
 				bool continueOuterLoop = false;
 				//find common tiles for both zones
-				auto tileSetA = zoneA->getPossibleTiles(),
-					tileSetB = zoneB->getPossibleTiles();
+				const auto & tileSetA = zoneA->getPossibleTiles();
+				const auto & tileSetB = zoneB->getPossibleTiles();
 
 				std::vector<int3> tilesA(tileSetA.begin(), tileSetA.end()),
 					tilesB(tileSetB.begin(), tileSetB.end());
@@ -782,6 +782,11 @@ TRmgTemplateZoneId CMapGenerator::getZoneID(const int3& tile) const
 	return zoneColouring[tile.z][tile.x][tile.y];
 }
 
+int3 CMapGenerator::getMapSize() const
+{
+	return int3(map->width, map->height, map->twoLevel ? 2 : 1);
+}
+
 void CMapGenerator::setZoneID(const int3& tile, TRmgTemplateZoneId zid)
 {
 	checkIsOnMap(tile);
@@ -97,6 +97,7 @@ public:
 	ui32 getTotalZoneCount() const;
 
 	TRmgTemplateZoneId getZoneID(const int3& tile) const;
+	int3 getMapSize() const; //z is number of levels
 	void setZoneID(const int3& tile, TRmgTemplateZoneId zid);
 
 private:
@@ -172,6 +172,11 @@ CRmgTemplateZone::CRmgTemplateZone() :
 void CRmgTemplateZone::setGenPtr(CMapGenerator * Gen)
 {
 	gen = Gen;
+
+	//tile sets cover whole map, size is known only now
+	int3 mapSize = gen->getMapSize();
+	for (auto tiles : {&tileinfo, &possibleTiles, &freePaths, &roadNodes, &roads, &tilesToConnectLater})
+		tiles->resize(mapSize);
 }
 
 TRmgTemplateZoneId CRmgTemplateZone::getId() const
@@ -348,7 +353,7 @@ std::vector<CTreasureInfo> CRmgTemplateZone::getTreasureInfo()
 	return treasureInfo;
 }
 
-std::set<int3>* CRmgTemplateZone::getFreePaths()
+CTileSet* CRmgTemplateZone::getFreePaths()
 {
 	return &freePaths;
 }
@@ -393,11 +398,11 @@ void CRmgTemplateZone::addTile (const int3 &pos)
 	tileinfo.insert(pos);
 }
 
-std::set<int3> CRmgTemplateZone::getTileInfo () const
+const CTileSet & CRmgTemplateZone::getTileInfo () const
 {
 	return tileinfo;
 }
-std::set<int3> CRmgTemplateZone::getPossibleTiles() const
+const CTileSet & CRmgTemplateZone::getPossibleTiles() const
 {
 	return possibleTiles;
 }
@@ -414,7 +419,7 @@ void CRmgTemplateZone::discardDistantTiles (float distance)
 	//		//gen->setOccupied(tile, ETileType::BLOCKED); //fixme: crash at rendering?
 	//	}
 	//}
-	vstd::erase_if (tileinfo, [distance, this](const int3 &tile) -> bool
+	tileinfo.eraseIf([distance, this](const int3 &tile) -> bool
 	{
 		return tile.dist2d(this->pos) > distance;
 	});
@@ -431,6 +436,10 @@ void CRmgTemplateZone::initFreeTiles ()
 	{
 		return gen->isPossible(tile);
 	});
+
+	distanceBuckets = make_unique<CTileBuckets>(gen->map->width, gen->map->height, 8);
+	for (auto tile : tileinfo)
+		distanceBuckets->insert(tile);
 	if (freePaths.empty())
 	{
 		gen->setOccupied(pos, ETileType::FREE);
@@ -469,24 +478,26 @@ void CRmgTemplateZone::fractalize()
 		if (gen->isFree(tile))
 			freePaths.insert(tile);
 	}
-	std::vector<int3> clearedTiles (freePaths.begin(), freePaths.end());
-	std::set<int3> possibleTiles;
-	std::set<int3> tilesToIgnore; //will be erased in this iteration
+	CTileBuckets clearedTiles(gen->map->width, gen->map->height, 10);
+	for (auto tile : freePaths)
+		clearedTiles.insert(tile);
+	CTileSet possibleTiles(gen->getMapSize());
+	CTileSet tilesToIgnore(gen->getMapSize()); //will be erased in this iteration
 
 	//the more treasure density, the greater distance between paths. Scaling is experimental.
 	int totalDensity = 0;
 	for (auto ti : treasureInfo)
 		totalDensity += ti.density;
-	const float minDistance = 10 * 10; //squared
+	const ui32 minDistance = 10 * 10; //squared
 
 	for (auto tile : tileinfo)
 	{
 		if (gen->isFree(tile))
-			clearedTiles.push_back(tile);
+			clearedTiles.insert(tile);
 		else if (gen->isPossible(tile))
 			possibleTiles.insert(tile);
 	}
-	assert (clearedTiles.size()); //this should come from zone connections
+	assert (clearedTiles.getBuckets().size()); //this should come from zone connections
 
 	std::vector<int3> nodes; //connect them with a grid
 
@@ -504,41 +515,23 @@ void CRmgTemplateZone::fractalize()
 
 			for (auto tileToMakePath : tilesToMakePath)
 			{
-				//find closest free tile
-				float currentDistance = 1e10;
-				int3 closestTile(-1, -1, -1);
-
-				for (auto clearTile : clearedTiles)
+				if (clearedTiles.hasTileWithin(tileToMakePath, minDistance))
 				{
-					float distance = tileToMakePath.dist2dSQ(clearTile);
-
-					if (distance < currentDistance)
-					{
-						currentDistance = distance;
-						closestTile = clearTile;
-					}
-					if (currentDistance <= minDistance)
-					{
-						//this tile is close enough. Forget about it and check next one
-						tilesToIgnore.insert(tileToMakePath);
-						break;
-					}
+					//this tile is close enough. Forget about it and check next one
+					tilesToIgnore.insert(tileToMakePath);
 				}
-				//if tiles is not close enough, make path to it
-				if (currentDistance > minDistance)
+				else
 				{
+					//if tiles is not close enough, make path to it
 					nodeFound = tileToMakePath;
 					nodes.push_back(nodeFound);
-					clearedTiles.push_back(nodeFound); //from now on nearby tiles will be considered handled
+					clearedTiles.insert(nodeFound); //from now on nearby tiles will be considered handled
 					break; //next iteration - use already cleared tiles
 				}
 			}
 
-			for (auto tileToClear : tilesToIgnore)
-			{
-				//these tiles are already connected, ignore them
-				vstd::erase_if_present(possibleTiles, tileToClear);
-			}
+			//these tiles are already connected, ignore them
+			possibleTiles -= tilesToIgnore;
 			if (!nodeFound.valid()) //nothing else can be done (?)
 				break;
 			tilesToIgnore.clear();
@@ -645,7 +638,7 @@ void CRmgTemplateZone::connectLater()
 	}
 }
 
-bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles)
+bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet* clearedTiles)
 {
 /*
 make shortest path with free tiles, reachning dst or closest already free tile. Avoid blocks.
@@ -762,7 +755,7 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto pq = std::move(createPiorityQueue());    // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -805,7 +798,7 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 
 			auto foo = [this, &pq, &distances, &closed, &cameFrom, &currentNode, &currentTile, &node, &dst, &directNeighbourFound, &movementCost](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos)) //we already visited that node
+				if (closed.contains(pos)) //we already visited that node
 					return;
 				float distance = node.second + movementCost;
 				float bestDistanceSoFar = std::numeric_limits<float>::max();
@@ -853,7 +846,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto open = std::move(createPiorityQueue());    // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -889,7 +882,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 		{
 			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (closed.contains(pos))
 					return;
 
 				//no paths through blocked or occupied tiles, stay within zone
@@ -920,7 +913,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 	for (auto tile : closed) //these tiles are sealed off and can't be connected anymore
 	{
 		gen->setOccupied (tile, ETileType::BLOCKED);
-		vstd::erase_if_present(possibleTiles, tile);
+		possibleTiles.erase(tile);
 	}
 	return false;
 }
@@ -930,7 +923,7 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto open = std::move(createPiorityQueue()); // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -963,7 +956,7 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 		{
 			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (closed.contains(pos))
 					return;
 
 				if (gen->getZoneID(pos) != id)
@@ -1314,7 +1307,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 	else //we did not place eveyrthing successfully
 	{
 		gen->setOccupied(pos, ETileType::BLOCKED); //TODO: refactor stop condition
-		vstd::erase_if_present(possibleTiles, pos);
+		possibleTiles.erase(pos);
 		return false;
 	}
 }
@@ -1725,7 +1718,7 @@ void CRmgTemplateZone::createTreasures()
 		bool stop = false;
 		do {
 			//optimization - don't check tiles which are not allowed
-			vstd::erase_if(possibleTiles, [this](const int3 &tile) -> bool
+			possibleTiles.eraseIf([this](const int3 &tile) -> bool
 			{
 				return !gen->isPossible(tile);
 			});
@@ -1845,8 +1838,8 @@ void CRmgTemplateZone::connectRoads()
 {
 	logGlobal->debug("Started building roads");
 
-	std::set<int3> roadNodesCopy(roadNodes);
-	std::set<int3> processed;
+	CTileSet roadNodesCopy(roadNodes);
+	CTileSet processed(gen->getMapSize());
 
 	while(!roadNodesCopy.empty())
 	{
@@ -1871,7 +1864,7 @@ void CRmgTemplateZone::connectRoads()
 		if (createRoad(node, cross))
 		{
 			processed.insert(cross); //don't draw road starting at end point which is already connected
-			vstd::erase_if_present(roadNodesCopy, cross);
+			roadNodesCopy.erase(cross);
 		}
 
 		processed.insert(node);
@@ -1929,25 +1922,36 @@ bool CRmgTemplateZone::findPlaceForTreasurePile(float min_dist, int3 &pos, int v
 	bool needsGuard = value > minGuardedValue;
 
 	//logGlobal->info("Min dist for density %f is %d", density, min_dist);
-	for(auto tile : possibleTiles)
+	for(auto bucket : distanceBuckets->getBuckets())
 	{
-		auto dist = gen->getNearestObjectDistance(tile);
+		//there is no tile far enough from other objects in this bucket
+		if (bucket->maxDistance < min_dist || bucket->maxDistance < best_distance)
+			continue;
 
-		if ((dist >= min_dist) && (dist > best_distance))
+		for(auto tile : bucket->tiles)
 		{
-			bool allTilesAvailable = true;
-			gen->foreach_neighbour (tile, [this, &allTilesAvailable, needsGuard](int3 neighbour)
+			if (!possibleTiles.contains(tile))
+				continue;
+
+			auto dist = gen->getNearestObjectDistance(tile);
+
+			//buckets are not visited in tile order, so on equal distance prefer tile which comes first in possibleTiles
+			if ((dist >= min_dist) && (dist > best_distance || (result && dist == best_distance && tile < pos)))
 			{
-				if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
+				bool allTilesAvailable = true;
+				gen->foreach_neighbour (tile, [this, &allTilesAvailable, needsGuard](int3 neighbour)
 				{
-					allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
+					if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
+					{
+						allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
+					}
+				});
+				if (allTilesAvailable)
+				{
+					best_distance = dist;
+					pos = tile;
+					result = true;
 				}
-			});
-			if (allTilesAvailable)
-			{
-				best_distance = dist;
-				pos = tile;
-				result = true;
 			}
 		}
 	}
@@ -2135,10 +2139,25 @@ void CRmgTemplateZone::placeObject(CGObjectInstance* object, const int3 &pos, bo
 
 void CRmgTemplateZone::updateDistances(const int3 & pos)
 {
-	for (auto tile : possibleTiles) //don't need to mark distance for not possible tiles
+	if (!distanceBuckets)
+		return; //no possible tiles yet
+
+	for (auto bucket : distanceBuckets->getBuckets())
 	{
-		ui32 d = pos.dist2dSQ(tile); //optimization, only relative distance is interesting
-		gen->setNearestObjectDistance(tile, std::min<float>(d, gen->getNearestObjectDistance(tile)));
+		//every tile in this bucket is already closer to some other object
+		if (bucket->minDist2dSQ(pos) >= bucket->maxDistance)
+			continue;
+
+		bucket->maxDistance = 0;
+		for (auto tile : bucket->tiles)
+		{
+			if (possibleTiles.contains(tile)) //don't need to mark distance for not possible tiles
+			{
+				ui32 d = pos.dist2dSQ(tile); //optimization, only relative distance is interesting
+				gen->setNearestObjectDistance(tile, std::min<float>(d, gen->getNearestObjectDistance(tile)));
+			}
+			vstd::amax(bucket->maxDistance, gen->getNearestObjectDistance(tile));
+		}
 	}
 }
 
@@ -13,6 +13,8 @@
 #include "../GameConstants.h"
 #include "CMapGenerator.h"
 #include "float3.h"
+#include "CTileBuckets.h"
+#include "CTileSet.h"
 #include "../int3.h"
 #include "../ResourceSet.h" //for TResource (?)
 #include "../mapObjects/ObjectTemplate.h"
@@ -166,8 +168,8 @@ public:
 
 	void addTile (const int3 &pos);
 	void initFreeTiles ();
-	std::set<int3> getTileInfo() const;
-	std::set<int3> getPossibleTiles() const;
+	const CTileSet & getTileInfo() const;
+	const CTileSet & getPossibleTiles() const;
 	void discardDistantTiles (float distance);
 	void clearTiles();
 
@@ -190,7 +192,7 @@ public:
 	void createTreasures();
 	void createObstacles1();
 	void createObstacles2();
-	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles = nullptr);
+	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet* clearedTiles = nullptr);
 	bool connectPath(const int3& src, bool onlyStraight);
 	bool connectWithCenter(const int3& src, bool onlyStraight);
 	void updateDistances(const int3 & pos);
@@ -203,7 +205,7 @@ public:
 	std::vector<TRmgTemplateZoneId> getConnections() const;
 	void addTreasureInfo(CTreasureInfo & info);
 	std::vector<CTreasureInfo> getTreasureInfo();
-	std::set<int3>* getFreePaths();
+	CTileSet* getFreePaths();
 
 	ObjectInfo getRandomObject (CTreasurePileInfo &info, ui32 desiredValue, ui32 maxValue, ui32 currentValue);
 
@@ -258,14 +260,15 @@ private:
 	//placement info
 	int3 pos;
 	float3 center;
-	std::set<int3> tileinfo; //irregular area assined to zone
-	std::set<int3> possibleTiles; //optimization purposes for treasure generation
+	CTileSet tileinfo; //irregular area assined to zone
+	CTileSet possibleTiles; //optimization purposes for treasure generation
+	std::unique_ptr<CTileBuckets> distanceBuckets; //all tiles of zone, to skip areas where nearest object distance can't change
 	std::vector<TRmgTemplateZoneId> connections; //list of adjacent zones
-	std::set<int3> freePaths; //core paths of free tiles that all other objects will be linked to
+	CTileSet freePaths; //core paths of free tiles that all other objects will be linked to
 
-	std::set<int3> roadNodes; //tiles to be connected with roads
-	std::set<int3> roads; //all tiles with roads
-	std::set<int3> tilesToConnectLater; //will be connected after paths are fractalized
+	CTileSet roadNodes; //tiles to be connected with roads
+	CTileSet roads; //all tiles with roads
+	CTileSet tilesToConnectLater; //will be connected after paths are fractalized
 
 	bool createRoad(const int3 &src, const int3 &dst);
 	void drawRoads(); //actually updates tiles
@@ -0,0 +1,104 @@
+/*
+ * CTileBuckets.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CTileBuckets.h"
+
+CTileBuckets::Bucket::Bucket():
+	maxDistance(std::numeric_limits<float>::max())
+{
+}
+
+ui32 CTileBuckets::Bucket::minDist2dSQ(const int3 & pos) const
+{
+	const si32 dx = std::max(0, std::max(minCorner.x - pos.x, pos.x - maxCorner.x));
+	const si32 dy = std::max(0, std::max(minCorner.y - pos.y, pos.y - maxCorner.y));
+	return (ui32)(dx*dx) + (ui32)(dy*dy);
+}
+
+CTileBuckets::CTileBuckets(int width, int height, int bucketSize):
+	width(width),
+	height(height),
+	bucketSize(bucketSize),
+	bucketsX((width + bucketSize - 1) / bucketSize),
+	bucketsY((height + bucketSize - 1) / bucketSize)
+{
+	if(width <= 0 || height <= 0 || bucketSize <= 0)
+		throw std::runtime_error("Invalid dimensions of tile buckets!");
+
+	grid.resize(bucketsX * bucketsY);
+	for(int y = 0; y < bucketsY; y++)
+	{
+		for(int x = 0; x < bucketsX; x++)
+		{
+			Bucket & bucket = grid[y * bucketsX + x];
+			bucket.minCorner = int3(x * bucketSize, y * bucketSize, 0);
+			bucket.maxCorner = int3((x + 1) * bucketSize - 1, (y + 1) * bucketSize - 1, 0);
+		}
+	}
+}
+
+void CTileBuckets::insert(const int3 & tile)
+{
+	if(tile.x < 0 || tile.x >= width || tile.y < 0 || tile.y >= height)
+		throw std::runtime_error("Tile " + tile.toString() + " is outside of tile buckets!");
+
+	Bucket & bucket = getBucket(tile.x / bucketSize, tile.y / bucketSize);
+	if(bucket.tiles.empty())
+		used.push_back(&bucket);
+	bucket.tiles.push_back(tile);
+}
+
+void CTileBuckets::clear()
+{
+	for(auto bucket : used)
+	{
+		bucket->tiles.clear();
+		bucket->maxDistance = std::numeric_limits<float>::max();
+	}
+	used.clear();
+}
+
+bool CTileBuckets::hasTileWithin(const int3 & pos, ui32 distanceSQ) const
+{
+	const int radius = std::ceil(std::sqrt((double)distanceSQ));
+
+	const int minX = std::max(0, pos.x - radius) / bucketSize;
+	const int minY = std::max(0, pos.y - radius) / bucketSize;
+	const int maxX = std::min(width - 1, pos.x + radius) / bucketSize;
+	const int maxY = std::min(height - 1, pos.y + radius) / bucketSize;
+
+	for(int y = minY; y <= maxY; y++)
+	{
+		for(int x = minX; x <= maxX; x++)
+		{
+			const Bucket & bucket = grid[y * bucketsX + x];
+			if(bucket.tiles.empty() || bucket.minDist2dSQ(pos) > distanceSQ)
+				continue;
+
+			for(auto & tile : bucket.tiles)
+			{
+				if(pos.dist2dSQ(tile) <= distanceSQ)
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+std::vector<CTileBuckets::Bucket *> & CTileBuckets::getBuckets()
+{
+	return used;
+}
+
+CTileBuckets::Bucket & CTileBuckets::getBucket(int x, int y)
+{
+	return grid[y * bucketsX + x];
+}
@@ -0,0 +1,63 @@
+/*
+ * CTileBuckets.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+
+/**
+ * Uniform grid of square buckets holding map tiles, used by random map generator
+ * to answer distance queries without scanning whole zone.
+ *
+ * Like int3::dist2dSQ, the grid ignores z coordinate - tiles from different levels share buckets.
+ */
+class DLL_LINKAGE CTileBuckets
+{
+public:
+	struct Bucket
+	{
+		Bucket();
+
+		/// Lowest possible squared 2d distance between pos and any tile that may belong to this bucket
+		ui32 minDist2dSQ(const int3 & pos) const;
+
+		std::vector<int3> tiles; //in order of insertion
+		int3 minCorner, maxCorner;
+		float maxDistance; //upper bound of nearest object distance of all tiles, maintained by owner
+	};
+
+	/**
+	 * C-tor.
+	 *
+	 * @param width Width of the map, tiles must have x coordinate in [0, width)
+	 * @param height Height of the map, tiles must have y coordinate in [0, height)
+	 * @param bucketSize Length of bucket side in tiles
+	 */
+	CTileBuckets(int width, int height, int bucketSize);
+
+	void insert(const int3 & tile);
+	void clear();
+
+	/// Returns true if there is tile with squared 2d distance to pos no greater than distanceSQ
+	bool hasTileWithin(const int3 & pos, ui32 distanceSQ) const;
+
+	/// Returns all non-empty buckets, in order of creation
+	std::vector<Bucket *> & getBuckets();
+
+private:
+	Bucket & getBucket(int x, int y);
+
+	int width, height;
+	int bucketSize;
+	int bucketsX, bucketsY;
+
+	std::vector<Bucket> grid;
+	std::vector<Bucket *> used;
+};
@@ -0,0 +1,222 @@
+/*
+ * CTileSet.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CTileSet.h"
+
+CTileSet::const_iterator::const_iterator():
+	owner(nullptr),
+	index(0)
+{
+}
+
+CTileSet::const_iterator::const_iterator(const CTileSet * owner, size_t index):
+	owner(owner),
+	index(index)
+{
+}
+
+int3 CTileSet::const_iterator::operator*() const
+{
+	return owner->toTile(index);
+}
+
+CTileSet::const_iterator & CTileSet::const_iterator::operator++()
+{
+	index = owner->findNext(index + 1);
+	return *this;
+}
+
+CTileSet::const_iterator CTileSet::const_iterator::operator++(int)
+{
+	const_iterator ret = *this;
+	++*this;
+	return ret;
+}
+
+CTileSet::const_iterator & CTileSet::const_iterator::operator--()
+{
+	index = owner->findPrevious(index);
+	return *this;
+}
+
+CTileSet::const_iterator CTileSet::const_iterator::operator--(int)
+{
+	const_iterator ret = *this;
+	--*this;
+	return ret;
+}
+
+bool CTileSet::const_iterator::operator==(const const_iterator & other) const
+{
+	return owner == other.owner && index == other.index;
+}
+
+bool CTileSet::const_iterator::operator!=(const const_iterator & other) const
+{
+	return !(*this == other);
+}
+
+CTileSet::CTileSet():
+	mapSize(0, 0, 0),
+	tilesCount(0)
+{
+}
+
+CTileSet::CTileSet(const int3 & mapSize):
+	tilesCount(0)
+{
+	resize(mapSize);
+}
+
+void CTileSet::resize(const int3 & mapSize)
+{
+	if(mapSize.x < 0 || mapSize.y < 0 || mapSize.z < 0)
+		throw std::runtime_error("Invalid size of tile set " + mapSize.toString());
+
+	this->mapSize = mapSize;
+	bits.clear();
+	bits.resize(mapSize.x * mapSize.y * mapSize.z);
+	tilesCount = 0;
+}
+
+const int3 & CTileSet::getMapSize() const
+{
+	return mapSize;
+}
+
+bool CTileSet::contains(const int3 & tile) const
+{
+	if(tile.x < 0 || tile.x >= mapSize.x || tile.y < 0 || tile.y >= mapSize.y || tile.z < 0 || tile.z >= mapSize.z)
+		return false;
+	return bits.test(toIndex(tile));
+}
+
+size_t CTileSet::count(const int3 & tile) const
+{
+	return contains(tile) ? 1 : 0;
+}
+
+std::pair<CTileSet::const_iterator, bool> CTileSet::insert(const int3 & tile)
+{
+	if(tile.x < 0 || tile.x >= mapSize.x || tile.y < 0 || tile.y >= mapSize.y || tile.z < 0 || tile.z >= mapSize.z)
+		throw std::runtime_error("Tile " + tile.toString() + " is outside of tile set of size " + mapSize.toString());
+
+	size_t index = toIndex(tile);
+	bool inserted = !bits.test(index);
+	if(inserted)
+	{
+		bits.set(index);
+		tilesCount++;
+	}
+	return std::make_pair(const_iterator(this, index), inserted);
+}
+
+CTileSet::const_iterator CTileSet::insert(const_iterator, const int3 & tile)
+{
+	return insert(tile).first;
+}
+
+size_t CTileSet::erase(const int3 & tile)
+{
+	if(!contains(tile))
+		return 0;
+
+	bits.reset(toIndex(tile));
+	tilesCount--;
+	return 1;
+}
+
+CTileSet::const_iterator CTileSet::erase(const_iterator position)
+{
+	const_iterator next = position;
+	++next;
+	bits.reset(position.index);
+	tilesCount--;
+	return next;
+}
+
+CTileSet & CTileSet::operator|=(const CTileSet & other)
+{
+	checkSameSize(other);
+	bits |= other.bits;
+	tilesCount = bits.count();
+	return *this;
+}
+
+CTileSet & CTileSet::operator-=(const CTileSet & other)
+{
+	checkSameSize(other);
+	bits -= other.bits;
+	tilesCount = bits.count();
+	return *this;
+}
+
+void CTileSet::clear()
+{
+	bits.reset();
+	tilesCount = 0;
+}
+
+size_t CTileSet::size() const
+{
+	return tilesCount;
+}
+
+bool CTileSet::empty() const
+{
+	return tilesCount == 0;
+}
+
+CTileSet::const_iterator CTileSet::begin() const
+{
+	return const_iterator(this, findNext(0));
+}
+
+CTileSet::const_iterator CTileSet::end() const
+{
+	return const_iterator(this, bits.size());
+}
+
+size_t CTileSet::toIndex(const int3 & tile) const
+{
+	return (static_cast<size_t>(tile.z) * mapSize.y + tile.y) * mapSize.x + tile.x;
+}
+
+int3 CTileSet::toTile(size_t index) const
+{
+	const size_t levelSize = mapSize.x * mapSize.y;
+	return int3(index % mapSize.x, (index % levelSize) / mapSize.x, index / levelSize);
+}
+
+size_t CTileSet::findNext(size_t index) const
+{
+	if(index >= bits.size())
+		return bits.size();
+
+	size_t found = bits.test(index) ? index : bits.find_next(index);
+	return found == boost::dynamic_bitset<>::npos ? bits.size() : found;
+}
+
+size_t CTileSet::findPrevious(size_t index) const
+{
+	while(index > 0)
+	{
+		if(bits.test(--index))
+			return index;
+	}
+	throw std::runtime_error("Can't move iterator before beginning of tile set!");
+}
+
+void CTileSet::checkSameSize(const CTileSet & other) const
+{
+	if(mapSize != other.mapSize)
+		throw std::runtime_error("Tile sets of different sizes " + mapSize.toString() + " and " + other.mapSize.toString() + " can't be combined");
+}
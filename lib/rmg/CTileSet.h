@@ -0,0 +1,122 @@
+/*
+ * CTileSet.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+
+#include <boost/dynamic_bitset.hpp>
+
+/**
+ * Set of map tiles stored as dense bitmap over whole map.
+ *
+ * Interface follows std::set<int3> and tiles are iterated in the same order (by z, y, x),
+ * but membership, insertion and removal take constant time and no per-tile allocations are made.
+ * All tiles must be within map bounds given in constructor or resize().
+ */
+class DLL_LINKAGE CTileSet
+{
+public:
+	class DLL_LINKAGE const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef int3 value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const int3 * pointer;
+		typedef int3 reference; //tiles are computed from bit index, there is no stored object to refer to
+
+		const_iterator();
+
+		int3 operator*() const;
+		const_iterator & operator++();
+		const_iterator operator++(int);
+		const_iterator & operator--();
+		const_iterator operator--(int);
+
+		bool operator==(const const_iterator & other) const;
+		bool operator!=(const const_iterator & other) const;
+
+	private:
+		friend class CTileSet;
+		const_iterator(const CTileSet * owner, size_t index);
+
+		const CTileSet * owner;
+		size_t index;
+	};
+
+	typedef const_iterator iterator;
+	typedef int3 value_type;
+	typedef int3 key_type;
+	typedef size_t size_type;
+
+	/// Creates set which can't hold any tiles until resized
+	CTileSet();
+	/// Creates empty set for map of given size, z coordinate of mapSize is number of levels
+	explicit CTileSet(const int3 & mapSize);
+
+	/// Removes all tiles and changes size of the map
+	void resize(const int3 & mapSize);
+	const int3 & getMapSize() const;
+
+	/// Returns true if tile belongs to the set, tiles outside of the map never do
+	bool contains(const int3 & tile) const;
+	size_t count(const int3 & tile) const;
+
+	/**
+	 * Adds tile to the set.
+	 *
+	 * @throws std::runtime_error if tile is outside of the map
+	 */
+	std::pair<const_iterator, bool> insert(const int3 & tile);
+	const_iterator insert(const_iterator hint, const int3 & tile);
+	template <typename InputIterator>
+	void insert(InputIterator first, InputIterator last)
+	{
+		for(; first != last; ++first)
+			insert(*first);
+	}
+
+	size_t erase(const int3 & tile);
+	const_iterator erase(const_iterator position);
+
+	template <typename Predicate>
+	void eraseIf(Predicate pred)
+	{
+		for(auto it = begin(); it != end(); ++it)
+		{
+			if(pred(*it))
+				erase(*it);
+		}
+	}
+
+	/// Adds all tiles of other set, which must be of the same map size
+	CTileSet & operator|=(const CTileSet & other);
+	/// Removes all tiles of other set, which must be of the same map size
+	CTileSet & operator-=(const CTileSet & other);
+
+	void clear();
+	size_t size() const;
+	bool empty() const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	size_t toIndex(const int3 & tile) const;
+	int3 toTile(size_t index) const;
+	size_t findNext(size_t index) const;
+	size_t findPrevious(size_t index) const;
+	void checkSameSize(const CTileSet & other) const;
+
+	int3 mapSize;
+	boost::dynamic_bitset<> bits;
+	size_t tilesCount;
+};
@@ -13,6 +13,7 @@
 #include "../registerTypes/RegisterTypes.h"
 #include "../mapping/CMap.h"
 #include "../CGameState.h"
+#include "../CPerformanceCounters.h"
 
 #include <boost/asio.hpp>
 
@@ -228,6 +229,7 @@ void CConnection::sendPackToServer(const CPack &pack, PlayerColor player, ui32 r
 {
 	boost::unique_lock<boost::mutex> lock(*wmx);
 	logNetwork->trace("Sending to server a pack of type %s", typeid(pack).name());
+	CPerformanceTimer timer("serialization");
 	oser & player & requestID & &pack; //packs has to be sent as polymorphic pointers!
 }
 
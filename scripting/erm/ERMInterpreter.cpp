@@ -473,8 +473,205 @@ ERMInterpreter::ERMInterpreter()
 	topDyn = globalEnv;
 }
 
-void ERMInterpreter::executeTrigger(VERMInterpreter::Trigger & trig, int funNum, std::vector<int> funParams)
+void ERMInterpreter::compileScripts()
 {
+	dispatchTables.clear();
+	postDispatchTables.clear();
+
+	compileTriggers(triggers, dispatchTables);
+	compileTriggers(postTriggers, postDispatchTables);
+}
+
+void ERMInterpreter::compileTriggers(TtriggerListType & source, TdispatchTablesType & dest)
+{
+	for(auto & entry : source)
+	{
+		TriggerDispatchTable & table = dest[entry.first];
+		for(Trigger & trig : entry.second)
+		{
+			const size_t index = table.triggers.size();
+			table.triggers.push_back(compileTrigger(trig));
+
+			const CompiledTrigger & compiled = table.triggers.back();
+			if(compiled.indexed)
+				table.byIdentifier[compiled.constIdentifier].push_back(index);
+			else
+				table.unindexed.push_back(index);
+		}
+	}
+}
+
+CompiledTrigger ERMInterpreter::compileTrigger(Trigger & trig)
+{
+	CompiledTrigger ret;
+	ret.trigger = &trig;
+
+	const ERM::TTriggerBase & base = retrieveTrigger(retrieveLine(trig.line));
+	if(base.identifier.is_initialized())
+	{
+		ret.hasIdentifier = true;
+		ret.indexed = true;
+		for(const ERM::TIdentifierInternal & item : base.identifier.get())
+		{
+			if(item.which() == 0)
+			{
+				const ERM::TIexp & iexp = boost::get<ERM::TIexp>(item);
+				ret.identifier.push_back(compileOperand(iexp));
+				if(iexp.which() == 1) //integer constant
+					ret.constIdentifier.push_back(boost::get<int>(iexp));
+				else
+					ret.indexed = false;
+			}
+			else
+			{
+				//arithmetic operations are not evaluated in trigger identifiers and always give -1
+				ERMOperand operand;
+				operand.value = IexpValStr(-1);
+				ret.identifier.push_back(operand);
+				ret.constIdentifier.push_back(-1);
+			}
+		}
+	}
+
+	if(base.condition.is_initialized())
+		ret.condition = compileCondition(base.condition.get());
+
+	//trigger body lasts until next trigger or end of file
+	auto it = scripts.find(trig.line);
+	for(++it; it != scripts.end() && it->first.file == trig.line.file; ++it)
+	{
+		if(isATrigger(it->second))
+			break;
+
+		compileLine(it->first, it->second, ret.code);
+	}
+
+	return ret;
+}
+
+void ERMInterpreter::compileLine(const LinePointer & lp, const ERM::TLine & line, std::vector<ERMInstruction> & code)
+{
+	ERMInstruction instruction;
+	instruction.line = lp;
+	instruction.source = &line;
+
+	if(line.which() == 0) //v-exp
+	{
+		try
+		{
+			instruction.vline = VNode(boost::get<ERM::TVExp>(line));
+			instruction.opcode = ERMInstruction::VERM;
+		}
+		catch(EInterpreterProblem &)
+		{
+			//malformed line, error will be reported when it is executed
+		}
+	}
+	else
+	{
+		const ERM::TERMline & ermline = boost::get<ERM::TERMline>(line);
+		if(ermline.which() != 0) //comment or empty line
+			return;
+
+		const ERM::Tcommand & cmd = boost::get<ERM::Tcommand>(ermline);
+		if(cmd.cmd.which() != 2) //only receivers have any effect inside of trigger
+			return;
+
+		instruction.opcode = ERMInstruction::RECEIVER;
+		instruction.receiver = &boost::get<ERM::Treceiver>(cmd.cmd);
+		if(instruction.receiver->condition.is_initialized())
+			instruction.condition = compileCondition(instruction.receiver->condition.get());
+	}
+
+	code.push_back(instruction);
+}
+
+ERMCondition ERMInterpreter::compileCondition(const ERM::Tcondition & cond) const
+{
+	ERMCondition ret;
+	for(const ERM::Tcondition * current = &cond; current; current = current->rhs.is_initialized() ? &current->rhs.get().get() : nullptr)
+	{
+		ERMConditionTerm term;
+		term.connection = current->ctype;
+		if(current->cond.which() == 0)
+		{
+			const ERM::TComparison & cmp = boost::get<ERM::TComparison>(current->cond);
+			const std::string & op = cmp.compSign;
+
+			if(op == "<")
+				term.opcode = ERMConditionTerm::LT;
+			else if(op == ">")
+				term.opcode = ERMConditionTerm::GT;
+			else if(op == ">=" || op == "=>")
+				term.opcode = ERMConditionTerm::GE;
+			else if(op == "<=" || op == "=<")
+				term.opcode = ERMConditionTerm::LE;
+			else if(op == "==")
+				term.opcode = ERMConditionTerm::EQ;
+			else if(op == "<>" || op == "><")
+				term.opcode = ERMConditionTerm::NE;
+			else
+				term.opcode = ERMConditionTerm::WRONG_SIGN;
+
+			term.compSign = op;
+			term.lhs = compileOperand(cmp.lhs);
+			term.rhs = compileOperand(cmp.rhs);
+		}
+		else
+		{
+			term.opcode = ERMConditionTerm::FLAG;
+			term.flag = boost::get<int>(current->cond);
+		}
+		ret.push_back(term);
+	}
+	return ret;
+}
+
+ERMOperand ERMInterpreter::compileOperand(const ERM::TIexp & iexp) const
+{
+	ERMOperand ret;
+	ret.kind = ERMOperand::IEXP;
+	ret.iexp = iexp;
+
+	if(iexp.which() == 1) //integer constant
+	{
+		ret.kind = ERMOperand::VALUE;
+		ret.value = IexpValStr(boost::get<int>(iexp));
+		return ret;
+	}
+
+	const ERM::TVarExp & var = boost::get<ERM::TVarExp>(iexp);
+	if(var.which() != 0) //macros may be redefined at any time
+		return ret;
+
+	//quick, standard and global string variables have fixed storage, everything else depends on current trigger or function
+	const ERM::TVarExpNotMacro & notMacro = boost::get<ERM::TVarExpNotMacro>(var);
+	if(notMacro.questionMark.is_initialized() || notMacro.varsym.size() != 1)
+		return ret;
+
+	const char letter = notMacro.varsym[0];
+	const bool hasPositiveVal = notMacro.val.is_initialized() && notMacro.val.get() > 0;
+	if((letter >= 'f' && letter <= 't') || ((letter == 'v' || letter == 'z') && hasPositiveVal))
+	{
+		try
+		{
+			ret.value = getVar(notMacro.varsym, notMacro.val);
+			ret.kind = ERMOperand::VALUE;
+		}
+		catch(EInterpreterProblem &)
+		{
+			//out of bounds, error will be reported on use
+		}
+	}
+	return ret;
+}
+
+void ERMInterpreter::executeTrigger(CompiledTrigger & trig, int funNum, const std::vector<int> & funParams)
+{
+	FunctionLocalVars * prevFunc = curFunc;
+	Trigger * prevTrigger = curTrigger;
+	curTrigger = trig.trigger;
+
 	//function-related logic
 	if(funNum != -1)
 	{
@@ -487,19 +684,61 @@ void ERMInterpreter::executeTrigger(VERMInterpreter::Trigger & trig, int funNum,
 	else
 		curFunc = getFuncVars(0);
 
-	//skip the first line
-	LinePointer lp = trig.line;
-	++lp;
-	for(; lp.isValid(); ++lp)
+	for(const ERMInstruction & instruction : trig.code)
+		executeInstruction(instruction);
+
+	//functions may be called from other triggers (DO receiver)
+	curFunc = prevFunc;
+	curTrigger = prevTrigger;
+}
+
+bool ERMInterpreter::matchTrigger(const CompiledTrigger & trig, const TIDPattern & identifier)
+{
+	if(trig.hasIdentifier)
 	{
-		ERM::TLine curLine = retrieveLine(lp);
-		if(isATrigger(curLine))
-			break;
+		auto it = identifier.find(trig.identifier.size());
+		if(it == identifier.end())
+			return false;
+
+		const std::vector<int> & pattern = it->second;
+		if(pattern.size() > trig.identifier.size())
+			return false;
+
+		for(size_t g=0; g<pattern.size(); ++g)
+		{
+			IexpValStr val = getIexp(trig.identifier[g]);
+			if(val.type != IexpValStr::INT && val.type != IexpValStr::INTVAR)
+				throw EScriptExecError("Incompatible i-exp type!");
 
-		executeLine(lp);
+			if(pattern[g] != val.getInt())
+				return false;
+		}
 	}
 
-	curFunc = nullptr;
+	return trig.condition.empty() || checkCondition(trig.condition);
+}
+
+std::vector<size_t> VERMInterpreter::TriggerDispatchTable::getCandidates(const std::map< int, std::vector<int> > & identifier) const
+{
+	std::vector<size_t> ret = unindexed;
+	for(auto & entry : identifier)
+	{
+		if(entry.second.size() != entry.first)
+		{
+			//pattern doesn't follow identifier size, all triggers have to be checked
+			ret.resize(triggers.size());
+			std::iota(ret.begin(), ret.end(), 0);
+			return ret;
+		}
+
+		auto it = byIdentifier.find(entry.second);
+		if(it != byIdentifier.end())
+			ret.insert(ret.end(), it->second.begin(), it->second.end());
+	}
+
+	//triggers are executed in order of appearance
+	std::sort(ret.begin(), ret.end());
+	return ret;
 }
 
 bool ERMInterpreter::isATrigger( const ERM::TLine & line )
@@ -1240,6 +1479,11 @@ void VR_SPerformer::operator()(TStringConstant const& cmp) const
 
 struct ERMExpDispatch : boost::static_visitor<>
 {
+	bool checkConditions; //false if condition was already checked by compiled code
+
+	ERMExpDispatch(bool checkConditions = true) : checkConditions(checkConditions)
+	{}
+
 	struct HLP
 	{
 		int3 getPosFromIdentifier(ERM::Tidentifier tid, bool allowDummyFourth)
@@ -1293,7 +1537,7 @@ struct ERMExpDispatch : boost::static_visitor<>
 	{
 		HLP helper;
 		//check condition
-		if(trig.condition.is_initialized())
+		if(checkConditions && trig.condition.is_initialized())
 		{
 			if( !erm->checkCondition(trig.condition.get()) )
 				return;
@@ -1473,7 +1717,25 @@ void ERMInterpreter::executeLine(const ERM::TLine &line)
 	boost::apply_visitor(LineExec(), line);
 }
 
-IexpValStr ERMInterpreter::getVar(std::string toFollow, boost::optional<int> initVal) const
+void ERMInterpreter::executeInstruction(const ERMInstruction & instruction)
+{
+	logGlobal->debug("Executing line %d (internal %d) from %s", instruction.line.realLineNum, instruction.line.lineNum, instruction.line.file->filename);
+	switch(instruction.opcode)
+	{
+	case ERMInstruction::RECEIVER:
+		if(instruction.condition.empty() || checkCondition(instruction.condition))
+			ERMExpDispatch(false)(*instruction.receiver);
+		break;
+	case ERMInstruction::VERM:
+		eval(instruction.vline);
+		break;
+	case ERMInstruction::LINE:
+		executeLine(*instruction.source);
+		break;
+	}
+}
+
+IexpValStr ERMInterpreter::getVar(const std::string & toFollow, boost::optional<int> initVal) const
 {
 	IexpValStr ret;
 	ret.type = IexpValStr::WRONGVAL;
@@ -1774,6 +2036,14 @@ IexpValStr ERMInterpreter::getIexp( const ERM::TBodyOptionItem & opit ) const
 	return ret;
 }
 
+IexpValStr ERMInterpreter::getIexp(const ERMOperand & operand) const
+{
+	if(operand.kind == ERMOperand::VALUE)
+		return operand.value;
+
+	return getIexp(operand.iexp);
+}
+
 void ERMInterpreter::executeTriggerType(VERMInterpreter::TriggerType tt, bool pre, const TIDPattern & identifier, const std::vector<int> &funParams)
 {
 	struct HLP
@@ -1786,20 +2056,17 @@ void ERMInterpreter::executeTriggerType(VERMInterpreter::TriggerType tt, bool pr
 			return identifier.begin()->second[0];
 		}
 	};
-	TtriggerListType & triggerList = pre ? triggers : postTriggers;
+	TdispatchTablesType & tables = pre ? dispatchTables : postDispatchTables;
+	auto tableIt = tables.find(tt);
+	if(tableIt == tables.end())
+		return;
 
-	TriggerIdentifierMatch tim;
-	tim.allowNoIdetifier = true;
-	tim.ermEnv = this;
-	tim.matchToIt = identifier;
-	std::vector<Trigger> & triggersToTry = triggerList[tt];
-	for(int g=0; g<triggersToTry.size(); ++g)
+	TriggerDispatchTable & table = tableIt->second;
+	for(size_t index : table.getCandidates(identifier))
 	{
-		if(tim.tryMatch(&triggersToTry[g]))
-		{
-			curTrigger = &triggersToTry[g];
-			executeTrigger(triggersToTry[g], HLP::calcFunNum(tt, identifier), funParams);
-		}
+		CompiledTrigger & trig = table.triggers[index];
+		if(matchTrigger(trig, identifier))
+			executeTrigger(trig, HLP::calcFunNum(tt, identifier), funParams);
 	}
 }
 
@@ -1869,6 +2136,28 @@ bool compareExp(const T & lhs, const T & rhs, std::string op)
 		throw EScriptExecError(std::string("Wrong comparison sign: ") + op);
 }
 
+template<typename T>
+bool compareExp(const T & lhs, const T & rhs, const ERMConditionTerm & term)
+{
+	switch(term.opcode)
+	{
+	case ERMConditionTerm::LT:
+		return lhs < rhs;
+	case ERMConditionTerm::GT:
+		return lhs > rhs;
+	case ERMConditionTerm::LE:
+		return lhs <= rhs;
+	case ERMConditionTerm::GE:
+		return lhs >= rhs;
+	case ERMConditionTerm::EQ:
+		return lhs == rhs;
+	case ERMConditionTerm::NE:
+		return lhs != rhs;
+	default:
+		throw EScriptExecError(std::string("Wrong comparison sign: ") + term.compSign);
+	}
+}
+
 struct ConditionDisemboweler : boost::static_visitor<bool>
 {
 	ConditionDisemboweler(ERMInterpreter * _ei) : ei(_ei)
@@ -1951,6 +2240,59 @@ bool ERMInterpreter::checkCondition( ERM::Tcondition cond )
 	return ret;
 }
 
+bool ERMInterpreter::checkCondition(const ERMCondition & cond, size_t first)
+{
+	bool ret = checkConditionTerm(cond[first]);
+	if(first + 1 < cond.size())
+	{ //taking care of rhs expression
+		bool rhs = checkCondition(cond, first + 1);
+		switch (cond[first].connection)
+		{
+		case '&':
+			ret &= rhs;
+			break;
+		case '|':
+			ret |= rhs;
+			break;
+		case 'X':
+			ret ^= rhs;
+			break;
+		default:
+			throw EInterpreterProblem(std::string("Strange - wrong condition connection (") + cond[first].connection + ") !");
+			break;
+		}
+	}
+
+	return ret;
+}
+
+bool ERMInterpreter::checkConditionTerm(const ERMConditionTerm & term) const
+{
+	if(term.opcode == ERMConditionTerm::FLAG)
+		return ermGlobalEnv->getFlag(term.flag);
+
+	IexpValStr lhs = getIexp(term.lhs),
+		rhs = getIexp(term.rhs);
+	switch (lhs.type)
+	{
+	case IexpValStr::FLOATVAR:
+		if(rhs.type != IexpValStr::FLOATVAR)
+			throw EScriptExecError("Incompatible types for comparison");
+		return compareExp(lhs.getFloat(), rhs.getFloat(), term);
+	case IexpValStr::INT:
+	case IexpValStr::INTVAR:
+		if(rhs.type != IexpValStr::INT && rhs.type != IexpValStr::INTVAR)
+			throw EScriptExecError("Incompatible types for comparison");
+		return compareExp(lhs.getInt(), rhs.getInt(), term);
+	case IexpValStr::STRINGVAR:
+		if(rhs.type != IexpValStr::STRINGVAR)
+			throw EScriptExecError("Incompatible types for comparison");
+		return compareExp(lhs.getString(), rhs.getString(), term);
+	default:
+		throw EScriptExecError("Wrong type of left iexp!");
+	}
+}
+
 FunctionLocalVars * ERMInterpreter::getFuncVars( int funNum )
 {
 	if(funNum >= ARRAY_COUNT(funcVars) || funNum < 0)
@@ -1984,81 +2326,6 @@ const std::string ERMInterpreter::postTriggerSymbol = "postTrigger";
 const std::string ERMInterpreter::defunSymbol = "defun";
 
 
-struct TriggerIdMatchHelper : boost::static_visitor<>
-{
-	int & ret;
-	ERMInterpreter * interpreter;
-	Trigger * trig;
-
-	TriggerIdMatchHelper(int & b, ERMInterpreter * ermint, Trigger * _trig)
-	: ret(b), interpreter(ermint), trig(_trig)
-	{}
-
-	void operator()(TIexp const& iexp) const
-	{
-		IexpValStr val = interpreter->getIexp(iexp);
-		switch(val.type)
-		{
-		case IexpValStr::INT:
-		case IexpValStr::INTVAR:
-			ret = val.getInt();
-			break;
-		default:
-			throw EScriptExecError("Incompatible i-exp type!");
-			break;
-		}
-	}
-	void operator()(TArithmeticOp const& arop) const
-	{
-		//error?!?
-	}
-};
-
-bool TriggerIdentifierMatch::tryMatch( Trigger * interptrig ) const
-{
-	bool ret = true;
-
-	const ERM::TTriggerBase & trig = ERMInterpreter::retrieveTrigger(ermEnv->retrieveLine(interptrig->line));
-	if(trig.identifier.is_initialized())
-	{
-
-		ERM::Tidentifier tid = trig.identifier.get();
-		std::map< int, std::vector<int> >::const_iterator it = matchToIt.find(tid.size());
-		if(it == matchToIt.end())
-			ret = false;
-		else
-		{
-			const std::vector<int> & pattern = it->second;
-			for(int g=0; g<pattern.size(); ++g)
-			{
-				int val = -1;
-				boost::apply_visitor(TriggerIdMatchHelper(val, ermEnv, interptrig), tid[g]);
-				if(pattern[g] != val)
-				{
-					ret = false;
-				}
-			}
-		}
-	}
-	else
-	{
-		ret = allowNoIdetifier;
-	}
-
-	//check condition
-	if(ret)
-	{
-		if(trig.condition.is_initialized())
-		{
-			return ermEnv->checkCondition(trig.condition.get());
-		}
-		else //no condition
-			return true;
-	}
-	else
-		return false;
-}
-
 VERMInterpreter::ERMEnvironment::ERMEnvironment()
 {
 	for(int g=0; g<NUM_QUICKS; ++g)
@@ -2382,6 +2649,7 @@ void ERMInterpreter::init()
 
 	scanForScripts();
 	scanScripts();
+	compileScripts();
 
 	executeInstructions();
 	executeTriggerType("PI");
@@ -592,18 +592,6 @@ namespace VERMInterpreter
 	void printVOption(const VOption & opt);
 }
 
-class ERMInterpreter;
-
-struct TriggerIdentifierMatch
-{
-	bool allowNoIdetifier;
-	std::map< int, std::vector<int> > matchToIt; //match subidentifiers to these numbers
-
-	static const int MAX_SUBIDENTIFIERS = 16;
-	ERMInterpreter * ermEnv;
-	bool tryMatch(VERMInterpreter::Trigger * interptrig) const;
-};
-
 struct IexpValStr
 {
 private:
@@ -770,6 +758,74 @@ public:
 	OPERATOR_DEFINITION_INTEGER(%)
 };
 
+//compiled form of scripts, prepared once after scripts are scanned
+namespace VERMInterpreter
+{
+	//i-expression with variable storage resolved at compile time if possible
+	struct ERMOperand
+	{
+		enum EKind {VALUE, IEXP} kind;
+		IexpValStr value; //VALUE: constant or global variable
+		ERM::TIexp iexp; //IEXP: local, indirect and macro variables are resolved on each use
+
+		ERMOperand() : kind(VALUE)
+		{}
+	};
+
+	struct ERMConditionTerm
+	{
+		enum EOpcode {FLAG, LT, GT, LE, GE, EQ, NE, WRONG_SIGN} opcode;
+		int flag;
+		ERMOperand lhs, rhs;
+		std::string compSign; //for error reporting only
+		char connection; //how this term is joined with the following ones
+
+		ERMConditionTerm() : opcode(FLAG), flag(0), connection(0)
+		{}
+	};
+
+	//terms of condition in order of appearance, joined from right to left (like nested Tcondition)
+	typedef std::vector<ERMConditionTerm> ERMCondition;
+
+	struct ERMInstruction
+	{
+		enum EOpcode {RECEIVER, VERM, LINE} opcode; //LINE executes source line the old way
+		LinePointer line;
+		const ERM::TLine * source; //points into ERMInterpreter::scripts
+		const ERM::Treceiver * receiver;
+		ERMCondition condition; //receiver condition
+		VOption vline; //v-expression converted at compile time
+
+		ERMInstruction() : opcode(LINE), source(nullptr), receiver(nullptr)
+		{}
+	};
+
+	struct CompiledTrigger
+	{
+		Trigger * trigger; //points into ERMInterpreter::triggers or postTriggers
+		bool hasIdentifier;
+		bool indexed; //identifier consists of constants only
+		std::vector<ERMOperand> identifier;
+		std::vector<int> constIdentifier; //identifier values if indexed
+		ERMCondition condition;
+		std::vector<ERMInstruction> code; //lines until next trigger
+
+		CompiledTrigger() : trigger(nullptr), hasIdentifier(false), indexed(false)
+		{}
+	};
+
+	//triggers of one type, indexed by constant identifiers
+	struct TriggerDispatchTable
+	{
+		std::vector<CompiledTrigger> triggers; //in order of appearance in scripts
+		std::map<std::vector<int>, std::vector<size_t> > byIdentifier;
+		std::vector<size_t> unindexed; //without identifier or with variables in identifier; they have to be checked every time
+
+		//returns indices of triggers that may match given identifier pattern, in order of appearance
+		std::vector<size_t> getCandidates(const std::map< int, std::vector<int> > & identifier) const;
+	};
+}
+
 class ERMInterpreter : public CScriptingModule
 {
 /*not so*/ public:
@@ -793,6 +849,8 @@ class ERMInterpreter : public CScriptingModule
 	VERMInterpreter::ERMEnvironment * ermGlobalEnv;
 	typedef std::map<VERMInterpreter::TriggerType, std::vector<VERMInterpreter::Trigger> > TtriggerListType;
 	TtriggerListType triggers, postTriggers;
+	typedef std::map<VERMInterpreter::TriggerType, VERMInterpreter::TriggerDispatchTable> TdispatchTablesType;
+	TdispatchTablesType dispatchTables, postDispatchTables;
 	VERMInterpreter::Trigger * curTrigger;
 	VERMInterpreter::FunctionLocalVars * curFunc;
 	static const int TRIG_FUNC_NUM = 30000;
@@ -804,16 +862,26 @@ class ERMInterpreter : public CScriptingModule
 	IexpValStr getIexp(const ERM::TIdentifierInternal & tid) const;
 	IexpValStr getIexp(const ERM::TVarpExp & tid) const;
 	IexpValStr getIexp(const ERM::TBodyOptionItem & opit) const;
+	IexpValStr getIexp(const VERMInterpreter::ERMOperand & operand) const;
 
 	static const std::string triggerSymbol, postTriggerSymbol, defunSymbol;
 
 	void executeLine(const VERMInterpreter::LinePointer & lp);
 	void executeLine(const ERM::TLine &line);
-	void executeTrigger(VERMInterpreter::Trigger & trig, int funNum = -1, std::vector<int> funParams=std::vector<int>());
+	void executeTrigger(VERMInterpreter::CompiledTrigger & trig, int funNum = -1, const std::vector<int> & funParams=std::vector<int>());
+	void executeInstruction(const VERMInterpreter::ERMInstruction & instruction);
+	bool matchTrigger(const VERMInterpreter::CompiledTrigger & trig, const std::map< int, std::vector<int> > & identifier);
 	static bool isCMDATrigger(const ERM::Tcommand & cmd);
 	static bool isATrigger(const ERM::TLine & line);
 	static ERM::EVOtions getExpType(const ERM::TVOption & opt);
-	IexpValStr getVar(std::string toFollow, boost::optional<int> initVal) const;
+	IexpValStr getVar(const std::string & toFollow, boost::optional<int> initVal) const;
+
+	void compileScripts(); //lowers scanned triggers to compiled code and builds dispatch tables
+	void compileTriggers(TtriggerListType & source, TdispatchTablesType & dest);
+	VERMInterpreter::CompiledTrigger compileTrigger(VERMInterpreter::Trigger & trig);
+	void compileLine(const VERMInterpreter::LinePointer & lp, const ERM::TLine & line, std::vector<VERMInterpreter::ERMInstruction> & code);
+	VERMInterpreter::ERMCondition compileCondition(const ERM::Tcondition & cond) const;
+	VERMInterpreter::ERMOperand compileOperand(const ERM::TIexp & iexp) const;
 
 	std::string processERMString(std::string ermstring);
 
@@ -835,6 +903,8 @@ public:
 
 	ERMInterpreter();
 	bool checkCondition( ERM::Tcondition cond );
+	bool checkCondition(const VERMInterpreter::ERMCondition & cond, size_t first = 0);
+	bool checkConditionTerm(const VERMInterpreter::ERMConditionTerm & term) const;
 	int getRealLine(const VERMInterpreter::LinePointer &lp);
 
 	//overload CScriptingModule
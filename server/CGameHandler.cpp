@@ -38,10 +38,14 @@
 #include "CVCMIServer.h"
 #include "../lib/CCreatureSet.h"
 #include "../lib/CThreadHelper.h"
+#include "../lib/CPerformanceCounters.h"
 #include "../lib/GameConstants.h"
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/CGameInterface.h"
+#include "../lib/CConfigHandler.h"
+#include "../lib/battle/CBattleCallback.h"
 
 #ifndef _MSC_VER
 #include <boost/thread/xtime.hpp>
@@ -75,6 +79,18 @@ private:
 	mutable CGameHandler * gh;
 };
 
+/// Callback for battle AI run by server itself, requests are applied immediately on battle thread
+class ServerBattleCallback : public CBattleCallback
+{
+public:
+	ServerBattleCallback(CGameHandler * gh, PlayerColor player);
+	using CCallbackBase::setBattle;
+protected:
+	int sendRequest(const CPack * request) override;
+private:
+	CGameHandler * gh;
+};
+
 CondSh<bool> battleMadeAction(false);
 CondSh<BattleResult *> battleResult(nullptr);
 template <typename T> class CApplyOnGH;
@@ -2601,6 +2617,7 @@ void CGameHandler::sendToAllClients(CPackForClient * info)
 			continue;
 
 		boost::unique_lock<boost::mutex> lock(*(elem)->wmx);
+		CPerformanceTimer timer("serialization");
 		*elem << info;
 	}
 }
@@ -2608,12 +2625,22 @@ void CGameHandler::sendToAllClients(CPackForClient * info)
 void CGameHandler::sendAndApply(CPackForClient * info)
 {
 	sendToAllClients(info);
-	gs->apply(info);
+	notifyServerBattleAIs(info, false);
+	{
+		CPerformanceTimer timer("packApply");
+		gs->apply(info);
+	}
+	notifyServerBattleAIs(info, true);
 }
 
 void CGameHandler::applyAndSend(CPackForClient * info)
 {
-	gs->apply(info);
+	notifyServerBattleAIs(info, false);
+	{
+		CPerformanceTimer timer("packApply");
+		gs->apply(info);
+	}
+	notifyServerBattleAIs(info, true);
 	sendToAllClients(info);
 }
 
@@ -5672,10 +5699,214 @@ bool CGameHandler::swapStacks(const StackLocation &sl1, const StackLocation &sl2
 	}
 }
 
+void CGameHandler::setupServerBattleAIs()
+{
+	releaseServerBattleAIs();
+
+	if(!settings["server"]["serverBattleAI"].Bool())
+		return;
+
+	auto isHuman = [this](PlayerColor color) -> bool
+	{
+		return color != PlayerColor::NEUTRAL && vstd::contains(gs->players, color) && gs->players.at(color).human;
+	};
+
+	//battles with human player are still driven by clients, stacks of both sides may be controlled by that player (hypnotize)
+	if(isHuman(gs->curB->sides[0].color) || isHuman(gs->curB->sides[1].color))
+		return;
+
+	try
+	{
+		for(ui8 side = 0; side < 2; side++)
+		{
+			PlayerColor color = gs->curB->sides[side].color;
+			std::string aiName = settings["server"][color == PlayerColor::NEUTRAL ? "neutralAI" : "enemyAI"].String();
+
+			auto battleAI = CDynLibHandler::getNewBattleAI(aiName);
+			battleAI->dllName = aiName;
+			battleAI->playerID = color;
+			battleAI->human = false;
+
+			auto cb = std::make_shared<ServerBattleCallback>(this, color);
+			cb->setBattle(gs->curB);
+			battleAI->init(cb);
+			battleAI->battleStart(gs->curB->sides[0].armyObject, gs->curB->sides[1].armyObject, gs->curB->tile,
+				gs->curB->battleGetFightingHero(0), gs->curB->battleGetFightingHero(1), side);
+
+			serverBattleAIs[side] = battleAI;
+		}
+		logGlobal->debug("Battle will be resolved by server-side AI");
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to create server-side battle AI, battle will be driven by clients: %s", e.what());
+		serverBattleAIs.fill(nullptr);
+	}
+}
+
+void CGameHandler::releaseServerBattleAIs()
+{
+	for(auto & battleAI : serverBattleAIs)
+	{
+		if(battleAI && battleResult.data)
+			battleAI->battleEnd(battleResult.data);
+		battleAI.reset();
+	}
+	serverBattleAIsAction.reset();
+}
+
+std::shared_ptr<CBattleGameInterface> CGameHandler::getServerBattleAI(const CStack * stack) const
+{
+	PlayerColor controller = stack->owner;
+	if(stack->hasBonusOfType(Bonus::HYPNOTIZED))
+		controller = gs->curB->theOtherPlayer(stack->owner);
+
+	for(ui8 side = 0; side < 2; side++)
+	{
+		if(gs->curB->sides[side].color == controller)
+			return serverBattleAIs[side];
+	}
+	return nullptr;
+}
+
+void CGameHandler::makeServerBattleAIAction(CBattleGameInterface & battleAI, const CStack * stack)
+{
+	auto stackId = stack->ID;
+	BattleAction ba = battleAI.activeStack(stack);
+
+	//AI may have cast a spell before deciding on stack action
+	if(battleResult.get() || battleGetStackByID(stackId, false) != stack || !stack->alive())
+		return;
+
+	if(!makeBattleAction(ba))
+	{
+		logGlobal->warn("Server-side battle AI made invalid action for %s", stack->nodeName());
+		makeStackDoNothing(stack);
+	}
+}
+
+void CGameHandler::notifyServerBattleAIs(const CPackForClient * pack, bool applied)
+{
+	//battle start and end are reported when AIs are set up and released
+	if(!serverBattleAIs[0] && !serverBattleAIs[1])
+		return;
+
+	auto notify = [this](std::function<void(CBattleGameInterface &)> event)
+	{
+		for(auto & battleAI : serverBattleAIs)
+		{
+			if(battleAI)
+				event(*battleAI);
+		}
+	};
+	auto notifyHealed = [&](const StacksHealedOrResurrected & shr)
+	{
+		std::vector<std::pair<ui32, ui32>> healed;
+		for(auto & elem : shr.healedStacks)
+			healed.push_back(std::make_pair(elem.stackId, (ui32)elem.delta));
+		notify([&](CBattleGameInterface & ai){ ai.battleStacksHealedRes(healed, shr.lifeDrain, shr.tentHealing, shr.drainedFrom); });
+	};
+
+	//events are given in the same order as in NetPacksClient.cpp, applyFirstCl before and applyCl after applying pack
+	if(!applied)
+	{
+		if(auto bnr = dynamic_cast<const BattleNextRound *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleNewRoundFirst(bnr->round); });
+		}
+		else if(auto bugs = dynamic_cast<const BattleUpdateGateState *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleGateStateChanged(bugs->state); });
+		}
+		else if(auto bsm = dynamic_cast<const BattleStackMoved *>(pack))
+		{
+			const CStack * movedStack = gs->curB->battleGetStackByID(bsm->stack);
+			notify([&](CBattleGameInterface & ai){ ai.battleStackMoved(movedStack, bsm->tilesToMove, bsm->distance); });
+		}
+		else if(auto bsa = dynamic_cast<const BattleStackAttacked *>(pack))
+		{
+			std::vector<BattleStackAttacked> attacked(1, *bsa);
+			notify([&](CBattleGameInterface & ai){ ai.battleStacksAttacked(attacked); });
+		}
+		else if(auto ba = dynamic_cast<const BattleAttack *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleAttack(ba); });
+			for(auto & elem : ba->bsa)
+			{
+				for(auto & healed : elem.healedStacks)
+					notifyHealed(healed);
+			}
+		}
+		else if(auto sa = dynamic_cast<const StartAction *>(pack))
+		{
+			serverBattleAIsAction = sa->ba;
+			notify([&](CBattleGameInterface & ai){ ai.actionStarted(sa->ba); });
+		}
+		else if(auto bsr = dynamic_cast<const BattleStacksRemoved *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleStacksRemoved(*bsr); });
+		}
+	}
+	else
+	{
+		if(auto bnr = dynamic_cast<const BattleNextRound *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleNewRound(bnr->round); });
+		}
+		else if(auto bte = dynamic_cast<const BattleTriggerEffect *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleTriggerEffect(*bte); });
+		}
+		else if(auto bop = dynamic_cast<const BattleObstaclePlaced *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleObstaclePlaced(*bop->obstacle); });
+		}
+		else if(auto ba = dynamic_cast<const BattleAttack *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleStacksAttacked(ba->bsa); });
+		}
+		else if(auto bsc = dynamic_cast<const BattleSpellCast *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleSpellCast(bsc); });
+		}
+		else if(auto sse = dynamic_cast<const SetStackEffect *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleStacksEffectsSet(*sse); });
+		}
+		else if(auto si = dynamic_cast<const StacksInjured *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleStacksAttacked(si->stacks); });
+		}
+		else if(auto shr = dynamic_cast<const StacksHealedOrResurrected *>(pack))
+		{
+			notifyHealed(*shr);
+		}
+		else if(auto obr = dynamic_cast<const ObstaclesRemoved *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleObstaclesRemoved(obr->obstacles); });
+		}
+		else if(auto ca = dynamic_cast<const CatapultAttack *>(pack))
+		{
+			notify([&](CBattleGameInterface & ai){ ai.battleCatapultAttacked(*ca); });
+		}
+		else if(dynamic_cast<const BattleStackAdded *>(pack))
+		{
+			const CStack * added = gs->curB->stacks.back();
+			notify([&](CBattleGameInterface & ai){ ai.battleNewStackAppeared(added); });
+		}
+		else if(dynamic_cast<const EndAction *>(pack) && serverBattleAIsAction)
+		{
+			notify([&](CBattleGameInterface & ai){ ai.actionFinished(*serverBattleAIsAction); });
+			serverBattleAIsAction.reset();
+		}
+	}
+}
+
 void CGameHandler::runBattle()
 {
 	setBattle(gs->curB);
 	assert(gs->curB);
+	setupServerBattleAIs();
 	//TODO: pre-tactic stuff, call scripts etc.
 
 	//tactic round
@@ -5932,28 +6163,39 @@ void CGameHandler::runBattle()
 					{
 						logGlobal->trace("Activating %s", next->nodeName());
 						auto nextId = next->ID;
+						auto battleAI = getServerBattleAI(next);
 						BattleSetActiveStack sas;
 						sas.stack = nextId;
+						sas.askPlayerInterface = !battleAI;
 						sendAndApply(&sas);
 
-						auto actionWasMade = [&]() -> bool
+						if(battleAI)
 						{
-							if (battleMadeAction.data)//active stack has made its action
-								return true;
-							if (battleResult.get())// battle is finished
-								return true;
-							if (next == nullptr)//active stack was been removed
-								return true;
-							return !next->alive();//active stack is dead
-						};
-
-						boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
-						battleMadeAction.data = false;
-						while (!actionWasMade())
+							makeServerBattleAIAction(*battleAI, next);
+							if(battleGetStackByID(nextId, false) != next)
+								next = nullptr;
+						}
+						else
 						{
-							battleMadeAction.cond.wait(lock);
-							if (battleGetStackByID(nextId, false) != next)
-								next = nullptr; //it may be removed, while we wait
+							auto actionWasMade = [&]() -> bool
+							{
+								if (battleMadeAction.data)//active stack has made its action
+									return true;
+								if (battleResult.get())// battle is finished
+									return true;
+								if (next == nullptr)//active stack was been removed
+									return true;
+								return !next->alive();//active stack is dead
+							};
+
+							boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
+							battleMadeAction.data = false;
+							while (!actionWasMade())
+							{
+								battleMadeAction.cond.wait(lock);
+								if (battleGetStackByID(nextId, false) != next)
+									next = nullptr; //it may be removed, while we wait
+							}
 						}
 					}
 				}
@@ -6005,6 +6247,7 @@ void CGameHandler::runBattle()
 		firstRound = false;
 	}
 
+	releaseServerBattleAIs();
 	endBattle(gs->curB->tile, gs->curB->battleGetFightingHero(0), gs->curB->battleGetFightingHero(1));
 }
 
@@ -6577,3 +6820,28 @@ void ServerSpellCastEnvironment::genericQuery(Query * request, PlayerColor color
 	gh->queries.addQuery(query);
 	gh->sendAndApply(request);
 }
+
+ServerBattleCallback::ServerBattleCallback(CGameHandler * gh, PlayerColor player):
+	CBattleCallback(gh->gameState(), player),
+	gh(gh)
+{
+}
+
+int ServerBattleCallback::sendRequest(const CPack * request)
+{
+	if(auto customAction = dynamic_cast<const MakeCustomAction *>(request))
+	{
+		BattleAction ba = customAction->ba;
+		gh->makeCustomAction(ba);
+	}
+	else if(auto action = dynamic_cast<const MakeAction *>(request))
+	{
+		BattleAction ba = action->ba;
+		gh->makeBattleAction(ba);
+	}
+	else
+	{
+		logGlobal->error("Server-side battle AI sent unsupported request %s", typeid(*request).name());
+	}
+	return 0;
+}
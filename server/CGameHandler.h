@@ -27,6 +27,7 @@ struct SetResources;
 struct NewStructures;
 class CGHeroInstance;
 class IMarket;
+class CBattleGameInterface;
 
 class SpellCastEnvironment;
 
@@ -295,6 +296,19 @@ public:
 	CRandomGenerator & getRandomGenerator();
 
 private:
+	/// Battle AIs run by server itself when no human takes part in the battle, indexed by side.
+	/// Stacks controlled by them act without round trip to clients. Empty if battle is driven by clients.
+	std::array<std::shared_ptr<CBattleGameInterface>, 2> serverBattleAIs;
+	boost::optional<BattleAction> serverBattleAIsAction; //action in progress, reported to AIs when it ends
+
+	void setupServerBattleAIs();
+	void releaseServerBattleAIs();
+	std::shared_ptr<CBattleGameInterface> getServerBattleAI(const CStack * stack) const; //AI that has to make action for given stack, nullptr if it's client's job
+	void makeServerBattleAIAction(CBattleGameInterface & battleAI, const CStack * stack);
+	/// Passes battle events to server battle AIs, same as client does with its battle interfaces
+	/// @param applied false if pack is going to be applied, true if it was already applied to game state
+	void notifyServerBattleAIs(const CPackForClient * pack, bool applied);
+
 	std::list<PlayerColor> generatePlayerTurnOrder() const;
 	void makeStackDoNothing(const CStack * next);
 	void getVictoryLossMessage(PlayerColor player, const EVictoryLossCheckResult & victoryLossCheckResult, InfoWindow & out) const;
@@ -38,6 +38,7 @@
 #include "CGameHandler.h"
 #include "../lib/mapping/CMapInfo.h"
 #include "../lib/GameConstants.h"
+#include "../lib/CPerformanceCounters.h"
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/CConfigHandler.h"
 #include "../lib/ScopeGuard.h"
@@ -542,7 +543,8 @@ static void handleCommandOptions(int argc, char *argv[])
 		("uuid", po::value<std::string>(), "")
 		("enable-shm-uuid", "use UUID for shared memory identifier")
 		("enable-shm", "enable usage of shared memory")
-		("port", po::value<ui16>(), "port at which server will listen to connections from client");
+		("port", po::value<ui16>(), "port at which server will listen to connections from client")
+		("benchmark-report", po::value<std::string>(), "measure performance of game phases and save report to given file on exit");
 
 	if(argc > 1)
 	{
@@ -625,6 +627,7 @@ int main(int argc, char * argv[])
 	preinitDLL(console);
 	settings.init();
 	logConfig.configure();
+	CPerformanceCounters::get().setEnabled(cmdLineOptions.count("benchmark-report"));
 
 	loadDLLClasses();
 	srand ( (ui32)time(nullptr) );
@@ -662,6 +665,12 @@ int main(int argc, char * argv[])
 	CAndroidVMHelper envHelper;
 	envHelper.callStaticVoidMethod(CAndroidVMHelper::NATIVE_METHODS_DEFAULT_CLASS, "killServer");
 #endif
+	if(cmdLineOptions.count("benchmark-report"))
+	{
+		const std::string reportPath = cmdLineOptions["benchmark-report"].as<std::string>();
+		CPerformanceCounters::saveReport(reportPath, CPerformanceCounters::get().toJson());
+		logGlobal->info("Performance report has been saved to %s", reportPath);
+	}
 	vstd::clear_pointer(VLC);
 	CResourceHandler::clear();
 	return 0;
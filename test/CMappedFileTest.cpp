@@ -0,0 +1,82 @@
+/*
+ * CMappedFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/filesystem/CMappedFile.h"
+
+#include <zlib.h>
+
+struct CMappedFileTest : testing::Test
+{
+	boost::filesystem::path path;
+	std::vector<ui8> plain;
+	std::vector<ui8> compressed;
+
+	void SetUp() override
+	{
+		for(int i = 0; i < 4096; i++)
+			plain.push_back(i % 251);
+
+		uLongf compressedSize = compressBound(plain.size());
+		compressed.resize(compressedSize);
+		compress(compressed.data(), &compressedSize, plain.data(), plain.size());
+		compressed.resize(compressedSize);
+
+		path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		std::ofstream file(path.string(), std::ios::binary);
+		file.write(reinterpret_cast<const char *>(plain.data()), plain.size());
+		file.write(reinterpret_cast<const char *>(compressed.data()), compressed.size());
+	}
+
+	void TearDown() override
+	{
+		boost::filesystem::remove(path);
+	}
+};
+
+TEST_F(CMappedFileTest, plainStream)
+{
+	auto file = std::make_shared<CMappedFile>(path);
+	EXPECT_EQ(file->getSize(), plain.size() + compressed.size());
+
+	CMappedFileStream subject(file, 16, 100);
+	EXPECT_EQ(subject.getSize(), 100);
+
+	ui8 data[200];
+	EXPECT_EQ(subject.read(data, 200), 100);
+	EXPECT_TRUE(std::equal(data, data + 100, plain.begin() + 16));
+	EXPECT_EQ(subject.tell(), 100);
+
+	subject.seek(10);
+	EXPECT_EQ(subject.read(data, 1), 1);
+	EXPECT_EQ(data[0], plain[26]);
+}
+
+TEST_F(CMappedFileTest, compressedStreamWhole)
+{
+	auto file = std::make_shared<CMappedFile>(path);
+	CMappedCompressedStream subject(file, plain.size(), compressed.size(), plain.size());
+
+	auto data = subject.readAll();
+	ASSERT_EQ(data.second, plain.size());
+	EXPECT_TRUE(std::equal(data.first.get(), data.first.get() + data.second, plain.begin()));
+}
+
+TEST_F(CMappedFileTest, compressedStreamPartial)
+{
+	auto file = std::make_shared<CMappedFile>(path);
+	CMappedCompressedStream subject(file, plain.size(), compressed.size(), plain.size());
+
+	ui8 data[16];
+	subject.seek(1000);
+	EXPECT_EQ(subject.read(data, 16), 16);
+	EXPECT_TRUE(std::equal(data, data + 16, plain.begin() + 1000));
+	EXPECT_EQ(subject.tell(), 1016);
+}
@@ -0,0 +1,159 @@
+/*
+ * CObjectRegistryTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CObjectRegistry.h"
+#include "../lib/NetPacks.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+
+class CObjectRegistryTest : public ::testing::Test
+{
+protected:
+	CMap map;
+	CObjectRegistry subject;
+
+	CObjectRegistryTest()
+	{
+		map.width = 20;
+		map.height = 20;
+		map.twoLevel = false;
+		map.initTerrain();
+	}
+
+	CGObjectInstance * addObject(Obj type, si32 subID, PlayerColor owner, int3 pos)
+	{
+		auto obj = new CGObjectInstance();
+		obj->ID = type;
+		obj->subID = subID;
+		obj->tempOwner = owner;
+		obj->pos = pos;
+		obj->id = ObjectInstanceID(map.objects.size());
+		map.objects.push_back(obj);
+		map.getTile(pos).visitableObjects.push_back(obj);
+		return obj;
+	}
+
+	void moveObject(CGObjectInstance * obj, int3 to)
+	{
+		vstd::erase_if_present(map.getTile(obj->pos).visitableObjects, obj);
+		TryMoveHero pack;
+		pack.id = obj->id;
+		pack.result = TryMoveHero::SUCCESS;
+		pack.start = CGHeroInstance::convertPosition(obj->pos, true);
+		pack.end = CGHeroInstance::convertPosition(to, true);
+		obj->pos = to;
+		map.getTile(to).visitableObjects.push_back(obj);
+		subject.packApplied(&map, &pack);
+	}
+};
+
+TEST_F(CObjectRegistryTest, indexesByOwnerAndType)
+{
+	auto mine = addObject(Obj::MINE, 1, PlayerColor(0), int3(1, 1, 0));
+	auto art = addObject(Obj::ARTIFACT, 5, PlayerColor::NEUTRAL, int3(2, 2, 0));
+	addObject(Obj::ARTIFACT, 6, PlayerColor::NEUTRAL, int3(3, 3, 0));
+
+	auto owned = subject.getObjectsOfOwner(&map, PlayerColor(0));
+	ASSERT_EQ(1, owned.size());
+	EXPECT_EQ(mine, owned[0]);
+	EXPECT_EQ(2, subject.getObjectsOfType(&map, Obj::ARTIFACT).size());
+
+	auto arts = subject.getObjectsOfType(&map, Obj::ARTIFACT, 5);
+	ASSERT_EQ(1, arts.size());
+	EXPECT_EQ(art, arts[0]);
+	EXPECT_TRUE(subject.getObjectsOfType(&map, Obj::TOWN).empty());
+}
+
+TEST_F(CObjectRegistryTest, findsVisitableTilesInArea)
+{
+	addObject(Obj::ARTIFACT, 0, PlayerColor::NEUTRAL, int3(7, 7, 0));
+	addObject(Obj::ARTIFACT, 0, PlayerColor::NEUTRAL, int3(9, 7, 0));
+	addObject(Obj::ARTIFACT, 0, PlayerColor::NEUTRAL, int3(15, 15, 0));
+	addObject(Obj::ARTIFACT, 0, PlayerColor::NEUTRAL, int3(9, 3, 0));
+
+	auto found = subject.getVisitableTiles(&map, int3(5, 5, 0), int3(8, 8, 0));
+	ASSERT_EQ(1, found.size());
+	EXPECT_EQ(int3(7, 7, 0), found[0]);
+
+	//same order as iterating over all tiles of map
+	auto all = subject.getVisitableTiles(&map, int3(-5, -5, 0), int3(100, 100, 0));
+	ASSERT_EQ(4, all.size());
+	EXPECT_EQ(int3(7, 7, 0), all[0]);
+	EXPECT_EQ(int3(9, 3, 0), all[1]);
+	EXPECT_EQ(int3(9, 7, 0), all[2]);
+	EXPECT_EQ(int3(15, 15, 0), all[3]);
+}
+
+TEST_F(CObjectRegistryTest, findsEveryVisitableTileOfObject)
+{
+	auto obj = addObject(Obj::MONOLITH_TWO_WAY, 0, PlayerColor::NEUTRAL, int3(9, 9, 0));
+	map.getTile(int3(7, 9, 0)).visitableObjects.push_back(obj);
+
+	auto found = subject.getVisitableTiles(&map, int3(5, 5, 0), int3(7, 9, 0));
+	ASSERT_EQ(1, found.size());
+	EXPECT_EQ(int3(7, 9, 0), found[0]);
+}
+
+TEST_F(CObjectRegistryTest, followsMovingHero)
+{
+	auto hero = addObject(Obj::HERO, 0, PlayerColor(0), int3(2, 2, 0));
+	EXPECT_EQ(1, subject.getVisitableTiles(&map, int3(0, 0, 0), int3(3, 3, 0)).size());
+
+	moveObject(hero, int3(12, 12, 0));
+	EXPECT_TRUE(subject.getVisitableTiles(&map, int3(0, 0, 0), int3(3, 3, 0)).empty());
+	EXPECT_EQ(1, subject.getVisitableTiles(&map, int3(10, 10, 0), int3(13, 13, 0)).size());
+}
+
+TEST_F(CObjectRegistryTest, followsNewAndRemovedObjects)
+{
+	auto first = addObject(Obj::MINE, 1, PlayerColor(0), int3(1, 1, 0));
+	EXPECT_EQ(1, subject.getObjectsOfType(&map, Obj::MINE).size());
+
+	auto second = addObject(Obj::MINE, 1, PlayerColor(0), int3(12, 1, 0));
+	NewObject added;
+	added.id = second->id;
+	subject.packApplied(&map, &added);
+
+	auto mines = subject.getObjectsOfType(&map, Obj::MINE, 1);
+	ASSERT_EQ(2, mines.size());
+	EXPECT_EQ(first, mines[0]);
+	EXPECT_EQ(second, mines[1]);
+	EXPECT_EQ(2, subject.getVisitableTiles(&map, int3(0, 0, 0), int3(19, 19, 0)).size());
+
+	vstd::erase_if_present(map.getTile(first->pos).visitableObjects, first);
+	map.objects[first->id.getNum()].dellNull();
+	RemoveObject removed(ObjectInstanceID(0));
+	subject.packApplied(&map, &removed);
+
+	auto owned = subject.getObjectsOfOwner(&map, PlayerColor(0));
+	ASSERT_EQ(1, owned.size());
+	EXPECT_EQ(second, owned[0]);
+	auto tiles = subject.getVisitableTiles(&map, int3(0, 0, 0), int3(19, 19, 0));
+	ASSERT_EQ(1, tiles.size());
+	EXPECT_EQ(int3(12, 1, 0), tiles[0]);
+}
+
+TEST_F(CObjectRegistryTest, followsOwnerChange)
+{
+	auto first = addObject(Obj::MINE, 1, PlayerColor(0), int3(1, 1, 0));
+	auto second = addObject(Obj::MINE, 1, PlayerColor(1), int3(2, 1, 0));
+	EXPECT_EQ(1, subject.getObjectsOfOwner(&map, PlayerColor(0)).size());
+
+	first->tempOwner = PlayerColor(1);
+	SetObjectProperty pack(first->id, ObjProperty::OWNER, 1);
+	subject.packApplied(&map, &pack);
+	EXPECT_TRUE(subject.getObjectsOfOwner(&map, PlayerColor(0)).empty());
+
+	auto owned = subject.getObjectsOfOwner(&map, PlayerColor(1));
+	ASSERT_EQ(2, owned.size());
+	EXPECT_EQ(first, owned[0]);
+	EXPECT_EQ(second, owned[1]);
+}
@@ -0,0 +1,85 @@
+/*
+ * CPerformanceCountersTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CPerformanceCounters.h"
+
+static JsonNode makeReport(double pathfindingMs, double serverPackApplyMs)
+{
+	JsonNode report;
+	report["phases"]["pathfinding"]["totalMs"].Float() = pathfindingMs;
+	report["server"]["phases"]["packApply"]["totalMs"].Float() = serverPackApplyMs;
+	return report;
+}
+
+TEST(CPerformanceCountersTest, accumulatesPhases)
+{
+	CPerformanceCounters subject;
+	subject.record("pathfinding", 1000);
+	subject.record("pathfinding", 3000);
+	subject.record("packApply", 500);
+
+	auto counters = subject.getCounters();
+	ASSERT_EQ(2, counters.size());
+	EXPECT_EQ(2, counters["pathfinding"].calls);
+	EXPECT_EQ(4000, counters["pathfinding"].totalTime);
+	EXPECT_EQ(3000, counters["pathfinding"].maxTime);
+
+	JsonNode report = subject.toJson();
+	EXPECT_DOUBLE_EQ(4.0, report["phases"]["pathfinding"]["totalMs"].Float());
+	EXPECT_DOUBLE_EQ(2.0, report["phases"]["pathfinding"]["averageMs"].Float());
+	EXPECT_DOUBLE_EQ(3.0, report["phases"]["pathfinding"]["maxMs"].Float());
+	EXPECT_EQ(1, report["phases"]["packApply"]["calls"].Integer());
+
+	subject.reset();
+	EXPECT_TRUE(subject.getCounters().empty());
+}
+
+TEST(CPerformanceCountersTest, timerRecordsOnlyWhenEnabled)
+{
+	CPerformanceCounters & counters = CPerformanceCounters::get();
+	counters.reset();
+
+	counters.setEnabled(false);
+	{
+		CPerformanceTimer timer("test");
+		CPerformanceTimer subphaseTimer("test", "sub");
+	}
+	EXPECT_TRUE(counters.getCounters().empty());
+
+	counters.setEnabled(true);
+	{
+		CPerformanceTimer timer("test");
+		CPerformanceTimer subphaseTimer("test", "sub");
+	}
+	counters.setEnabled(false);
+	EXPECT_EQ(1, counters.getCounters()["test"].calls);
+	EXPECT_EQ(1, counters.getCounters()["test.sub"].calls);
+	counters.reset();
+}
+
+TEST(CPerformanceCountersTest, comparesWithBaseline)
+{
+	JsonNode baseline = makeReport(100, 200);
+
+	EXPECT_TRUE(CPerformanceCounters::compare(makeReport(105, 200), baseline, 0.1).empty());
+	EXPECT_TRUE(CPerformanceCounters::compare(makeReport(50, 150), baseline, 0.1).empty());
+	EXPECT_EQ(1, CPerformanceCounters::compare(makeReport(120, 200), baseline, 0.1).size());
+
+	auto regressions = CPerformanceCounters::compare(makeReport(100, 300), baseline, 0.1);
+	ASSERT_EQ(1, regressions.size());
+	EXPECT_EQ(0, regressions[0].find("server.packApply"));
+}
+
+TEST(CPerformanceCountersTest, ignoresDifferencesBelowMillisecond)
+{
+	JsonNode baseline = makeReport(0.1, 0);
+	EXPECT_TRUE(CPerformanceCounters::compare(makeReport(0.5, 0), baseline, 0.1).empty());
+}
@@ -0,0 +1,106 @@
+/*
+ * CVictoryConditionTrackerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CVictoryConditionTracker.h"
+#include "../lib/CCreatureHandler.h"
+#include "../lib/NetPacks.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CArmedInstance.h"
+
+class CVictoryConditionTrackerTest : public ::testing::Test
+{
+protected:
+	CCreature creature;
+	CMap map;
+	CVictoryConditionTracker subject;
+
+	CVictoryConditionTrackerTest()
+	{
+		creature.idNumber = CreatureID(7);
+	}
+
+	CArmedInstance * addArmy(Obj type, PlayerColor owner, TQuantity count)
+	{
+		auto army = new CArmedInstance();
+		army->ID = type;
+		army->tempOwner = owner;
+		army->id = ObjectInstanceID(map.objects.size());
+		map.objects.push_back(army);
+
+		if(count)
+		{
+			auto stack = new CStackInstance();
+			stack->setType(&creature);
+			stack->count = count;
+			army->putStack(SlotID(0), stack);
+		}
+		return army;
+	}
+};
+
+TEST_F(CVictoryConditionTrackerTest, countsObjectsAndCreatures)
+{
+	addArmy(Obj::GARRISON, PlayerColor(0), 10);
+	addArmy(Obj::GARRISON, PlayerColor(1), 5);
+	addArmy(Obj::MONSTER, PlayerColor::NEUTRAL, 20);
+
+	EXPECT_EQ(10, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+	EXPECT_EQ(20, subject.getCreatureCount(&map, PlayerColor::NEUTRAL, creature.idNumber));
+	EXPECT_EQ(0, subject.getCreatureCount(&map, PlayerColor(2), creature.idNumber));
+	EXPECT_EQ(2, subject.getObjectCount(&map, Obj::GARRISON));
+	EXPECT_EQ(1, subject.getObjectCount(&map, Obj::GARRISON, PlayerColor(1)));
+	EXPECT_EQ(0, subject.getObjectCount(&map, Obj::TOWN));
+}
+
+TEST_F(CVictoryConditionTrackerTest, updatesArmiesAfterGarrisonOperation)
+{
+	CArmedInstance * army = addArmy(Obj::GARRISON, PlayerColor(0), 10);
+	EXPECT_EQ(10, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+
+	army->setStackCount(SlotID(0), 25);
+	ChangeStackCount pack;
+	pack.sl = StackLocation(army, SlotID(0));
+	subject.packApplied(&map, &pack);
+	EXPECT_EQ(25, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+}
+
+TEST_F(CVictoryConditionTrackerTest, followsOwnerChange)
+{
+	CArmedInstance * army = addArmy(Obj::GARRISON, PlayerColor(0), 10);
+	EXPECT_EQ(1, subject.getObjectCount(&map, Obj::GARRISON, PlayerColor(0)));
+
+	army->tempOwner = PlayerColor(1);
+	SetObjectProperty pack(army->id, ObjProperty::OWNER, 1);
+	subject.packApplied(&map, &pack);
+	EXPECT_EQ(0, subject.getObjectCount(&map, Obj::GARRISON, PlayerColor(0)));
+	EXPECT_EQ(1, subject.getObjectCount(&map, Obj::GARRISON, PlayerColor(1)));
+	EXPECT_EQ(0, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+	EXPECT_EQ(10, subject.getCreatureCount(&map, PlayerColor(1), creature.idNumber));
+}
+
+TEST_F(CVictoryConditionTrackerTest, followsNewAndRemovedObjects)
+{
+	CArmedInstance * first = addArmy(Obj::GARRISON, PlayerColor(0), 10);
+	EXPECT_EQ(1, subject.getObjectCount(&map, Obj::GARRISON));
+
+	CArmedInstance * second = addArmy(Obj::GARRISON, PlayerColor(0), 5);
+	NewObject added;
+	added.id = second->id;
+	subject.packApplied(&map, &added);
+	EXPECT_EQ(2, subject.getObjectCount(&map, Obj::GARRISON));
+	EXPECT_EQ(15, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+
+	map.objects[first->id.getNum()].dellNull();
+	RemoveObject removed(ObjectInstanceID(0));
+	subject.packApplied(&map, &removed);
+	EXPECT_EQ(1, subject.getObjectCount(&map, Obj::GARRISON, PlayerColor(0)));
+	EXPECT_EQ(5, subject.getCreatureCount(&map, PlayerColor(0), creature.idNumber));
+}
@@ -166,3 +166,23 @@ TEST(MapManager, DrawTerrain_View)
 		throw;
 	}
 }
+
+TEST(MapManager, TerrainViewPatternLookup)
+{
+	const auto & config = *VLC->terviewh;
+	typedef CTerrainViewPatternConfig::PatternMatch PatternMatch;
+
+	// all neighbours are native - no transition
+	auto match = config.findTerrainViewPattern(ETerrainGroup::NORMAL, 0);
+	ASSERT_EQ(match.result, PatternMatch::MATCH);
+	EXPECT_EQ(config.getTerrainViewPatternsForGroup(ETerrainGroup::NORMAL)[match.pattern].front().id, "n1");
+	EXPECT_EQ(match.flip, 0);
+	EXPECT_TRUE(match.transitionReplacement.empty());
+	EXPECT_EQ(config.findTerrainTypePattern(ETerrainGroup::NORMAL, "n1", 0).result, PatternMatch::MATCH);
+
+	// all neighbours are of a foreign sand type
+	CTerrainViewPatternConfig::TNeighbourhoodKey sandKey = 0;
+	for(int i = 0; i < 8; ++i)
+		sandKey = sandKey * ETerrainViewCell::COUNT + ETerrainViewCell::ALIEN_SAND;
+	EXPECT_EQ(config.findTerrainTypePattern(ETerrainGroup::NORMAL, "n1", sandKey).result, PatternMatch::NO_MATCH);
+}
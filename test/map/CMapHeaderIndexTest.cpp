@@ -0,0 +1,178 @@
+/*
+ * CMapHeaderIndexTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../lib/filesystem/AdapterLoaders.h"
+#include "../lib/filesystem/CFilesystemLoader.h"
+#include "../lib/filesystem/Filesystem.h"
+#include "../lib/filesystem/ResourceID.h"
+#include "../lib/mapping/CMapHeaderIndex.h"
+#include "../lib/mapping/CMapService.h"
+
+struct CMapHeaderIndexTest : testing::Test
+{
+	boost::filesystem::path path;
+	boost::filesystem::path mapsDir;
+	std::unordered_set<ResourceID> files;
+	std::vector<ISimpleResourceLoader *> mounted; //owned by global filesystem, removed in TearDown
+
+	void SetUp() override
+	{
+		path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		mapsDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		files.insert(ResourceID("test/TerrainViewTest", EResType::MAP));
+	}
+
+	void TearDown() override
+	{
+		for(auto loader : mounted)
+			getFilesystem()->removeLoader(loader);
+		mounted.clear();
+
+		boost::filesystem::remove(path);
+		boost::filesystem::remove_all(mapsDir);
+	}
+
+	/// Mounts directory with single map file, returns resource of that map
+	ResourceID mountMap()
+	{
+		boost::filesystem::create_directories(mapsDir);
+		std::ofstream(getMapFile().string(), std::ios::binary);
+
+		std::string mountPoint = mapsDir.filename().string() + "/";
+		auto loader = new CFilesystemLoader(mountPoint, mapsDir);
+		getFilesystem()->addLoader(loader, false);
+		mounted.push_back(loader);
+		return ResourceID(mountPoint + "map", EResType::MAP);
+	}
+
+	static CFilesystemList * getFilesystem()
+	{
+		auto filesystem = dynamic_cast<CFilesystemList *>(CResourceHandler::get());
+		assert(filesystem);
+		return filesystem;
+	}
+
+	boost::filesystem::path getMapFile() const
+	{
+		return mapsDir / "map.h3m";
+	}
+
+	/// Rewrites map file, either with test map or with garbage, and moves its modification time forward
+	void rewriteMap(bool valid)
+	{
+		std::time_t modified = boost::filesystem::last_write_time(getMapFile());
+		if(valid)
+		{
+			auto source = CResourceHandler::get()->getResourceName(*files.begin());
+			boost::filesystem::copy_file(*source, getMapFile(), boost::filesystem::copy_option::overwrite_if_exists);
+		}
+		else
+		{
+			std::ofstream file(getMapFile().string(), std::ios::binary);
+			file << "not a map";
+		}
+		boost::filesystem::last_write_time(getMapFile(), modified + 10);
+	}
+};
+
+TEST_F(CMapHeaderIndexTest, parsesNewMaps)
+{
+	CMapHeaderIndex subject(path);
+	auto headers = subject.getHeaders(files);
+	auto expected = CMapService::loadMapHeader(*files.begin());
+
+	ASSERT_EQ(1, headers.size());
+	EXPECT_EQ(1, subject.getParsedCount());
+	const CMapHeader * header = headers[files.begin()->getName()];
+	ASSERT_TRUE(header != nullptr);
+	EXPECT_EQ(expected->width, header->width);
+	EXPECT_EQ(expected->name, header->name);
+}
+
+TEST_F(CMapHeaderIndexTest, reusesSavedHeaders)
+{
+	{
+		CMapHeaderIndex subject(path);
+		subject.getHeaders(files);
+		subject.save();
+	}
+
+	CMapHeaderIndex subject(path);
+	auto headers = subject.getHeaders(files);
+	auto expected = CMapService::loadMapHeader(*files.begin());
+
+	ASSERT_EQ(1, headers.size());
+	EXPECT_EQ(0, subject.getParsedCount());
+	EXPECT_EQ(expected->height, headers.begin()->second->height);
+	EXPECT_EQ(expected->players.size(), headers.begin()->second->players.size());
+}
+
+TEST_F(CMapHeaderIndexTest, dropsRemovedMaps)
+{
+	CMapHeaderIndex subject(path);
+	subject.getHeaders(files);
+
+	EXPECT_TRUE(subject.getHeaders(std::unordered_set<ResourceID>()).empty());
+	EXPECT_EQ(1, subject.getHeaders(files).size());
+	EXPECT_EQ(1, subject.getParsedCount());
+}
+
+TEST_F(CMapHeaderIndexTest, ignoresDamagedIndex)
+{
+	{
+		std::ofstream file(path.string(), std::ios::binary);
+		file << "not an index";
+	}
+
+	CMapHeaderIndex subject(path);
+	EXPECT_EQ(1, subject.getHeaders(files).size());
+	EXPECT_EQ(1, subject.getParsedCount());
+}
+
+TEST_F(CMapHeaderIndexTest, reparsesChangedMaps)
+{
+	std::unordered_set<ResourceID> mounted;
+	mounted.insert(mountMap());
+	rewriteMap(true);
+
+	CMapHeaderIndex subject(path);
+	EXPECT_EQ(1, subject.getHeaders(mounted).size());
+	EXPECT_EQ(1, subject.getParsedCount());
+	EXPECT_EQ(1, subject.getHeaders(mounted).size());
+	EXPECT_EQ(0, subject.getParsedCount());
+
+	rewriteMap(true);
+	EXPECT_EQ(1, subject.getHeaders(mounted).size());
+	EXPECT_EQ(1, subject.getParsedCount());
+}
+
+TEST_F(CMapHeaderIndexTest, remembersInvalidMaps)
+{
+	std::unordered_set<ResourceID> mounted;
+	mounted.insert(mountMap());
+	rewriteMap(false);
+
+	{
+		CMapHeaderIndex subject(path);
+		EXPECT_TRUE(subject.getHeaders(mounted).empty());
+		EXPECT_EQ(1, subject.getParsedCount());
+		subject.save();
+	}
+
+	CMapHeaderIndex subject(path);
+	EXPECT_TRUE(subject.getHeaders(mounted).empty());
+	EXPECT_EQ(0, subject.getParsedCount());
+
+	rewriteMap(true);
+	EXPECT_EQ(1, subject.getHeaders(mounted).size());
+	EXPECT_EQ(1, subject.getParsedCount());
+}
@@ -0,0 +1,68 @@
+/*
+ * CTileBucketsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/rmg/CTileBuckets.h"
+#include "../lib/CRandomGenerator.h"
+
+TEST(CTileBucketsTest, hasTileWithin)
+{
+	CTileBuckets subject(36, 36, 10);
+	EXPECT_FALSE(subject.hasTileWithin(int3(5, 5, 0), 100));
+
+	subject.insert(int3(12, 12, 0));
+	EXPECT_TRUE(subject.hasTileWithin(int3(12, 2, 0), 100));
+	EXPECT_TRUE(subject.hasTileWithin(int3(18, 20, 0), 100));
+	EXPECT_FALSE(subject.hasTileWithin(int3(19, 20, 0), 100));
+	EXPECT_FALSE(subject.hasTileWithin(int3(35, 35, 0), 100));
+	EXPECT_TRUE(subject.hasTileWithin(int3(12, 12, 1), 0)); //z is ignored
+}
+
+TEST(CTileBucketsTest, matchesLinearScan)
+{
+	CRandomGenerator rand;
+	rand.setSeed(42);
+	CTileBuckets subject(50, 40, 8);
+	std::vector<int3> tiles;
+
+	for(int i = 0; i < 30; i++)
+	{
+		int3 tile(rand.nextInt(49), rand.nextInt(39), 0);
+		subject.insert(tile);
+		tiles.push_back(tile);
+	}
+
+	for(int i = 0; i < 500; i++)
+	{
+		int3 pos(rand.nextInt(-5, 54), rand.nextInt(-5, 44), 0);
+		ui32 distance = rand.nextInt(200);
+
+		bool expected = false;
+		for(auto & tile : tiles)
+			expected |= pos.dist2dSQ(tile) <= distance;
+
+		EXPECT_EQ(subject.hasTileWithin(pos, distance), expected);
+	}
+}
+
+TEST(CTileBucketsTest, minDistIsLowerBound)
+{
+	CTileBuckets subject(20, 20, 4);
+	for(int x = 0; x < 20; x += 3)
+		for(int y = 0; y < 20; y += 2)
+			subject.insert(int3(x, y, 0));
+
+	int3 pos(7, 13, 0);
+	for(auto bucket : subject.getBuckets())
+	{
+		for(auto & tile : bucket->tiles)
+			EXPECT_GE(pos.dist2dSQ(tile), bucket->minDist2dSQ(pos));
+	}
+}
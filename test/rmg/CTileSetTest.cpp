@@ -0,0 +1,67 @@
+/*
+ * CTileSetTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/rmg/CTileSet.h"
+
+TEST(CTileSetTest, insertAndErase)
+{
+	CTileSet subject(int3(10, 8, 2));
+	EXPECT_TRUE(subject.empty());
+
+	EXPECT_TRUE(subject.insert(int3(3, 4, 1)).second);
+	EXPECT_FALSE(subject.insert(int3(3, 4, 1)).second);
+	EXPECT_EQ(subject.size(), 1);
+	EXPECT_TRUE(subject.contains(int3(3, 4, 1)));
+	EXPECT_FALSE(subject.contains(int3(3, 4, 0)));
+	EXPECT_FALSE(subject.contains(int3(-1, 4, 1)));
+
+	EXPECT_EQ(subject.erase(int3(3, 4, 1)), 1);
+	EXPECT_EQ(subject.erase(int3(3, 4, 1)), 0);
+	EXPECT_TRUE(subject.empty());
+
+	EXPECT_THROW(subject.insert(int3(10, 0, 0)), std::runtime_error);
+}
+
+TEST(CTileSetTest, iteratesInSetOrder)
+{
+	CTileSet subject(int3(16, 16, 2));
+	std::set<int3> expected;
+
+	for(int i = 0; i < 100; i++)
+	{
+		int3 tile((i * 7) % 16, (i * 5) % 16, i % 2);
+		subject.insert(tile);
+		expected.insert(tile);
+	}
+
+	ASSERT_EQ(subject.size(), expected.size());
+	EXPECT_TRUE(std::equal(expected.begin(), expected.end(), subject.begin()));
+	EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), std::reverse_iterator<CTileSet::const_iterator>(subject.end())));
+}
+
+TEST(CTileSetTest, unionAndDifference)
+{
+	CTileSet a(int3(4, 4, 1)), b(int3(4, 4, 1));
+	a.insert(int3(0, 0, 0));
+	a.insert(int3(1, 1, 0));
+	b.insert(int3(1, 1, 0));
+	b.insert(int3(2, 2, 0));
+
+	CTileSet sum = a;
+	sum |= b;
+	EXPECT_EQ(sum.size(), 3);
+
+	a -= b;
+	EXPECT_EQ(a.size(), 1);
+	EXPECT_TRUE(a.contains(int3(0, 0, 0)));
+
+	EXPECT_THROW(a |= CTileSet(int3(5, 4, 1)), std::runtime_error);
+}
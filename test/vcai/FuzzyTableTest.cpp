@@ -0,0 +1,131 @@
+/*
+ * FuzzyTableTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "fl/Headers.h"
+#include "../AI/VCAI/FuzzyTable.h"
+
+/// Small rule base built the same way as VCAI ones, with hedges and overlapping terms
+class FuzzyTableTest : public ::testing::Test
+{
+protected:
+	fl::Engine engine; //owns variables and rules
+	fl::InputVariable * strength;
+	fl::InputVariable * distance;
+	fl::OutputVariable * value;
+
+	//breakpoints of membership functions
+	const std::vector<std::vector<float>> ticks =
+	{
+		{0, 0.2, 0.5, 0.8, 1},
+		{0, 0.1, 0.5, 0.8, 1.5, 3}
+	};
+
+	FuzzyTableTest()
+	{
+		strength = new fl::InputVariable("strength");
+		strength->addTerm(new fl::Ramp("LOW", 0.5, 0));
+		strength->addTerm(new fl::Triangle("MEDIUM", 0.2, 0.5, 0.8));
+		strength->addTerm(new fl::Ramp("HIGH", 0.5, 1));
+		strength->setRange(0, 1);
+		engine.addInputVariable(strength);
+
+		distance = new fl::InputVariable("distance");
+		distance->addTerm(new fl::Ramp("SMALL", 0.5, 0));
+		distance->addTerm(new fl::Triangle("MEDIUM", 0.1, 0.8, 1.5));
+		distance->addTerm(new fl::Ramp("LONG", 0.5, 3));
+		distance->setRange(0, 3);
+		engine.addInputVariable(distance);
+
+		value = new fl::OutputVariable("value");
+		value->addTerm(new fl::Ramp("LOW", 2.5, 0));
+		value->addTerm(new fl::Triangle("MEDIUM", 2, 2.5, 3));
+		value->addTerm(new fl::Ramp("HIGH", 2.5, 5));
+		value->setRange(0, 5);
+		engine.addOutputVariable(value);
+
+		auto rules = new fl::RuleBlock();
+		engine.addRuleBlock(rules);
+		for(auto rule : {
+			"if strength is LOW then value is HIGH",
+			"if strength is MEDIUM and distance is SMALL then value is MEDIUM",
+			"if strength is MEDIUM and distance is MEDIUM then value is MEDIUM",
+			"if strength is HIGH then value is LOW",
+			"if distance is LONG then value is LOW",
+			"if distance is very SMALL then value is HIGH"})
+		{
+			rules->addRule(fl::Rule::parse(rule, &engine));
+		}
+		engine.configure("Minimum", "Maximum", "Minimum", "AlgebraicSum", "Centroid", "General");
+	}
+
+	float process(float strengthValue, float distanceValue)
+	{
+		strength->setValue(strengthValue);
+		distance->setValue(distanceValue);
+		engine.process();
+		return value->getValue();
+	}
+
+	FuzzyTable makeTable()
+	{
+		return FuzzyTable(ticks, [&](const std::vector<float> & point)
+		{
+			return process(point[0], point[1]);
+		});
+	}
+};
+
+TEST_F(FuzzyTableTest, matchesEngineAtBreakpoints)
+{
+	FuzzyTable table = makeTable();
+	for(float s : ticks[0])
+	{
+		for(float d : ticks[1])
+		{
+			const float point[] = {s, d};
+			EXPECT_NEAR(process(s, d), table.evaluate(point), 1e-4) << "at " << s << ", " << d;
+		}
+	}
+}
+
+TEST_F(FuzzyTableTest, approximatesEngineBetweenBreakpoints)
+{
+	//centroid is not linear in inputs, interpolation error stays within 10% of output range
+	FuzzyTable table = makeTable();
+	for(size_t i = 0; i + 1 < ticks[0].size(); i++)
+	{
+		for(size_t j = 0; j + 1 < ticks[1].size(); j++)
+		{
+			for(float t : {0.25f, 0.5f, 0.75f})
+			{
+				float s = ticks[0][i] + t * (ticks[0][i + 1] - ticks[0][i]);
+				float d = ticks[1][j] + t * (ticks[1][j + 1] - ticks[1][j]);
+				const float point[] = {s, d};
+				EXPECT_NEAR(process(s, d), table.evaluate(point), 0.5) << "at " << s << ", " << d;
+			}
+		}
+	}
+}
+
+TEST_F(FuzzyTableTest, batchMatchesSinglePoints)
+{
+	FuzzyTable table = makeTable();
+	const std::vector<float> points = {0.35, 1.15, 0.9, 0.05, -1, 10, 0.5, 0.8};
+	std::vector<float> outputs(points.size() / 2);
+	table.evaluate(points.data(), outputs.size(), outputs.data());
+
+	for(size_t i = 0; i < outputs.size(); i++)
+		EXPECT_FLOAT_EQ(table.evaluate(&points[i * 2]), outputs[i]);
+
+	//inputs outside of grid are clamped
+	const float corner[] = {0, 3};
+	EXPECT_FLOAT_EQ(table.evaluate(corner), outputs[2]);
+}